@@ -0,0 +1,134 @@
+/**
+ * @brief Governed-zone damage tracking: which pixels of a frame differ from the one before it.
+ *
+ * @compliance ADR-004 Trust zones in C++ (governed zone: std only, no Vulkan, no windowing)
+ * @compliance ADR-005 Error handling and exceptions policy (Result-returning, noexcept)
+ *
+ * Part of MduXCore. A patient monitor redraws a screen whose frames, labels and grid are the same
+ * every frame and whose numeric readouts and waveform strip are not. `DrawList::reset()` and
+ * `UiRenderer::record()` know nothing about that - every frame is rebuilt and every pixel is
+ * shaded again - and on a low-power display controller fill rate is the budget that runs out
+ * first. This module is the governed half of the fix: it compares consecutive frames and says
+ * which rectangles changed, so the adapter can restrict its scissors (and the caller its render
+ * area) to them.
+ *
+ * ## What "changed" means
+ *
+ * Each command is summarised by a `CommandSignature`: a 64-bit FNV-1a hash of the vertices its
+ * indices reach, in index order, plus its clip - and the pixel bounds it can touch. Hashing through
+ * the indices rather than over the raw buffer ranges makes the signature independent of *where*
+ * in the buffers a command's vertices landed, so a readout that grew by one rectangle does not
+ * make every later command look different merely because its vertices moved along. A command
+ * that draws a retained `DrawSegment` uses the hash and bounds the segment took when it was baked,
+ * so an unchanged static layer costs the tracker one comparison, not a pass over its geometry.
+ *
+ * Commands are matched by position: the n-th command of this frame against the n-th of the last.
+ * A command whose signature differs damages both its old and its new bounds - the pixels it
+ * stopped covering have to be repainted too. A command present in only one of the two frames
+ * damages its own bounds. A screen generated from a `.medui` (#15) emits the same command
+ * sequence every frame, so the positional match is the right one; a caller that inserts a command
+ * near the front gets a correct but pessimistic answer, not a wrong one.
+ *
+ * ## The damage list is bounded
+ *
+ * The rectangles are written into a caller-owned span, like everything else in `mdux.draw`. A
+ * damaged area is merged with every rectangle it overlaps or touches, and the result with every
+ * one *it* then touches, so the listed rectangles never overlap: the renderer draws each command
+ * once per rectangle, and an overlap would paint its pixels twice. When a new, disjoint area would
+ * not fit, the whole list collapses into its bounding rectangle. That trades some overdraw for a
+ * ceiling on the number of scissored draws the renderer emits per command, which is the number a
+ * frame budget has to account for.
+ *
+ * ## What the caller still owns
+ *
+ * Damage is relative to the frame passed to the previous `update()`. Restricting rendering to it is
+ * only correct when the target still holds that previous frame - a single retained image, or an
+ * incremental-present surface. A caller rotating through N swapchain images must repaint the union
+ * of the last N damage lists, or call `invalidate()` when it cannot tell. The tracker cannot know
+ * which image the caller is about to draw into, so it does not pretend to.
+ *
+ * Damage says where to repaint, and the renderer repaints every command that reaches it - but a
+ * pixel no command covers any more is only repainted if something draws it. A screen whose first
+ * command is an opaque background has that for free; one that relies on a render-pass clear must
+ * clear the damaged rectangles itself.
+ */
+module;
+
+export module mdux.draw.damage;
+
+import std;
+import mdux.core.result;
+import mdux.core.units;
+import mdux.draw;
+
+export namespace mdux::draw {
+
+/// What one command looked like: enough to tell whether it changed, and where it drew.
+struct CommandSignature {
+    std::uint64_t hash{0};
+    mdux::core::Rect bounds{};  ///< the geometry's pixel bounds, clipped to the command's clip
+
+    constexpr bool operator==(const CommandSignature&) const = default;
+};
+
+/// Summarises `command`, which must be one of `list`'s, as it would be compared across frames.
+/// Bounds are not clamped to a viewport here; the tracker does that against its own.
+[[nodiscard]] CommandSignature signature(const DrawList& list,
+                                         const DrawCommand& command) noexcept;
+
+/**
+ * @brief Compares each frame against the previous one and lists the rectangles that changed.
+ *
+ * Constructed over caller-owned storage: one `CommandSignature` per command the budget allows,
+ * and as many damage rectangles as the caller is prepared to scissor against. Never allocates.
+ * The first frame after `create()` or `invalidate()` is damaged in full.
+ */
+class DamageTracker {
+public:
+    /// Builds a tracker for lists built against `budget`, drawn into `viewport`.
+    ///
+    /// `history` must hold at least `budget.maxCommands` signatures and `rects` at least one
+    /// rectangle; anything less is `StorageTooSmall`, and an empty viewport is `EmptyBudget`.
+    [[nodiscard]] static mdux::core::Result<DamageTracker, DrawError> create(
+        std::span<CommandSignature> history, std::span<mdux::core::Rect> rects,
+        const DrawBudget& budget, mdux::core::Extent2D viewport) noexcept;
+
+    /// Compares `list` against the previous frame, remembers it, and returns the damage.
+    ///
+    /// An empty result means nothing changed and nothing needs to be drawn. A list with more
+    /// commands than the history can hold is damaged in full and forgets the history, rather
+    /// than being compared in part.
+    std::span<const mdux::core::Rect> update(const DrawList& list) noexcept;
+
+    /// Forgets the previous frame, so the next `update()` damages the whole viewport. For a
+    /// target whose contents the caller can no longer vouch for: a resize, a lost surface, a
+    /// swapchain image it has not drawn into recently.
+    void invalidate() noexcept;
+
+    /// The damage the last `update()` returned.
+    [[nodiscard]] std::span<const mdux::core::Rect> damage() const noexcept {
+        return rects_.subspan(0, rectCount_);
+    }
+
+    /// The bounding rectangle of `damage()`, for a render area; zero-sized when nothing changed.
+    [[nodiscard]] mdux::core::Rect bounds() const noexcept;
+
+    [[nodiscard]] mdux::core::Extent2D viewport() const noexcept { return viewport_; }
+
+private:
+    DamageTracker() noexcept = default;
+
+    /// Clamps `area` to the viewport and merges it into the list, collapsing when full.
+    void addDamage(const mdux::core::Rect& area) noexcept;
+
+    std::span<CommandSignature> history_;
+    std::span<mdux::core::Rect> rects_;
+    mdux::core::Extent2D viewport_{};
+    std::uint32_t historyCount_{0};
+    std::uint32_t rectCount_{0};
+    /// False until a frame has been remembered, and again after `invalidate()`. Distinct from
+    /// `historyCount_ == 0`, which is also what an empty frame leaves behind.
+    bool primed_{false};
+};
+
+}  // namespace mdux::draw
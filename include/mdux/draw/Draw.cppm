@@ -81,18 +81,32 @@ static_assert(offsetof(UiVertex, u) == 8, "uv must be at offset 8");
 static_assert(offsetof(UiVertex, color) == 16, "colour must be at offset 16");
 static_assert(offsetof(UiVertex, mode) == 20, "mode must be at offset 20");
 
-/// Indices are 16-bit, which caps a list at 65536 vertices. That is a deliberate ceiling rather
-/// than an oversight: it halves the index buffer, and a governed screen that needs more than
-/// sixteen thousand rectangles in one frame has a budget problem the index width would only hide.
+/// Indices are 16-bit, which caps one batch at 65536 vertices. That is a deliberate ceiling
+/// rather than an oversight: it halves the index buffer, and an ordinary screen never reaches it.
+/// A list budgeted past it - a high-resolution trend display - is split into batches instead:
+/// when a primitive would cross the ceiling, the list starts a new batch at the current vertex
+/// and the command records that vertex as its `vertexOffset`. Indices stay 16-bit throughout.
 using Index = std::uint16_t;
 
 inline constexpr std::uint32_t maxIndexableVertices = 65536;
 
+/// The most vertices a list's budget may claim: what a command's `vertexOffset`, signed 32-bit
+/// in `vkCmdDrawIndexed`, can still reach.
+inline constexpr std::uint32_t maxListVertices = std::numeric_limits<std::int32_t>::max();
+
+class DrawSegment;
+
 /// One recorded draw: a contiguous run of indices, under one clip rectangle.
 struct DrawCommand {
     std::uint32_t firstIndex{0};
     std::uint32_t indexCount{0};
     mdux::core::Rect clip{};
+    /// Non-null when the command draws a retained segment rather than the list's own geometry.
+    /// `firstIndex` and `indexCount` then count into the segment's indices, not the list's.
+    const DrawSegment* segment{nullptr};
+    /// The vertex this command's indices count from: the start of its batch. Always zero below
+    /// 65536 vertices, and for a segment, whose resident offset is the renderer's to supply.
+    std::uint32_t vertexOffset{0};
 
     constexpr bool operator==(const DrawCommand&) const = default;
 };
@@ -113,12 +127,17 @@ struct DrawBudget {
 
 enum class DrawError : std::uint8_t {
     EmptyBudget,             ///< a budget with no room for even one primitive
-    BudgetExceedsIndexWidth, ///< maxVertices > maxIndexableVertices, which a 16-bit index cannot address
+    BudgetExceedsIndexWidth, ///< maxVertices > maxListVertices, or one primitive past one batch
     StorageTooSmall,         ///< the spans supplied are smaller than the budget claims
     VertexBudgetExceeded,
     IndexBudgetExceeded,
     CommandBudgetExceeded,
     DegenerateRect,          ///< zero or negative width or height
+    InvalidSegment,          ///< empty, not whole triangles, or an index past its vertices
+    BatchSizeMismatch,       ///< a batch's per-rectangle spans differ in length from its rects
+    InvalidPolyline,         ///< under two distinct points, a non-finite value, no width, or a
+                             ///< miter limit under 1
+    ShardMismatch,           ///< merged lists are not this list's shards, in order, into it empty
 };
 
 [[nodiscard]] std::string_view describe(DrawError error) noexcept;
@@ -139,6 +158,221 @@ enum class DrawError : std::uint8_t {
     return std::bit_cast<std::uint32_t>(bytes);
 }
 
+/// A 64-bit FNV-1a hash of the vertices `indices` reach, in index order. Where in `vertices`
+/// the geometry sits does not change the hash; what it draws, and in what order, does.
+[[nodiscard]] std::uint64_t contentHash(std::span<const UiVertex> vertices,
+                                        std::span<const Index> indices) noexcept;
+
+/// The pixel rectangle covering every vertex `indices` reach, rounded outwards. Zero-sized when
+/// `indices` is empty.
+[[nodiscard]] mdux::core::Rect geometryBounds(std::span<const UiVertex> vertices,
+                                              std::span<const Index> indices) noexcept;
+
+/// A point in pixels, top-left origin. Floating-point because a trace's samples land between
+/// pixel centres, and rounding them to `Px` before tessellation is what makes a line look stepped.
+struct Point2F {
+    float x{0.0F};
+    float y{0.0F};
+
+    constexpr bool operator==(const Point2F&) const = default;
+};
+
+/// How two consecutive segments of a polyline meet.
+enum class JoinStyle : std::uint8_t {
+    Miter,  ///< extended to a point, falling back to a bevel past `PolylineStyle::miterLimit`
+    Bevel,  ///< cut flat across the outer corner
+};
+
+/// How a polyline is stroked.
+struct PolylineStyle {
+    float width{1.0F};  ///< pixels, centred on the line
+    JoinStyle join{JoinStyle::Miter};
+    /// The longest miter allowed, as a multiple of half the width; the SVG default. A QRS spike
+    /// turns almost back on itself, and an unlimited miter there is a needle far past the peak.
+    /// At least 1, as in SVG: no miter is shorter than half the width.
+    float miterLimit{4.0F};
+
+    constexpr bool operator==(const PolylineStyle&) const = default;
+};
+
+/// What a primitive costs a `DrawList`, so a caller can size a budget or check one first.
+struct PrimitiveCost {
+    std::size_t vertices{0};
+    std::size_t indices{0};
+
+    constexpr bool operator==(const PrimitiveCost&) const = default;
+};
+
+/**
+ * @brief The exact cost `DrawList::addPolyline()` will charge for `points` in `style`.
+ *
+ * Two vertices per distinct point and six indices per segment, plus two vertices and six indices
+ * for every join that bevels - which for `JoinStyle::Miter` depends on the angles, so this walks
+ * the points once to find out. Exact repeats of the previous point are dropped, as the tessellator
+ * drops them. `InvalidPolyline` for fewer than two distinct points, a non-finite coordinate, a
+ * width that is not a positive finite number, or a miter limit under 1.
+ */
+[[nodiscard]] mdux::core::Result<PrimitiveCost, DrawError> polylineCost(
+    std::span<const Point2F> points, const PolylineStyle& style) noexcept;
+
+/// The most any polyline of `pointCount` points can cost, whatever its angles: every join
+/// bevelled. What a budget computed ahead of time - by the `.medui` compiler - has to allow for.
+[[nodiscard]] constexpr PrimitiveCost maxPolylineCost(std::size_t pointCount) noexcept {
+    if (pointCount < 2) {
+        return {};
+    }
+    return PrimitiveCost{.vertices = 4 * pointCount - 4, .indices = 12 * pointCount - 18};
+}
+
+/// The points `tracePoints()` writes for `sampleCount` samples across `columns` pixels: one per
+/// sample while they fit, and at most a minimum and a maximum per column once they do not.
+[[nodiscard]] constexpr std::size_t maxTracePoints(std::size_t sampleCount,
+                                                   mdux::core::Px columns) noexcept {
+    const auto width = static_cast<std::size_t>(std::max(columns, mdux::core::Px{0}));
+    return sampleCount <= width ? sampleCount : 2 * width;
+}
+
+/**
+ * @brief Lays a run of samples across `area` as points for `DrawList::addPolyline()`.
+ *
+ * The first sample lands on the left pixel column's centre and the last on the right's;
+ * `maxValue` on the top row and `minValue` on the bottom, with values outside clamped to the
+ * area. When there are more samples than columns - a 500 Hz ECG in a 300-pixel strip - each
+ * column keeps only its minimum and maximum, in the order they occurred. That is min/max
+ * decimation: every peak survives, which plain subsampling does not promise, and the polyline
+ * costs at most two points per column however high the sample rate.
+ *
+ * `out` must hold `maxTracePoints(samples.size(), area.width)` points (`StorageTooSmall`);
+ * the result is the prefix written. `DegenerateRect` for an empty area and `InvalidPolyline`
+ * unless `minValue < maxValue`.
+ */
+[[nodiscard]] mdux::core::Result<std::span<const Point2F>, DrawError> tracePoints(
+    std::span<const float> samples, const mdux::core::Rect& area, float minValue, float maxValue,
+    std::span<Point2F> out) noexcept;
+
+/// Identifies a retained segment to the renderer that keeps it resident. Chosen by the caller -
+/// typically the `.medui` compiler, numbering a screen's static layers - and dense from zero.
+using SegmentId = std::uint32_t;
+
+/**
+ * @brief Static geometry recorded once and replayed by reference every frame.
+ *
+ * Most of a medical screen - frames, labels, grid lines - is the same every frame, and rebuilding
+ * it costs four vertices and six indices per rectangle per frame, plus the upload. A segment is
+ * that geometry baked: built once (with a `DrawList` over storage of its own, or as generated
+ * `constexpr` data), validated once, hashed once, and thereafter appended to a frame as a single
+ * command that names it. The renderer copies its bytes to the device when the segment is
+ * retained and never again, so per-frame cost scales with what changed rather than with how much
+ * of the screen there is.
+ *
+ * Immutable and non-owning: the spans must outlive every frame that appends the segment, and must
+ * not change - the hash taken at `create()` is what the renderer and the damage tracker rely on
+ * to know it is the same geometry. A segment is drawn under the clip of the list it is appended
+ * to; clips set while building it are not part of it.
+ */
+class DrawSegment {
+public:
+    /// Validates `indices` against `vertices` and takes the segment's hash and bounds.
+    [[nodiscard]] static mdux::core::Result<DrawSegment, DrawError> create(
+        SegmentId id, std::span<const UiVertex> vertices, std::span<const Index> indices) noexcept;
+
+    [[nodiscard]] SegmentId id() const noexcept { return id_; }
+    [[nodiscard]] std::span<const UiVertex> vertices() const noexcept { return vertices_; }
+    [[nodiscard]] std::span<const Index> indices() const noexcept { return indices_; }
+    [[nodiscard]] std::uint64_t hash() const noexcept { return hash_; }
+    [[nodiscard]] const mdux::core::Rect& bounds() const noexcept { return bounds_; }
+
+private:
+    DrawSegment() noexcept = default;
+
+    SegmentId id_{0};
+    std::span<const UiVertex> vertices_;
+    std::span<const Index> indices_;
+    std::uint64_t hash_{0};
+    mdux::core::Rect bounds_{};
+};
+
+/**
+ * @brief What a renderer reserves for retained segments, alongside a list's `DrawBudget`.
+ *
+ * Zero segments - the default - reserves nothing and refuses every segment command.
+ */
+struct SegmentBudget {
+    std::uint32_t maxSegments{0};  ///< ids 0 .. maxSegments-1
+    std::uint32_t maxVertices{0};  ///< summed over every retained segment
+    std::uint32_t maxIndices{0};
+
+    constexpr bool operator==(const SegmentBudget&) const = default;
+};
+
+/// Tiles an `OcclusionGrid` over `viewport` needs at `tileSize`, or 0 for an empty viewport or
+/// a tile size that is not positive.
+[[nodiscard]] constexpr std::size_t occlusionTileCount(mdux::core::Extent2D viewport,
+                                                       mdux::core::Px tileSize) noexcept {
+    if (viewport.width <= 0 || viewport.height <= 0 || tileSize <= 0) {
+        return 0;
+    }
+    const auto columns = static_cast<std::size_t>((viewport.width - 1) / tileSize + 1);
+    const auto rows = static_cast<std::size_t>((viewport.height - 1) / tileSize + 1);
+    return columns * rows;
+}
+
+/**
+ * @brief Caller-owned scratch for `DrawList::cullOccluded()`: one occluder per screen tile.
+ *
+ * Each tile remembers the opaque rectangle covering most of it, so testing whether something is
+ * hidden is one lookup - the tile holding its top-left corner - rather than a scan of every
+ * occluder. That is conservative: a primitive covered only by a rectangle its tile did not keep
+ * is drawn anyway. It is never wrong, because the lookup still proves full coverage.
+ */
+class OcclusionGrid {
+public:
+    /// Builds a grid of `tileSize` tiles over `viewport`, holding one rectangle per tile in
+    /// `tiles`, which must have room for `occlusionTileCount()` of them.
+    [[nodiscard]] static mdux::core::Result<OcclusionGrid, DrawError> create(
+        std::span<mdux::core::Rect> tiles, mdux::core::Extent2D viewport,
+        mdux::core::Px tileSize) noexcept;
+
+    [[nodiscard]] mdux::core::Extent2D viewport() const noexcept { return viewport_; }
+    [[nodiscard]] mdux::core::Px tileSize() const noexcept { return tileSize_; }
+
+private:
+    friend class DrawList;
+
+    OcclusionGrid() noexcept = default;
+
+    void clear() noexcept;
+    /// Offers `occluder` to every tile it touches; a tile keeps whichever covers more of it.
+    void insert(const mdux::core::Rect& occluder) noexcept;
+    /// Whether the occluder kept by `area`'s top-left tile contains all of `area`.
+    [[nodiscard]] bool covers(const mdux::core::Rect& area) const noexcept;
+    [[nodiscard]] std::size_t tileAt(mdux::core::Px x, mdux::core::Px y) const noexcept;
+
+    std::span<mdux::core::Rect> tiles_;
+    mdux::core::Extent2D viewport_{};
+    mdux::core::Px tileSize_{0};
+    mdux::core::Px columns_{0};
+    mdux::core::Px rows_{0};
+};
+
+/**
+ * @brief What `DrawList::diff()` found: the commands between the longest run two lists share
+ *        from the front and the longest they share from the back.
+ *
+ * Commands are compared by what they draw - clip, segment, and the vertices their indices reach -
+ * not by where either list stored them. Identical lists report two empty ranges.
+ */
+struct DrawDiff {
+    std::uint32_t first{0};       ///< the first command that differs, in both lists
+    std::uint32_t count{0};       ///< how many of this list's commands from `first` differ
+    std::uint32_t otherCount{0};  ///< how many of the other list's commands from `first` differ
+
+    [[nodiscard]] constexpr bool identical() const noexcept {
+        return count == 0 && otherCount == 0;
+    }
+    constexpr bool operator==(const DrawDiff&) const = default;
+};
+
 /**
  * @brief A bounded, non-allocating description of one frame.
  *
@@ -170,9 +404,108 @@ public:
     [[nodiscard]] mdux::core::ResultVoid<DrawError> addSolidRect(
         const mdux::core::Rect& rect, mdux::core::ColorRgba8 color) noexcept;
 
+    /**
+     * @brief Records every rectangle in `rects` untextured, as one all-or-nothing batch.
+     *
+     * `colors` holds one colour per rectangle, or a single colour for all of them. The batch is
+     * checked once - every rectangle for degeneracy, the budget for the whole of it - and then
+     * written in one pass, so a run of waveform bars costs one call rather than one per bar. An
+     * empty batch records nothing and succeeds; a refused one records nothing at all.
+     */
+    [[nodiscard]] mdux::core::ResultVoid<DrawError> addSolidRects(
+        std::span<const mdux::core::Rect> rects,
+        std::span<const mdux::core::ColorRgba8> colors) noexcept;
+
+    /// As `addSolidRects()`, in `mode`, with `uvs` holding each rectangle's atlas rectangle - a
+    /// glyph run, typically, with one colour for the run.
+    [[nodiscard]] mdux::core::ResultVoid<DrawError> addRects(
+        std::span<const mdux::core::Rect> rects, std::span<const mdux::core::Rect> uvs,
+        std::span<const mdux::core::ColorRgba8> colors, DrawMode mode) noexcept;
+
+    /**
+     * @brief Records a constant-width line through `points`, untextured, in `color`.
+     *
+     * Tessellated here into quads - one per segment, sharing a miter pair of vertices at each
+     * join or bridged by a bevel quad - and charged exactly `polylineCost()`, which is checked
+     * against the budget before anything is written. A trace drawn this way costs two vertices
+     * per point rather than four per one-pixel rectangle, which is what keeps a full-width
+     * waveform inside the 16-bit index range. Overlapping triangles at sharp joins blend twice
+     * under a translucent colour; a trace is drawn opaque.
+     */
+    [[nodiscard]] mdux::core::ResultVoid<DrawError> addPolyline(
+        std::span<const Point2F> points, const PolylineStyle& style,
+        mdux::core::ColorRgba8 color) noexcept;
+
+    /// Appends `segment` as one command under the current clip. Costs one command and nothing
+    /// from the vertex or index budget: the geometry is the segment's, already on the device.
+    [[nodiscard]] mdux::core::ResultVoid<DrawError> addSegment(
+        const DrawSegment& segment) noexcept;
+
     /// Sets the clip rectangle applied to subsequent primitives. A change starts a new command.
     void setClip(const mdux::core::Rect& clip) noexcept;
 
+    /**
+     * @brief Regroups commands by clip wherever painter's order proves the move invisible.
+     *
+     * Two panels updated alternately record a command - and a scissor change - per primitive,
+     * because only a clip unchanged since the previous primitive extends a command. This pass
+     * moves each command back to join the nearest earlier one under the same clip, provided its
+     * painted area (geometry bounds within its clip) overlaps none of the commands it would jump;
+     * pixels drawn by only one of two commands do not depend on which was drawn first. Otherwise
+     * it stays where it is. Segment commands are never merged, but they are jumped, by the same
+     * rule, when they do not overlap.
+     *
+     * Vertices do not move; the list's indices are rotated in place, so nothing is allocated and
+     * no scratch is needed. Quadratic in the command count, so it belongs after the frame is
+     * built, once, not after every primitive. Optional: a list that is never compacted draws the
+     * same pixels. Returns how many commands it removed.
+     */
+    std::uint32_t compact() noexcept;
+
+    /**
+     * @brief Drops every triangle that later opaque rectangles, or its own clip, hide entirely.
+     *
+     * Walks the finished list backwards, so everything in `grid` when a triangle is tested is
+     * drawn after it. An occluder is a rectangle exactly as `addRect()` writes it, in
+     * `DrawMode::Solid` with alpha 255, on whole pixels, cut to its command's clip: under the
+     * renderer's source-over blend it replaces every pixel it covers, so whatever it covers
+     * completely cannot show. A triangle whose clip leaves nothing of it is dropped too.
+     * Segment commands are neither tested nor used as occluders.
+     *
+     * Only indices are removed, in place, and commands left with none are removed with them;
+     * vertices stay where they are, so the indices that remain still name the same ones. The
+     * output draws the same pixels. Returns how many triangles it dropped.
+     */
+    std::uint32_t cullOccluded(OcclusionGrid& grid) noexcept;
+
+    /**
+     * @brief A list over shard `which` of this list's storage, for one panel built on one thread.
+     *
+     * Shard `which` starts where shards `0 .. which-1` of `budgets` end, so every thread can carve
+     * its own from the same `budgets` without coordinating, and the slices never overlap. Their
+     * sum must fit this list's budget. This list must stay empty, and untouched, until `merge()`.
+     */
+    [[nodiscard]] mdux::core::Result<DrawList, DrawError> shard(
+        std::span<const DrawBudget> budgets, std::size_t which) const noexcept;
+
+    /**
+     * @brief Concatenates `shards` into this empty list, in the order given.
+     *
+     * Each shard's geometry is moved down to close the gap after the previous one's, its indices
+     * rebased by the vertices before it and its commands by the indices before it. A shard that
+     * would cross a 16-bit batch starts one of its own instead, its indices left as they are. A
+     * shard whose first command continues the previous shard's last - same clip and batch,
+     * neither a segment - extends it, as `addRect()` would have. The result is a function of the
+     * shards' contents and their order alone, so it is byte-identical whichever thread finished
+     * first, and identical to building the panels one after another on one thread.
+     *
+     * Every shard is checked to be this list's, where `shard()` put it, in order, before anything
+     * moves; otherwise the merge is refused with `ShardMismatch` and nothing changes. Afterwards
+     * the shards' storage belongs to this list again and they must not be used.
+     */
+    [[nodiscard]] mdux::core::ResultVoid<DrawError> merge(
+        std::span<const DrawList> shards) noexcept;
+
     /// Empties the list without touching the storage or the budget.
     void reset() noexcept;
 
@@ -186,11 +519,58 @@ public:
         return commands_.subspan(0, commandCount_);
     }
     [[nodiscard]] const DrawBudget& budget() const noexcept { return budget_; }
-    [[nodiscard]] bool empty() const noexcept { return indexCount_ == 0; }
+
+    /**
+     * @brief A 64-bit hash of the list's vertices, indices and commands, as they stand.
+     *
+     * Kept current as primitives are added - each `add*` folds in what it wrote while it is
+     * still in cache - so asking costs a few multiplies, not a pass over the frame. Lists with
+     * byte-identical buffers hash equal wherever their storage is, which is what lets a renderer
+     * skip re-uploading an unchanged frame and a capture deduplicate identical ones. The passes
+     * that rewrite a list (`compact()`, `cullOccluded()`, `merge()`) recompute it.
+     */
+    [[nodiscard]] std::uint64_t hash() const noexcept;
+
+    /// The commands this list and `other` do not share. Exact, not hashed: it compares what each
+    /// command draws, so it is linear in the shared commands' indices.
+    [[nodiscard]] DrawDiff diff(const DrawList& other) const noexcept;
+
+    /// No commands. Not "no indices": a frame of nothing but retained segments has none of its
+    /// own and still draws.
+    [[nodiscard]] bool empty() const noexcept { return commandCount_ == 0; }
 
 private:
     DrawList() noexcept = default;
 
+    /// The one writer behind every rectangle `add*`. `uvs` is empty or one per rectangle, and
+    /// `colors` one or one per rectangle; the public entry points have checked which.
+    [[nodiscard]] mdux::core::ResultVoid<DrawError> appendRects(
+        std::span<const mdux::core::Rect> rects, std::span<const mdux::core::Rect> uvs,
+        std::span<const mdux::core::ColorRgba8> colors, DrawMode mode) noexcept;
+
+    /// Whether the next primitive needs a command of its own: nothing recorded yet, a clip
+    /// changed since the current command started, a current command that draws a segment, or
+    /// one in an earlier batch.
+    [[nodiscard]] bool needsCommand() const noexcept;
+
+    /// Whether a primitive of `vertices` vertices would cross the current batch's 16-bit ceiling,
+    /// and so must start a new batch - and with it a new command.
+    [[nodiscard]] bool crossesBatch(std::size_t vertices) const noexcept;
+
+    /// Charges `indexCount` indices, starting at the current index count, to a new command when
+    /// `startCommand` and to the current one otherwise. The caller has checked the budget.
+    void chargeCommand(bool startCommand, std::uint32_t indexCount) noexcept;
+
+    /// Folds the `vertices` vertices and `indices` indices about to be appended - written, but not
+    /// yet counted - into the running hashes.
+    void hashAppended(std::uint32_t vertices, std::uint32_t indices) noexcept;
+
+    /// Recomputes the running hashes from the buffers, after a pass that rewrote them.
+    void rehash() noexcept;
+
+    /// What command `at` can change on screen: its geometry's bounds, within its clip.
+    [[nodiscard]] mdux::core::Rect paintedArea(std::uint32_t at) const noexcept;
+
     std::span<UiVertex> vertices_;
     std::span<Index> indices_;
     std::span<DrawCommand> commands_;
@@ -198,6 +578,14 @@ private:
     std::uint32_t vertexCount_{0};
     std::uint32_t indexCount_{0};
     std::uint32_t commandCount_{0};
+    /// The first vertex of the current batch, which new indices count from.
+    std::uint32_t batchBase_{0};
+    /// Running FNV-1a hashes of the three buffers, each only ever appended to. A command is
+    /// folded in when it starts, without its index count, which grows after; `hash()` recovers
+    /// that from the counts.
+    std::uint64_t vertexHash_{0};
+    std::uint64_t indexHash_{0};
+    std::uint64_t commandHash_{0};
     /// The clip every subsequent primitive is recorded under. A default-constructed Rect means
     /// "no clip", which is also what `reset()` restores - so no separate "is one set?" flag is
     /// needed, and one did exist here without ever being read.
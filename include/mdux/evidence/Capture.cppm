@@ -0,0 +1,127 @@
+/**
+ * @file Capture.cppm
+ * @brief Governed-zone lossless frame encoding: captured frames, small enough to keep.
+ *
+ * @compliance ADR-004 Trust zones in C++ (governed zone: std only, no Vulkan, no windowing)
+ * @compliance ADR-005 Error handling and exceptions policy (Result-returning, noexcept)
+ * @compliance ADR-007 Evidence pipeline doctrine
+ *
+ * Part of MduXCore. A frame read back from `mdux.render.offscreen` is `width * height` raw
+ * `ColorRgba8` - about 8 MB at 1080p - and a recorded session is thousands of them. This encodes
+ * one frame into a byte stream an auditor can decode back to exactly those pixels, and nothing
+ * else: lossless, because a capture that alters what was shown is not evidence of it.
+ *
+ * ## The scheme
+ *
+ * Each pixel is first reduced to a *residual*: itself in a key frame, or its per-channel
+ * difference from the same pixel of the previous frame (mod 256) in a delta frame. A UI frame is
+ * mostly what the last one was, so a delta frame's residuals are mostly zero. The residuals are
+ * then written with the operations of QOI ("Quite OK Image", Szablewski, 2021): a run of the
+ * previous residual, an index into the 64 most recently hashed, a small difference from the
+ * previous, or the residual itself. Chosen over a general-purpose compressor because it is one
+ * linear pass with no tables beyond 256 bytes, its specification fits on a page, and UI pixels -
+ * flat fills, repeated colours, short gradients - are what its operations are for.
+ *
+ * ## Byte-identical everywhere
+ *
+ * Every value the stream depends on is integer arithmetic on bytes, fixed by this file: the hash,
+ * the wrap-around differences, the little-endian header. No floating point, no platform-sized
+ * type, no iteration order that a standard library chooses. The same pixels encode to the same
+ * bytes on every toolchain, so a capture's SHA-256 (`mdux.evidence.digest`) identifies it.
+ *
+ * ## Storage
+ *
+ * Nothing here allocates. The caller provides `maxEncodedFrameBytes()` of output, the worst case
+ * of five bytes a pixel, so encoding cannot fail midway; the span returned is what was used.
+ *
+ * A frame begins with a 16-byte header:
+ *
+ * | Bytes | Field                                        |
+ * |-------|----------------------------------------------|
+ * | 0-3   | `MDXF`                                       |
+ * | 4     | format version, 1                            |
+ * | 5     | flags: bit 0 set for a delta frame           |
+ * | 6-7   | zero                                         |
+ * | 8-11  | width, unsigned 32-bit little-endian         |
+ * | 12-15 | height, unsigned 32-bit little-endian        |
+ */
+module;
+
+export module mdux.evidence.capture;
+
+import std;
+import mdux.core.result;
+import mdux.core.units;
+
+export namespace mdux::evidence {
+
+enum class CaptureError : std::uint8_t {
+    EmptyExtent,
+    ExtentTooLarge,          ///< the worst-case encoding would not fit std::size_t
+    PixelCountMismatch,      ///< the pixel span is not width * height long
+    PreviousFrameMismatch,   ///< the previous frame is not width * height long
+    MissingPreviousFrame,    ///< a delta frame decoded without the frame it is a delta from
+    StorageTooSmall,
+    NotAFrame,               ///< no `MDXF` tag, or a reserved byte or flag that is not zero
+    UnsupportedVersion,
+    TruncatedFrame,          ///< the stream ends before every pixel is decoded
+    TrailingBytes,           ///< the stream goes on after every pixel is decoded
+};
+
+[[nodiscard]] std::string_view describe(CaptureError error) noexcept;
+
+/// The size of a frame's header, before its first operation.
+inline constexpr std::size_t frameHeaderBytes = 16;
+
+/// What a frame's header says about it.
+struct FrameInfo {
+    mdux::core::Extent2D extent{};
+    bool delta{false};  ///< decodes only against the frame before it
+};
+
+/// The most bytes a frame of `extent` can encode to: its header, then five bytes a pixel. Zero
+/// for an empty extent, or one whose worst case would not fit `std::size_t`.
+[[nodiscard]] constexpr std::size_t maxEncodedFrameBytes(mdux::core::Extent2D extent) noexcept {
+    if (extent.width <= 0 || extent.height <= 0) {
+        return 0;
+    }
+    const std::uint64_t pixels =
+        std::uint64_t{static_cast<std::uint32_t>(extent.width)} *
+        static_cast<std::uint32_t>(extent.height);
+    if (pixels > (std::numeric_limits<std::size_t>::max() - frameHeaderBytes) / 5) {
+        return 0;
+    }
+    return frameHeaderBytes + static_cast<std::size_t>(pixels) * 5;
+}
+
+/**
+ * @brief Encodes `pixels`, row-major and tightly packed, into `out`.
+ *
+ * An empty `previous` makes a key frame, which decodes on its own; otherwise the frame is a delta
+ * from `previous`, which must be the same size and is needed again to decode it. A recording
+ * starts with a key frame and should take another now and then, so that one lost frame does not
+ * lose every frame after it.
+ *
+ * `out` must hold `maxEncodedFrameBytes(extent)`, however little the frame turns out to need.
+ * The returned span is the front of `out` the frame was written to.
+ */
+[[nodiscard]] mdux::core::Result<std::span<const std::byte>, CaptureError> encodeFrame(
+    mdux::core::Extent2D extent, std::span<const mdux::core::ColorRgba8> pixels,
+    std::span<const mdux::core::ColorRgba8> previous, std::span<std::byte> out) noexcept;
+
+/// The header of an encoded frame, checked, so a decoder can size its output before decoding.
+[[nodiscard]] mdux::core::Result<FrameInfo, CaptureError> readFrameInfo(
+    std::span<const std::byte> encoded) noexcept;
+
+/**
+ * @brief Decodes `encoded` into `out`, which must be exactly width * height long.
+ *
+ * A delta frame also needs `previous`, the frame it was encoded against; a key frame ignores it.
+ * `out` may be the same storage as `previous`, so a player can decode a recording in place. The
+ * whole stream is consumed: bytes left over after the last pixel are an error, not ignored.
+ */
+[[nodiscard]] mdux::core::ResultVoid<CaptureError> decodeFrame(
+    std::span<const std::byte> encoded, std::span<const mdux::core::ColorRgba8> previous,
+    std::span<mdux::core::ColorRgba8> out) noexcept;
+
+}  // namespace mdux::evidence
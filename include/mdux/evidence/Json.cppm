@@ -205,4 +205,147 @@ struct Member {
  */
 [[nodiscard]] mdux::core::Result<Value, Error> parse(std::string_view text) noexcept;
 
+/**
+ * @brief How the reader gets through runs of ordinary bytes.
+ *
+ * UTF-8 validation and string bodies are where a multi-megabyte artifact spends its parse time,
+ * and nearly every byte in both is plain ASCII that needs no decision. `Wide` tests eight bytes
+ * per step and drops to the byte loop only where something needs deciding; `Reference` is that
+ * byte loop alone.
+ *
+ * `Reference` is kept as the specification rather than as a fallback. Both scanners feed the
+ * same grammar and must produce the same Value or the same Error - code *and* offset - for
+ * every input, and the tests hold them to it by parsing the same corpus, and mutations of it,
+ * both ways. A speed-up that changed what verification accepts would be a regression in the
+ * one property this reader exists for.
+ */
+enum class Scanner : std::uint8_t {
+    Wide,       ///< word-at-a-time scanning; what parse(text) uses
+    Reference,  ///< byte-at-a-time; the behaviour `Wide` is checked against
+};
+
+/// parse(), with the byte scanner chosen explicitly. For differential testing; production code
+/// calls parse(text).
+[[nodiscard]] mdux::core::Result<Value, Error> parse(std::string_view text,
+                                                     Scanner scanner) noexcept;
+
+/**
+ * @brief A value in validated text, decoded only when something asks for it.
+ *
+ * Verification mostly needs a handful of top-level fields from a package whose bulk - golden
+ * vectors, glyph tables - it either compares as bytes or never looks at. Building a `Value` for
+ * all of it costs an allocation per number for data nobody reads. A LazyValue is a view of the
+ * bytes one value occupies: find() and elements() walk the text to the member or element asked
+ * for, and materialise() decodes just that subtree into an ordinary `Value`.
+ *
+ * ## Strictness is not deferred
+ *
+ * parseLazy() runs the same grammar as parse() over the whole input before returning - every
+ * check, including duplicate keys at every depth - and only skips building the tree. So it
+ * rejects exactly what parse() rejects, with the same code at the same offset, and a LazyValue
+ * only ever exists over text that has already passed. That is the property that lets the
+ * navigation below assume well-formed input, and the reason there is no way to construct one
+ * over text that has not been through parseLazy().
+ *
+ * Borrows the text it was parsed from, which must outlive it. Trivially copyable and cheap to
+ * pass by value.
+ */
+class LazyElements;
+
+class LazyValue {
+public:
+    /// The kind the decoded value would have. Decided from the first byte, so free.
+    [[nodiscard]] Value::Kind kind() const noexcept;
+
+    /// Exactly the bytes of this value, without surrounding whitespace.
+    [[nodiscard]] std::string_view text() const noexcept { return text_; }
+
+    /// The member named `key`, or nullopt if absent or if this is not an Object. Walks the
+    /// object's members in text order, skipping each value without decoding it.
+    [[nodiscard]] std::optional<LazyValue> find(std::string_view key) const noexcept;
+
+    /// find() with a MissingMember error instead of nullopt, for chained access.
+    [[nodiscard]] mdux::core::Result<LazyValue, Error> require(std::string_view key) const noexcept;
+
+    /// Elements of an Array, each undecoded, found as the walk reaches them rather than collected
+    /// first - so nothing is allocated and nothing can fail. Empty for any other kind.
+    [[nodiscard]] LazyElements elements() const noexcept;
+
+    /// Decodes this value and everything beneath it into a `Value`, equal to the corresponding
+    /// subtree of parse() over the same text.
+    [[nodiscard]] mdux::core::Result<Value, Error> materialise() const noexcept;
+
+private:
+    friend mdux::core::Result<LazyValue, Error> parseLazy(std::string_view text) noexcept;
+    friend class LazyElements;
+
+    explicit LazyValue(std::string_view text) noexcept : text_{text} {}
+
+    std::string_view text_;
+};
+
+/**
+ * @brief The elements of an Array LazyValue, as a forward range over its text.
+ *
+ * An iterator is the array's text and two offsets: advancing it skips one element's bytes the way
+ * find() skips a member's, and dereferencing it makes the LazyValue for those bytes. Borrows the
+ * same text as the LazyValue it came from.
+ */
+class LazyElements {
+public:
+    class Iterator {
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using value_type = LazyValue;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() noexcept = default;
+
+        [[nodiscard]] LazyValue operator*() const noexcept;
+        Iterator& operator++() noexcept;
+        Iterator operator++(int) noexcept {
+            Iterator before = *this;
+            ++*this;
+            return before;
+        }
+        /// Iterators of the same range only, as for any standard container.
+        [[nodiscard]] bool operator==(const Iterator& other) const noexcept {
+            return begin_ == other.begin_;
+        }
+
+    private:
+        friend class LazyElements;
+
+        Iterator(std::string_view array, std::size_t begin) noexcept;
+
+        std::string_view array_;
+        std::size_t begin_{0};  ///< the element's first byte, or the closing bracket at the end
+        std::size_t end_{0};    ///< one past the element's last byte
+    };
+
+    [[nodiscard]] Iterator begin() const noexcept;
+    [[nodiscard]] Iterator end() const noexcept;
+    [[nodiscard]] bool empty() const noexcept { return begin() == end(); }
+
+private:
+    friend class LazyValue;
+
+    explicit LazyElements(std::string_view array) noexcept : array_{array} {}
+
+    /// LazyValue's constructor is private to the types that only ever hand it validated text.
+    [[nodiscard]] static LazyValue element(std::string_view text) noexcept {
+        return LazyValue{text};
+    }
+
+    std::string_view array_;  ///< the whole Array, brackets included; empty for any other kind
+};
+
+/**
+ * @brief Validates `text` exactly as parse() does and returns its top-level value undecoded.
+ *
+ * Same rules, same errors, same offsets as parse(); see LazyValue for what is deferred and what
+ * is not.
+ */
+[[nodiscard]] mdux::core::Result<LazyValue, Error> parseLazy(std::string_view text) noexcept;
+
 }  // namespace mdux::evidence::json
@@ -24,6 +24,15 @@
  * the ownership question out of the test harness, where a leak would be attributed to whichever
  * test happened to run last.
  *
+ * ## Capturing without stalling
+ *
+ * `renderAndRead()` waits for its frame, which is right for a test. A capture path feeding an
+ * audit log or a remote display cannot afford that on the UI thread, so `submit()` records and
+ * submits a frame into one of the target's readback slots and returns a `ReadbackHandle` at once;
+ * `ready()` polls it and `wait()` returns its pixels. With two slots, frame N is copied back while
+ * frame N+1 renders. The colour image is shared: the render pass waits for the previous frame's
+ * copy out of it before clearing it again, so only the readback buffers are multiplied.
+ *
  * ## Format
  *
  * `VK_FORMAT_R8G8B8A8_UNORM`, so a readback row maps onto `mdux::core::ColorRgba8` with no
@@ -63,16 +72,29 @@ enum class OffscreenError : std::uint8_t {
     EndCommandBufferFailed,
     SubmitFailed,
     WaitFailed,
+    FenceCreationFailed,
+    ReadbackSlotsOutOfRange,  ///< zero slots, or more than maxReadbackSlots
+    ReadbackSlotBusy,         ///< the next slot's frame has not finished on the GPU
+    ReadbackNotReady,         ///< wait() timed out before the frame finished
+    ReadbackExpired,          ///< the handle's slot has since been given to a later frame
 };
 
 [[nodiscard]] std::string_view describe(OffscreenError error) noexcept;
 
-/// Records draw commands into a command buffer that is already inside the render pass.
+/// Records draw commands into a command buffer that is already inside the render pass - or,
+/// passed as `renderAndRead()`'s `prepare`, into one that has not begun it yet.
 ///
 /// A plain function pointer with a context, rather than `std::function`: this is called on a path
 /// that must not allocate, and the harness that supplies it always has a stable context object.
 using RecordCommands = void (*)(VkCommandBuffer commandBuffer, void* context);
 
+/// A submitted frame, to poll or wait on. Valid until its slot is submitted into again; after
+/// that every use of it is refused with `ReadbackExpired`, never answered with a later frame.
+struct ReadbackHandle {
+    std::uint32_t slot{0};
+    std::uint64_t sequence{0};
+};
+
 /**
  * @brief A fixed-size offscreen colour target and its readback path.
  *
@@ -86,9 +108,15 @@ public:
     /// multi-gigabyte allocation on a device.
     static constexpr std::uint64_t maxPixels = 1u << 22;  // 4 Mpx, e.g. 2048x2048
 
+    /// The most frames a target can have in flight at once. Each costs a full-size readback
+    /// buffer; beyond a few, the GPU is the bottleneck and more slots only hold more memory.
+    static constexpr std::uint32_t maxReadbackSlots = 4;
+
+    /// `readbackSlots` is how many frames `submit()` can have in flight: one, the default, is all
+    /// `renderAndRead()` needs.
     [[nodiscard]] static mdux::core::Result<OffscreenTarget, OffscreenError> create(
         VkDevice device, VkPhysicalDevice physicalDevice, mdux::core::Extent2D extent,
-        std::uint32_t queueFamilyIndex) noexcept;
+        std::uint32_t queueFamilyIndex, std::uint32_t readbackSlots = 1) noexcept;
 
     ~OffscreenTarget();
 
@@ -104,18 +132,46 @@ public:
     /**
      * @brief Clears to `clear`, runs `record` inside the render pass, and reads the result back.
      *
-     * Submits, waits for the queue to idle, and copies the image to host memory. Synchronous by
-     * design: a test that had to poll a fence would be a test that can hang, and there is no
-     * frame rate to keep up with here.
+     * `submit()` then `wait()`, with no timeout. Synchronous by design: a test that had to poll
+     * a fence would be a test that can hang, and there is no frame rate to keep up with here.
+     *
+     * `prepare`, when given, runs with the same context before the render pass begins, for the
+     * transfers a pass may not contain - `UiRenderer::stage()` is the one it exists for.
+     * `contents` is how the render pass is begun: with
+     * `VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS`, `record` may only execute secondaries.
      *
      * The returned span is owned by this object and stays valid until the next call or until the
      * object is destroyed. Rows are tightly packed, `extent.width` pixels each.
      */
     [[nodiscard]] mdux::core::Result<std::span<const mdux::core::ColorRgba8>, OffscreenError>
     renderAndRead(VkQueue queue, mdux::core::ColorRgba8 clear, RecordCommands record,
-                  void* context) noexcept;
+                  void* context, RecordCommands prepare = nullptr,
+                  VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE) noexcept;
+
+    /**
+     * @brief As `renderAndRead()`, but returns once the frame is submitted.
+     *
+     * The frame goes into the slot after the last one submitted. That slot's previous frame must
+     * have finished, or the call is refused with `ReadbackSlotBusy` before anything is recorded -
+     * never waited for, since not blocking is the point. Its pixels, read or not, are gone once
+     * the slot is reused, and its handle is expired.
+     */
+    [[nodiscard]] mdux::core::Result<ReadbackHandle, OffscreenError> submit(
+        VkQueue queue, mdux::core::ColorRgba8 clear, RecordCommands record, void* context,
+        RecordCommands prepare = nullptr,
+        VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE) noexcept;
+
+    /// Whether the frame has finished and `wait()` would return without blocking.
+    [[nodiscard]] mdux::core::Result<bool, OffscreenError> ready(
+        const ReadbackHandle& handle) const noexcept;
+
+    /// The frame's pixels, once it has finished or `timeout` nanoseconds have passed. They stay
+    /// valid until the slot is submitted into again, and become what `pixelAt()` reads.
+    [[nodiscard]] mdux::core::Result<std::span<const mdux::core::ColorRgba8>, OffscreenError>
+    wait(const ReadbackHandle& handle,
+         std::uint64_t timeout = std::numeric_limits<std::uint64_t>::max()) noexcept;
 
-    /// The pixel at (x, y) from the last `renderAndRead`, or nullopt when out of bounds.
+    /// The pixel at (x, y) from the last frame read back, or nullopt when out of bounds.
     ///
     /// Bounds-checked and returning an optional rather than indexing: an out-of-range read in a
     /// pixel test is a mistake in the expectation, and it should say so rather than compare
@@ -132,9 +188,25 @@ public:
                                                                 mdux::core::Px y) const noexcept;
 
 private:
+    /// One frame in flight: its own command buffer, since a pending one cannot be re-recorded,
+    /// its fence, and which submission it last held.
+    struct ReadbackSlot {
+        VkCommandBuffer commandBuffer{VK_NULL_HANDLE};
+        VkFence fence{VK_NULL_HANDLE};
+        std::uint64_t sequence{0};
+        bool pending{false};  ///< submitted and its fence not yet seen signalled
+    };
+
     OffscreenTarget() noexcept = default;
     void destroy() noexcept;
 
+    /// Whether `handle` names the frame its slot still holds.
+    [[nodiscard]] bool current(const ReadbackHandle& handle) const noexcept;
+
+    /// The slot's pixels in the mapped readback buffer.
+    [[nodiscard]] std::span<const mdux::core::ColorRgba8> slotPixels(
+        std::uint32_t slot) const noexcept;
+
     VkDevice device_{VK_NULL_HANDLE};
     VkImage image_{VK_NULL_HANDLE};
     VkDeviceMemory imageMemory_{VK_NULL_HANDLE};
@@ -145,7 +217,10 @@ private:
     VkDeviceMemory readbackMemory_{VK_NULL_HANDLE};
     void* readbackMapped_{nullptr};
     VkCommandPool commandPool_{VK_NULL_HANDLE};
-    VkCommandBuffer commandBuffer_{VK_NULL_HANDLE};
+    std::vector<ReadbackSlot> slots_;  ///< sized at create(), never after
+    std::uint32_t nextSlot_{0};
+    std::uint64_t submitted_{0};  ///< submissions so far; a handle's sequence is its own
+    std::uint32_t readSlot_{0};   ///< the slot pixelAt() reads: the last one waited on
     mdux::core::Extent2D extent_{};
 };
 
@@ -39,9 +39,61 @@
  * atlas is the correct neutral value rather than a stand-in for a real one. #14 and #17 replace
  * the *contents* when they have glyphs and images to put there; the mechanism stays.
  *
- * This is why the context carries a queue: uploading one white pixel needs a layout transition,
- * and a layout transition needs a submitted command. It is used once, during `create()`, and
- * never touched per frame.
+ * This is why the context carries a queue: clearing the atlas to white needs a layout
+ * transition, and a layout transition needs a submitted command. It is used once, during
+ * `create()`, and never touched per frame.
+ *
+ * Given an `AtlasBudget`, the atlas is that size and `updateAtlas()` overwrites rectangles of it
+ * in place - R8 glyph coverage or RGBA image texels - through a mapped staging ring, one share per
+ * frame slot, with the copies recorded into the caller's command buffer. Nothing waits for the
+ * queue: an update lands in the frame it was recorded with, like the geometry does.
+ *
+ * ## Geometry in device-local memory, where the device has a bus to cross
+ *
+ * On a discrete GPU, host-visible memory sits on the far side of the bus, and every draw reads its
+ * vertices across it. There `create()` puts the vertex and index buffers in device-local memory
+ * and keeps a host-visible mirror of each as a staging ring: `stage()`, recorded outside the
+ * render pass, writes only the bytes of a frame that differ from what its region last held and
+ * copies just that range with `vkCmdCopyBuffer`. Where the device's main device-local heap is also
+ * host-visible - an integrated GPU, or a discrete one with resizable BAR - mapping it directly is
+ * already the cheap path, and the buffers stay mapped in that memory. A 256 MiB BAR window alone
+ * does not count: it is too scarce to spend on geometry. `GeometryMemory` overrides the choice.
+ *
+ * ## A pipeline cache the device keeps between boots
+ *
+ * Given a `VkPipelineCache` in the context, the pipeline is created through it, and
+ * `writePipelineCache()` serialises it behind a header naming the shader bytes it was built from.
+ * A device that writes that blob to storage after its first boot and passes it back through
+ * `pipelineCacheInitialData()` on the next skips the SPIR-V compile that otherwise dominates
+ * boot-to-first-frame. The cache belongs to the caller, as the device does: on Vulkan SC it is
+ * the one created from the offline-compiled pipeline cache, and the renderer neither knows nor
+ * cares which it was handed.
+ *
+ * ## GPU time, measured where the frame is drawn
+ *
+ * Given a `TimestampBudget`, the renderer owns one timestamp query pool with a share per frame
+ * slot, and `record()` writes a timestamp before the frame and after each of its commands. Once
+ * the slot's fence has signalled, `timings()` resolves them into the frame's GPU time and each
+ * command's - the GPU half of a frame-time breakdown whose CPU half is the caller's own clock
+ * around building the `DrawList`. No query is allocated per frame and no result is waited for.
+ *
+ * ## Static layers recorded once
+ *
+ * A screen's retained segments are already uploaded once; given a `LayerBudget`, the commands
+ * that draw them can be recorded once too. `recordLayer()` records a `DrawList` of segments into a
+ * secondary command buffer the renderer owns, and `executeLayers()` replays it into each frame
+ * with `vkCmdExecuteCommands`, so the unchanging bulk of a screen costs no CPU recording per
+ * frame. A subpass that executes secondaries may contain nothing else, so the frame's dynamic
+ * geometry is recorded with `record()` into a secondary of the caller's, begun with
+ * `layerInheritance()`.
+ *
+ * ## Several views from one renderer
+ *
+ * Given a `ViewBudget`, each frame slot holds a region per view, and `record()` of a span of
+ * `RenderView`s draws each list into its own area of the target with its own viewport and push
+ * constants - a second display or a remote view without a second pipeline, atlas, or set of
+ * buffers, which under Vulkan SC's object reservations is what a second renderer would cost.
+ * Views in separate render pass instances are separate `record()` calls into separate slots.
  *
  * ## No runtime shader I/O
  *
@@ -60,6 +112,7 @@ import std;
 import mdux.core.result;
 import mdux.core.units;
 import mdux.draw;
+import mdux.evidence.digest;
 import mdux.shader.schema;
 
 export namespace mdux::render {
@@ -77,7 +130,7 @@ struct VulkanRenderContext {
     VkRenderPass renderPass{VK_NULL_HANDLE};
     std::uint32_t subpass{0};
 
-    /// Used once, during `create()`, to upload the default atlas. Never touched per frame.
+    /// Used once, during `create()`, to clear the atlas. Never touched per frame.
     VkQueue queue{VK_NULL_HANDLE};
     std::uint32_t queueFamilyIndex{0};
 
@@ -85,6 +138,11 @@ struct VulkanRenderContext {
     /// a renderer drawing into a region of a larger target passes that region's extent.
     mdux::core::Extent2D viewport{};
 
+    /// Optional. The pipeline is created through it when given, and the renderer only ever
+    /// reads it back: the caller creates it, possibly from `pipelineCacheInitialData()`, and
+    /// destroys it once no renderer built against it will call `writePipelineCache()` again.
+    VkPipelineCache pipelineCache{VK_NULL_HANDLE};
+
     [[nodiscard]] bool isValid() const noexcept {
         return device != VK_NULL_HANDLE && physicalDevice != VK_NULL_HANDLE &&
                renderPass != VK_NULL_HANDLE && queue != VK_NULL_HANDLE && viewport.width > 0 &&
@@ -110,16 +168,40 @@ enum class RenderError : std::uint8_t {
     NoSuitableMemoryType,     ///< no host-visible, host-coherent memory type on this device
     MemoryAllocationFailed,
     MemoryMapFailed,
-    ImageCreationFailed,      ///< the default atlas
+    ImageCreationFailed,      ///< the atlas
     ImageViewCreationFailed,
     SamplerCreationFailed,
     DescriptorPoolCreationFailed,
     DescriptorSetAllocationFailed,
-    CommandPoolCreationFailed,    ///< the one-shot pool used to upload the default atlas
+    CommandPoolCreationFailed,    ///< the atlas clear's one-shot pool, or the layers' pool
     CommandBufferAllocationFailed,
     AtlasUploadFailed,
     NullCommandBuffer,
     FrameExceedsBudget,       ///< the DrawList is larger than the renderer was built for
+    SegmentIdOutOfRange,      ///< a segment id at or past the SegmentBudget's maxSegments
+    SegmentAlreadyRetained,   ///< retain() for an id already resident; release first
+    SegmentBudgetExceeded,    ///< the resident range has no room left for the segment
+    SegmentNotRetained,       ///< a frame draws a segment this renderer does not hold
+    FrameSlotOutOfRange,      ///< a frame slot at or past the framesInFlight given to create()
+    FrameNotStaged,           ///< device-local geometry recorded without stage() first
+    AtlasRegionOutOfBounds,   ///< an AtlasUpdate region that is empty or leaves the atlas
+    AtlasTexelsMismatch,      ///< not exactly one texel span, or not one texel per region pixel
+    AtlasStagingExhausted,    ///< a frame's updates need more than its share of the staging ring
+    PipelineCacheNotProvided, ///< writePipelineCache() on a renderer built without a cache
+    PipelineCacheStorageTooSmall,
+    PipelineCacheReadFailed,  ///< vkGetPipelineCacheData failed
+    TimestampsUnsupported,    ///< timing asked of a queue family with no timestamp bits
+    QueryPoolCreationFailed,
+    TimestampsNotEnabled,     ///< a timing call on a renderer built without a TimestampBudget
+    TimestampsNotReset,       ///< a timed slot recorded without resetTimestamps() first
+    TimestampsNotAvailable,   ///< nothing recorded in the slot, or the GPU has not finished it
+    LayerIdOutOfRange,        ///< a layer id at or past the LayerBudget's maxLayers
+    LayerNotStatic,           ///< a layer's list draws geometry that is not a retained segment
+    LayerNotRecorded,         ///< a layer executed before it was recorded, or since released
+    LayerRecordingFailed,     ///< vkBeginCommandBuffer or vkEndCommandBuffer failed for a layer
+    ViewCountOutOfRange,      ///< no views, or more than the ViewBudget's maxViews
+    NullDrawList,             ///< a RenderView with no list
+    InvalidViewArea,          ///< a view area with no size, or an origin off the target
 
     // The package declares a pipeline contract this renderer does not implement. Refused at
     // create() rather than mistranslated, because every one of these becomes either a
@@ -132,6 +214,94 @@ enum class RenderError : std::uint8_t {
 
 [[nodiscard]] std::string_view describe(RenderError error) noexcept;
 
+/// Where the vertex and index buffers live. `Automatic` resolves at `create()`, from the memory
+/// types the physical device reports, to one of the other two.
+enum class GeometryMemory : std::uint8_t {
+    Automatic,
+    HostVisible,  ///< mapped directly; `record()` copies the frame in
+    DeviceLocal,  ///< staged; `stage()` copies the changed bytes in before `record()`
+};
+
+/// The atlas `create()` builds and how much a frame may stage into it. The default is the 1x1
+/// white atlas and no staging, which is all a renderer drawing solid rectangles needs.
+struct AtlasBudget {
+    mdux::core::Extent2D extent{.width = 1, .height = 1};
+    std::uint32_t stagingBytes{0};  ///< per frame slot; four per texel updated, either format
+};
+
+/**
+ * @brief One rectangle of the atlas to overwrite in place, and its texels.
+ *
+ * Exactly one of the two spans is given, row-major and top row first, with one entry per pixel
+ * of `region`. The atlas is RGBA8 whichever is given: a coverage byte is written to all four
+ * channels, because `CoverageR8` reads red and `SampledRgba` then sees coverage-weighted white.
+ */
+struct AtlasUpdate {
+    mdux::core::Rect region{};
+    std::span<const std::uint8_t> coverage{};         ///< as `mdux.text.raster` produces it
+    std::span<const mdux::core::ColorRgba8> pixels{};
+};
+
+/// How many of a frame's commands `record()` times one by one. Zero, the default, builds no
+/// query pool; more than the `DrawBudget`'s commands in every view is clamped to them. Commands
+/// past it are timed together, as the last duration.
+struct TimestampBudget {
+    std::uint32_t maxCommands{0};
+};
+
+/// How many static layers `create()` allocates a secondary command buffer for. Zero, the default,
+/// allocates none and creates no command pool.
+struct LayerBudget {
+    std::uint32_t maxLayers{0};
+};
+
+/// How many views one frame slot can draw. Each gets a region of the full `DrawBudget`, so the
+/// buffers hold `framesInFlight * maxViews` of them. The default is the context's one viewport.
+struct ViewBudget {
+    std::uint32_t maxViews{1};
+};
+
+/// One list and the area of the target it is drawn into. The list's coordinates are local to
+/// the area, whose extent is what the vertex shader converts them against.
+struct RenderView {
+    const mdux::draw::DrawList* list{nullptr};
+    mdux::core::Rect area{};
+};
+
+/// A frame's GPU time, from its first command starting to its last one finishing.
+struct GpuTimings {
+    std::chrono::nanoseconds frame{0};
+    /// One per timed command, in recording order, summing to `frame` but for rounding. Points
+    /// into storage the renderer owns, valid until the next `timings()` call.
+    std::span<const std::chrono::nanoseconds> commands{};
+};
+
+/// Bytes `writePipelineCache()` puts before the driver's data: an eight-byte tag, the key, and
+/// the data's length.
+inline constexpr std::size_t pipelineCacheHeaderBytes = 8 + 32 + 8;
+
+/**
+ * @brief The key a serialised pipeline cache is stored under: SHA-256 over the package's SPIR-V
+ * sidecar.
+ *
+ * The same bytes the baked `package.json` digests as its sidecar, so a rebaked shader is a new
+ * key and its stale cache is never offered to the driver. The driver checks its own header -
+ * vendor, device, driver version - on top, which is what covers a driver update.
+ */
+[[nodiscard]] mdux::evidence::Digest pipelineCacheKey(
+    const mdux::shader::PackageView& package) noexcept;
+
+/**
+ * @brief The driver data inside a blob `writePipelineCache()` produced, for
+ * `VkPipelineCacheCreateInfo::pInitialData`, or an empty span.
+ *
+ * Empty for anything that is not such a blob for this package: a truncated file, another
+ * shader's cache, or bytes that were never a cache. Empty is a valid initial cache, so the
+ * caller's path is the same either way, and a mismatch costs one compile rather than an error.
+ */
+[[nodiscard]] std::span<const std::byte> pipelineCacheInitialData(
+    std::span<const std::byte> saved, const mdux::shader::PackageView& package) noexcept;
+
 /**
  * @brief Records a governed `DrawList` into a caller-supplied command buffer.
  *
@@ -147,13 +317,28 @@ public:
      * @param context  caller-owned device, physical device and render pass; borrowed
      * @param package  the shader package, from generated `constexpr` data
      * @param budget   the ceiling every frame this renderer records must fit within
+     * @param segments what to reserve for retained segments; the default reserves nothing
+     * @param framesInFlight how many frames may be recorded before the oldest has finished on the
+     *                  GPU; each gets its own region of every per-frame buffer
+     * @param memory    where geometry lives; the default decides from the device's memory types
+     * @param atlasBudget the atlas extent and the staging each frame slot may use to update it
+     * @param timestamps how many commands each frame times; the default times none
+     * @param layers   how many static layers may be pre-recorded; the default allows none
+     * @param views    how many views one frame slot draws; the default draws one
      *
      * Fails rather than adapts: an invalid context, an empty budget, or a package missing a stage
      * are all errors here, where they are attributable, rather than a device loss later.
      */
     [[nodiscard]] static mdux::core::Result<UiRenderer, RenderError> create(
         const VulkanRenderContext& context, const mdux::shader::PackageView& package,
-        const mdux::draw::DrawBudget& budget) noexcept;
+        const mdux::draw::DrawBudget& budget,
+        const mdux::draw::SegmentBudget& segments = {},
+        std::uint32_t framesInFlight = 1,
+        GeometryMemory memory = GeometryMemory::Automatic,
+        const AtlasBudget& atlasBudget = {},
+        const TimestampBudget& timestamps = {},
+        const LayerBudget& layers = {},
+        const ViewBudget& views = {}) noexcept;
 
     ~UiRenderer();
 
@@ -162,35 +347,236 @@ public:
     UiRenderer(UiRenderer&& other) noexcept;
     UiRenderer& operator=(UiRenderer&& other) noexcept;
 
+    /**
+     * @brief Brings `frame`'s region up to date with `list`, recording any copy that needs.
+     *
+     * Recorded before the render pass begins, since a transfer is not allowed inside one. With
+     * device-local geometry this writes the vertex and index bytes that differ from what the
+     * region last held into its staging mirror, records one `vkCmdCopyBuffer` per buffer for the
+     * changed range, and a barrier making it visible to vertex input. Segments retained since the
+     * last call are copied the same way. With host-visible geometry it is the copy `record()`
+     * would make, done early, and records nothing.
+     */
+    [[nodiscard]] mdux::core::ResultVoid<RenderError> stage(
+        VkCommandBuffer commandBuffer, const mdux::draw::DrawList& list,
+        std::uint32_t frame = 0) noexcept;
+
+    /// As `stage(commandBuffer, list, frame)`, for each view's region of `frame`, in one barrier.
+    [[nodiscard]] mdux::core::ResultVoid<RenderError> stage(
+        VkCommandBuffer commandBuffer, std::span<const RenderView> views,
+        std::uint32_t frame = 0) noexcept;
+
+    /**
+     * @brief Overwrites rectangles of the atlas in place, recording the copies.
+     *
+     * Recorded before the render pass begins, as `stage()` is, and drawn by every frame submitted
+     * after it. The texels are written to `frame`'s share of the staging ring from its start, so a
+     * frame's updates are made in one call: a second call for the same slot before the GPU has
+     * run the first overwrites bytes the first one has yet to copy. Every update is checked, and
+     * their total against the share, before anything is written or recorded.
+     *
+     * A vertex's uv is in the shader's normalised 0..1 atlas coordinates; texel (x, y) of a
+     * W x H atlas is at (x / W, y / H).
+     */
+    [[nodiscard]] mdux::core::ResultVoid<RenderError> updateAtlas(
+        VkCommandBuffer commandBuffer, std::span<const AtlasUpdate> updates,
+        std::uint32_t frame = 0) noexcept;
+
+    /**
+     * @brief Readies `frame`'s timestamps for the next `record()` into it.
+     *
+     * Recorded before the render pass begins, as `stage()` is, since a query reset is not allowed
+     * inside one. Discards what the slot last measured, so `timings()` for it comes first.
+     */
+    [[nodiscard]] mdux::core::ResultVoid<RenderError> resetTimestamps(
+        VkCommandBuffer commandBuffer, std::uint32_t frame = 0) noexcept;
+
+    /**
+     * @brief The GPU time of the frame last recorded into `frame`, once it has executed.
+     *
+     * Never waits: called before the slot's fence has signalled, it is `TimestampsNotAvailable`
+     * rather than a stall, so a caller polling it cannot miss a deadline on its account. The
+     * durations are masked to the queue's valid timestamp bits and scaled by the device's
+     * timestamp period.
+     */
+    [[nodiscard]] mdux::core::Result<GpuTimings, RenderError> timings(
+        std::uint32_t frame = 0) noexcept;
+
     /**
      * @brief Copies `list` into the mapped buffers and records its commands.
      *
      * The command buffer must already be recording, inside a render pass compatible with the one
      * the renderer was created against. The atlas descriptor set is bound here, so a caller that
-     * only draws solid rectangles needs no descriptor plumbing of its own.
+     * only draws solid rectangles needs no descriptor plumbing of its own. A list whose `hash()`
+     * matches the frame already uploaded to `frame`'s region is not copied again.
+     *
+     * `frame` picks the region written, below the `framesInFlight` given to `create()`. A region
+     * is free once the GPU has finished the last submission recorded into it, which is what the
+     * caller's per-frame fence already tells it: cycling the slots with the fences lets frame N+1
+     * be recorded while frame N executes. With one frame in flight, slot 0 is the only one.
+     *
+     * With device-local geometry nothing is copied here: `list` must be the one last passed to
+     * `stage()` for `frame`, or the frame is refused with `FrameNotStaged`. With timestamps, the
+     * slot must have been reset since it was last recorded, or it is `TimestampsNotReset`.
+     */
+    [[nodiscard]] mdux::core::ResultVoid<RenderError> record(
+        VkCommandBuffer commandBuffer, const mdux::draw::DrawList& list,
+        std::uint32_t frame = 0) noexcept;
+
+    /**
+     * @brief As `record()`, but shading only the pixels inside `damage`.
+     *
+     * Every command is drawn once per damage rectangle it reaches, scissored to the intersection
+     * of its clip and that rectangle; a command reaching none is not drawn at all. `damage` is
+     * what `mdux::draw::DamageTracker::update()` returns, and an empty span records the frame's
+     * state and no draws. The caller's render area should be the tracker's `bounds()`, and its
+     * attachment must be loaded rather than cleared, or the pixels outside the damage are lost.
+     *
+     * The whole list is still uploaded, unless it is the frame already there: the saving is fill
+     * rate, which on the display controllers this targets is what runs out, not the few kilobytes
+     * a screen's vertices occupy.
+     */
+    [[nodiscard]] mdux::core::ResultVoid<RenderError> record(
+        VkCommandBuffer commandBuffer, const mdux::draw::DrawList& list,
+        std::span<const mdux::core::Rect> damage, std::uint32_t frame = 0) noexcept;
+
+    /**
+     * @brief As `record(commandBuffer, list, frame)`, for several lists into their own areas.
+     *
+     * View `i` of the span uses region `i` of `frame`, so the span is at most the `ViewBudget`'s
+     * `maxViews` long, and each list fits the `DrawBudget` on its own. Every view is checked
+     * before anything is copied or recorded. Each is drawn with its area as the viewport, its
+     * extent as the push constants, and every scissor cut to it; a timed frame's commands are
+     * timed across the views in order.
      */
     [[nodiscard]] mdux::core::ResultVoid<RenderError> record(
-        VkCommandBuffer commandBuffer, const mdux::draw::DrawList& list) noexcept;
+        VkCommandBuffer commandBuffer, std::span<const RenderView> views,
+        std::uint32_t frame = 0) noexcept;
+
+    /**
+     * @brief Copies `segment` into the resident range, where every later frame draws it from.
+     *
+     * The one upload a segment ever costs. The range is filled front to back and never compacted:
+     * a screen's static layers are retained when it is shown and released together when it is
+     * left, which is all the lifetime management a fixed budget needs. The bytes written are not
+     * ones an in-flight frame reads, so retaining needs no wait.
+     */
+    [[nodiscard]] mdux::core::ResultVoid<RenderError> retain(
+        const mdux::draw::DrawSegment& segment) noexcept;
+
+    /**
+     * @brief Records `list` into static layer `layer`'s secondary command buffer, replacing
+     * what it held.
+     *
+     * Every command of `list` must draw a retained segment, which never moves while it is
+     * retained - geometry in a frame region is overwritten by the next frame recorded into that
+     * slot, and a layer replaying it would draw whatever came next. Recorded with simultaneous
+     * use, so one layer may be executed by every frame in flight; re-recorded only when no
+     * submitted frame still executes it. `releaseSegments()` forgets every layer.
+     */
+    [[nodiscard]] mdux::core::ResultVoid<RenderError> recordLayer(
+        std::uint32_t layer, const mdux::draw::DrawList& list) noexcept;
+
+    /**
+     * @brief Replays the recorded static layers `layers`, in order, into `commandBuffer`.
+     *
+     * Recorded inside a render pass instance begun with
+     * `VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS`, which is why a frame's dynamic layer is a
+     * secondary too: executed in the same call sequence, before or after, as it should stack.
+     */
+    [[nodiscard]] mdux::core::ResultVoid<RenderError> executeLayers(
+        VkCommandBuffer commandBuffer, std::span<const std::uint32_t> layers) noexcept;
+
+    /// What a secondary command buffer recording into this renderer's render pass and subpass
+    /// inherits, for the caller's dynamic layer. No framebuffer: any compatible one will do.
+    [[nodiscard]] VkCommandBufferInheritanceInfo layerInheritance() const noexcept;
+
+    /// The bytes `writePipelineCache()` needs at present. The driver's data only grows while the
+    /// renderer lives, so the size is read again just before writing.
+    [[nodiscard]] mdux::core::Result<std::size_t, RenderError> pipelineCacheSize() const noexcept;
+
+    /**
+     * @brief Serialises the context's pipeline cache into `storage`, keyed on this renderer's
+     * package, and returns the part written.
+     *
+     * Called once the pipeline exists - after `create()`, any time - and written to persistent
+     * storage by the caller; nothing here does file I/O. `PipelineCacheNotProvided` if the
+     * context carried no cache, `PipelineCacheStorageTooSmall` if `storage` is shorter than
+     * `pipelineCacheSize()`.
+     */
+    [[nodiscard]] mdux::core::Result<std::span<const std::byte>, RenderError> writePipelineCache(
+        std::span<std::byte> storage) const noexcept;
+
+    /// Forgets every retained segment and empties the resident range. The caller must know no
+    /// submitted frame still draws one - typically after a queue wait, on a screen change.
+    void releaseSegments() noexcept;
 
     [[nodiscard]] const mdux::draw::DrawBudget& budget() const noexcept { return budget_; }
+    [[nodiscard]] const mdux::draw::SegmentBudget& segmentBudget() const noexcept {
+        return segmentBudget_;
+    }
+    [[nodiscard]] std::uint32_t framesInFlight() const noexcept { return framesInFlight_; }
+    /// What `create()` chose; never `Automatic`.
+    [[nodiscard]] GeometryMemory geometryMemory() const noexcept { return geometryMemory_; }
+    [[nodiscard]] mdux::core::Extent2D atlasExtent() const noexcept { return atlasExtent_; }
+    /// As clamped at `create()`; zero when no query pool was built.
+    [[nodiscard]] const TimestampBudget& timestampBudget() const noexcept {
+        return timestampBudget_;
+    }
+    [[nodiscard]] const LayerBudget& layerBudget() const noexcept { return layerBudget_; }
+    [[nodiscard]] const ViewBudget& viewBudget() const noexcept { return viewBudget_; }
+    [[nodiscard]] const mdux::evidence::Digest& pipelineCacheKey() const noexcept {
+        return pipelineCacheKey_;
+    }
     [[nodiscard]] VkPipeline pipeline() const noexcept { return pipeline_; }
     [[nodiscard]] VkPipelineLayout pipelineLayout() const noexcept { return pipelineLayout_; }
     [[nodiscard]] VkDescriptorSetLayout descriptorSetLayout() const noexcept {
         return descriptorSetLayout_;
     }
 
-    /// Bytes reserved for vertices and for indices. Fixed at construction; reported so a caller
-    /// can record what a screen's budget actually cost on the device.
+    /// Bytes reserved for vertices and for indices, every frame region and the resident range
+    /// together. Fixed at construction; reported so a caller can record what a screen's budget
+    /// actually cost on the device. Device-local geometry costs as much again in staging.
     [[nodiscard]] VkDeviceSize vertexBufferSize() const noexcept { return vertexBytes_; }
     [[nodiscard]] VkDeviceSize indexBufferSize() const noexcept { return indexBytes_; }
 
 private:
+    /// Where a retained segment sits in the resident range, and what was retained there, so a
+    /// frame naming a different segment under the same id is refused rather than drawn wrong.
+    struct ResidentSegment {
+        std::uint32_t firstIndex{0};
+        std::int32_t vertexOffset{0};
+        std::uint32_t indexCount{0};  ///< zero: nothing retained under this id
+        std::uint64_t hash{0};
+    };
+
     UiRenderer() noexcept = default;
 
     /// Destroys everything this object created, in reverse order of creation, and leaves every
     /// handle null. Called by the destructor and by move-assignment; safe to call twice.
     void destroy() noexcept;
 
+    /// Binds the pipeline, the atlas set, `area` as the viewport and its extent as the push
+    /// constants: the state every recorded view starts from.
+    void bindFrameState(VkCommandBuffer commandBuffer, const mdux::core::Rect& area) const noexcept;
+
+    /// The context's viewport, as the one area a single-view frame is drawn into.
+    [[nodiscard]] mdux::core::Rect fullArea() const noexcept {
+        return mdux::core::Rect{
+            .x = 0, .y = 0, .width = viewport_.width, .height = viewport_.height};
+    }
+
+    /// Every view of a frame checked against the budgets, before anything is copied or recorded.
+    [[nodiscard]] mdux::core::ResultVoid<RenderError> checkViews(
+        VkCommandBuffer commandBuffer, std::span<const RenderView> views,
+        std::uint32_t frame) const noexcept;
+
+    /// The body of every DrawList `record()`. `damage`, in each view's own coordinates, applies
+    /// to every view; none means each view is drawn whole.
+    [[nodiscard]] mdux::core::ResultVoid<RenderError> recordViews(
+        VkCommandBuffer commandBuffer, std::span<const RenderView> views,
+        std::optional<std::span<const mdux::core::Rect>> damage, std::uint32_t frame) noexcept;
+
     VkDevice device_{VK_NULL_HANDLE};
     VkShaderModule vertexModule_{VK_NULL_HANDLE};
     VkShaderModule fragmentModule_{VK_NULL_HANDLE};
@@ -207,6 +593,14 @@ private:
     VkSampler atlasSampler_{VK_NULL_HANDLE};
     VkDescriptorPool descriptorPool_{VK_NULL_HANDLE};
     VkDescriptorSet descriptorSet_{VK_NULL_HANDLE};
+    mdux::core::Extent2D atlasExtent_{};
+    // The atlas staging ring: framesInFlight shares of atlasStagingStride_ bytes, the stride the
+    // caller's stagingBytes rounded up to a whole texel so every share starts on one.
+    VkBuffer atlasStaging_{VK_NULL_HANDLE};
+    VkDeviceMemory atlasStagingMemory_{VK_NULL_HANDLE};
+    void* atlasStagingMapped_{nullptr};
+    std::uint32_t atlasStagingBytes_{0};
+    VkDeviceSize atlasStagingStride_{0};
     void* vertexMapped_{nullptr};
     void* indexMapped_{nullptr};
     VkDeviceSize vertexBytes_{0};
@@ -214,6 +608,66 @@ private:
     mdux::draw::DrawBudget budget_{};
     mdux::core::Extent2D viewport_{};
 
+    // The resident range is the front of each buffer - segments.maxVertices vertices and
+    // segments.maxIndices indices - and the frame regions follow it, one budget each. One buffer
+    // of each kind, so switching between a segment and the frame's own geometry is a draw
+    // parameter, not a rebind.
+    mdux::draw::SegmentBudget segmentBudget_{};
+    std::vector<ResidentSegment> resident_;  ///< one slot per segment id, sized at create()
+    std::uint32_t residentVertices_{0};
+    std::uint32_t residentIndices_{0};
+
+    /// What one frame region holds, so an unchanged frame recorded into it skips the copy. The
+    /// counts are how much of the region is known to match its staging mirror: bytes past them
+    /// were never copied, so comparing against the mirror there proves nothing.
+    struct UploadedFrame {
+        std::uint64_t hash{0};
+        bool valid{false};
+        std::uint32_t mirroredVertices{0};
+        std::uint32_t mirroredIndices{0};
+    };
+
+    /// A byte range of a staging mirror written but not yet copied to its device-local buffer.
+    struct PendingCopy {
+        VkDeviceSize begin{0};
+        VkDeviceSize end{0};  ///< equal to begin: nothing pending
+
+        [[nodiscard]] bool empty() const noexcept { return begin == end; }
+
+        /// Widened to take in [from, to): one region per buffer, however many retains fed it.
+        void widen(VkDeviceSize from, VkDeviceSize to) noexcept {
+            if (empty()) {
+                begin = from;
+                end = to;
+                return;
+            }
+            begin = std::min(begin, from);
+            end = std::max(end, to);
+        }
+    };
+
+    /// The memcpy of `list` into its mapped region, unless the region already holds it. Region
+    /// `frame * maxViews + view`, in the order the ring lays them out.
+    void uploadMapped(const mdux::draw::DrawList& list, std::uint32_t region) noexcept;
+
+    std::uint32_t framesInFlight_{0};
+    ViewBudget viewBudget_{};
+    std::vector<UploadedFrame> uploaded_;  ///< one per region, sized at create()
+
+    // Device-local geometry only. The mirrors have the vertex and index buffers' exact layout, so
+    // every copy's source and destination offsets are the same number, and vertexMapped_ and
+    // indexMapped_ point into them rather than into the buffers - which retain() never notices.
+    GeometryMemory geometryMemory_{GeometryMemory::HostVisible};
+    VkBuffer vertexStaging_{VK_NULL_HANDLE};
+    VkDeviceMemory vertexStagingMemory_{VK_NULL_HANDLE};
+    VkBuffer indexStaging_{VK_NULL_HANDLE};
+    VkDeviceMemory indexStagingMemory_{VK_NULL_HANDLE};
+    PendingCopy pendingVertices_{};  ///< retained segments not yet copied
+    PendingCopy pendingIndices_{};
+    // stage()'s copy regions: the resident range and one per view.
+    std::vector<VkBufferCopy> vertexCopies_;
+    std::vector<VkBufferCopy> indexCopies_;
+
     // What create() validated the package declares, so record() and the descriptor write use the
     // package's numbers rather than repeating literals that were only ever true for the current
     // shader. If the contract changes, create() refuses; it does not silently disagree with the
@@ -222,6 +676,50 @@ private:
     VkShaderStageFlags pushStages_{0};
     std::uint32_t pushOffset_{0};
     std::uint32_t pushSize_{0};
+
+    // Borrowed from the context, never destroyed here, and the key of the package the pipeline
+    // was built from, computed at create() so writing the cache hashes nothing.
+    VkPipelineCache pipelineCache_{VK_NULL_HANDLE};
+    mdux::evidence::Digest pipelineCacheKey_{};
+
+    /// What one slot's share of the query pool holds: reset and waiting for a frame, or the
+    /// number of timestamps and timed commands the last frame recorded into it wrote.
+    struct TimedFrame {
+        bool reset{false};
+        std::uint32_t queries{0};
+        std::uint32_t commands{0};
+    };
+
+    // GPU timing, all null or empty without a TimestampBudget. Each slot's share is
+    // maxCommands + 1 queries: the frame's start, then the end of each timed command.
+    VkQueryPool queryPool_{VK_NULL_HANDLE};
+    TimestampBudget timestampBudget_{};
+    std::uint32_t queriesPerFrame_{0};
+    std::uint64_t timestampMask_{0};
+    double timestampPeriod_{0.0};  ///< nanoseconds per tick
+    std::vector<TimedFrame> timed_;  ///< one per frame slot
+    std::vector<std::uint64_t> ticks_;  ///< one slot's results, read back by timings()
+    std::vector<std::chrono::nanoseconds> commandTimes_;
+
+    /// One static layer: its secondary command buffer, allocated at create(), and whether it
+    /// holds a recording that can still be executed.
+    struct StaticLayer {
+        VkCommandBuffer commandBuffer{VK_NULL_HANDLE};
+        bool recorded{false};
+    };
+
+    /// Every segment `list` draws is the one retained under its id, within its retained range.
+    [[nodiscard]] mdux::core::ResultVoid<RenderError> checkResident(
+        const mdux::draw::DrawList& list) const noexcept;
+
+    // Static layers, all null or empty without a LayerBudget. Their buffers are freed with the
+    // pool, as the descriptor set is with its pool.
+    VkRenderPass renderPass_{VK_NULL_HANDLE};  ///< borrowed, for layerInheritance()
+    std::uint32_t subpass_{0};
+    VkCommandPool layerPool_{VK_NULL_HANDLE};
+    LayerBudget layerBudget_{};
+    std::vector<StaticLayer> layers_;  ///< one per layer id, sized at create()
+    std::vector<VkCommandBuffer> executing_;  ///< executeLayers()' batch, sized at create()
 };
 
 /// The push-constant block the UI vertex shader declares: the viewport size, in pixels.
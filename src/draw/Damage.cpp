@@ -0,0 +1,203 @@
+/**
+ * @brief Implementation of governed damage tracking.
+ *
+ * @compliance ADR-004 Trust zones in C++
+ * @compliance ADR-005 Error handling and exceptions policy
+ *
+ * Nothing here allocates, throws, or recurses. The hash is FNV-1a rather than anything stronger:
+ * it decides what is repainted, not what is trusted, and a collision costs one stale rectangle on
+ * one frame - the next change to that command repaints it.
+ */
+module;
+
+module mdux.draw.damage;
+
+import std;
+import mdux.core.result;
+import mdux.core.units;
+import mdux.draw;
+
+namespace mdux::draw {
+
+using mdux::core::err;
+using mdux::core::Px;
+using mdux::core::Rect;
+using mdux::core::Result;
+
+namespace {
+
+constexpr std::uint64_t fnvPrime = 0x100000001b3ULL;
+
+/// Folds a 32-bit value into a `contentHash()` the same way it folds in a vertex.
+constexpr void mix(std::uint64_t& hash, std::uint32_t value) noexcept {
+    for (int shift = 0; shift < 32; shift += 8) {
+        hash ^= (value >> shift) & 0xffU;
+        hash *= fnvPrime;
+    }
+}
+
+constexpr void mix(std::uint64_t& hash, Px value) noexcept {
+    mix(hash, static_cast<std::uint32_t>(value));
+}
+
+[[nodiscard]] constexpr bool isEmpty(const Rect& rect) noexcept {
+    return rect.width <= 0 || rect.height <= 0;
+}
+
+[[nodiscard]] constexpr Rect intersect(const Rect& a, const Rect& b) noexcept {
+    const Px left = std::max(a.x, b.x);
+    const Px top = std::max(a.y, b.y);
+    const Px right = std::min(a.right(), b.right());
+    const Px bottom = std::min(a.bottom(), b.bottom());
+    if (right <= left || bottom <= top) {
+        return {};
+    }
+    return Rect{.x = left, .y = top, .width = right - left, .height = bottom - top};
+}
+
+[[nodiscard]] constexpr Rect unite(const Rect& a, const Rect& b) noexcept {
+    const Px left = std::min(a.x, b.x);
+    const Px top = std::min(a.y, b.y);
+    return Rect{.x = left,
+                .y = top,
+                .width = std::max(a.right(), b.right()) - left,
+                .height = std::max(a.bottom(), b.bottom()) - top};
+}
+
+/// Overlapping, or sharing an edge or a corner. Their bounding rectangle can cover pixels neither
+/// did - the notch of an L, the two empty corners of a diagonal pair - so merging them is overdraw
+/// traded for fewer rectangles, never a pixel missed.
+[[nodiscard]] constexpr bool touches(const Rect& a, const Rect& b) noexcept {
+    return a.x <= b.right() && b.x <= a.right() && a.y <= b.bottom() && b.y <= a.bottom();
+}
+
+}  // namespace
+
+CommandSignature signature(const DrawList& list, const DrawCommand& command) noexcept {
+    // A retained segment was hashed and measured once, when it was baked; re-reading its
+    // geometry every frame would spend exactly the per-frame work retaining it exists to avoid.
+    std::uint64_t hash = 0;
+    Rect bounds{};
+    if (command.segment != nullptr) {
+        hash = command.segment->hash();
+        bounds = command.segment->bounds();
+        mix(hash, command.segment->id());
+    } else {
+        const std::span<const Index> indices =
+            list.indices().subspan(command.firstIndex, command.indexCount);
+        const std::span<const UiVertex> batch = list.vertices().subspan(command.vertexOffset);
+        hash = contentHash(batch, indices);
+        bounds = geometryBounds(batch, indices);
+    }
+    mix(hash, command.clip.x);
+    mix(hash, command.clip.y);
+    mix(hash, command.clip.width);
+    mix(hash, command.clip.height);
+
+    // A zero-sized clip is "no clip", exactly as the renderer reads it.
+    if (!isEmpty(command.clip)) {
+        bounds = intersect(bounds, command.clip);
+    }
+    return CommandSignature{.hash = hash, .bounds = bounds};
+}
+
+Result<DamageTracker, DrawError> DamageTracker::create(std::span<CommandSignature> history,
+                                                       std::span<Rect> rects,
+                                                       const DrawBudget& budget,
+                                                       mdux::core::Extent2D viewport) noexcept {
+    if (viewport.width <= 0 || viewport.height <= 0) {
+        return err(DrawError::EmptyBudget);
+    }
+    if (history.size() < budget.maxCommands || rects.empty()) {
+        return err(DrawError::StorageTooSmall);
+    }
+
+    DamageTracker tracker;
+    tracker.history_ = history;
+    tracker.rects_ = rects;
+    tracker.viewport_ = viewport;
+    return tracker;
+}
+
+void DamageTracker::invalidate() noexcept {
+    historyCount_ = 0;
+    primed_ = false;
+}
+
+Rect DamageTracker::bounds() const noexcept {
+    Rect result{};
+    for (const Rect& rect : damage()) {
+        result = isEmpty(result) ? rect : unite(result, rect);
+    }
+    return result;
+}
+
+void DamageTracker::addDamage(const Rect& area) noexcept {
+    const Rect clamped =
+        intersect(area, Rect{.x = 0, .y = 0, .width = viewport_.width, .height = viewport_.height});
+    if (isEmpty(clamped)) {
+        return;
+    }
+    // The listed rectangles never touch one another, and that has to survive the merge: the
+    // renderer draws every command once per rectangle, so two that overlap would draw the pixels
+    // they share twice - blending anything translucent there twice. A merged rectangle can grow
+    // to touch others, so it absorbs each one it touches, removing it, until it touches none.
+    Rect merged = clamped;
+    for (std::uint32_t i = 0; i < rectCount_;) {
+        if (!touches(rects_[i], merged)) {
+            ++i;
+            continue;
+        }
+        merged = unite(merged, rects_[i]);
+        --rectCount_;
+        rects_[i] = rects_[rectCount_];
+        i = 0;
+    }
+    if (rectCount_ < rects_.size()) {
+        rects_[rectCount_] = merged;
+        ++rectCount_;
+        return;
+    }
+    // Full, and disjoint from everything already listed: one rectangle covering them all is
+    // more overdraw but a bounded number of scissored draws, which is the promise that matters.
+    rects_[0] = unite(bounds(), merged);
+    rectCount_ = 1;
+}
+
+std::span<const Rect> DamageTracker::update(const DrawList& list) noexcept {
+    rectCount_ = 0;
+    const std::span<const DrawCommand> commands = list.commands();
+    const Rect everything{.x = 0, .y = 0, .width = viewport_.width, .height = viewport_.height};
+
+    if (commands.size() > history_.size()) {
+        invalidate();
+        addDamage(everything);
+        return damage();
+    }
+
+    const auto count = static_cast<std::uint32_t>(commands.size());
+    for (std::uint32_t i = 0; i < count; ++i) {
+        const CommandSignature current = signature(list, commands[i]);
+        if (i >= historyCount_) {
+            addDamage(current.bounds);
+        } else if (history_[i] != current) {
+            addDamage(history_[i].bounds);
+            addDamage(current.bounds);
+        }
+        history_[i] = current;
+    }
+    // Commands the previous frame had and this one does not: what they drew must be cleared.
+    for (std::uint32_t i = count; i < historyCount_; ++i) {
+        addDamage(history_[i].bounds);
+    }
+
+    if (!primed_) {
+        rectCount_ = 0;
+        addDamage(everything);
+    }
+    historyCount_ = count;
+    primed_ = true;
+    return damage();
+}
+
+}  // namespace mdux::draw
@@ -28,6 +28,112 @@ namespace {
 constexpr std::uint32_t verticesPerRect = 4;
 constexpr std::uint32_t indicesPerRect = 6;
 
+constexpr std::uint64_t fnvOffset = 0xcbf29ce484222325ULL;
+constexpr std::uint64_t fnvPrime = 0x100000001b3ULL;
+
+/// Folds a 32-bit value in byte by byte, low byte first, so the hash is the same on every host.
+constexpr void mix(std::uint64_t& hash, std::uint32_t value) noexcept {
+    for (int shift = 0; shift < 32; shift += 8) {
+        hash ^= (value >> shift) & 0xffU;
+        hash *= fnvPrime;
+    }
+}
+
+constexpr void mix64(std::uint64_t& hash, std::uint64_t value) noexcept {
+    mix(hash, static_cast<std::uint32_t>(value));
+    mix(hash, static_cast<std::uint32_t>(value >> 32));
+}
+
+void mixVertex(std::uint64_t& hash, const UiVertex& vertex) noexcept {
+    mix(hash, std::bit_cast<std::uint32_t>(vertex.x));
+    mix(hash, std::bit_cast<std::uint32_t>(vertex.y));
+    mix(hash, std::bit_cast<std::uint32_t>(vertex.u));
+    mix(hash, std::bit_cast<std::uint32_t>(vertex.v));
+    mix(hash, vertex.color);
+    mix(hash, vertex.mode);
+}
+
+/// Everything about a command but a list command's index count, which is still growing when
+/// the command is folded in.
+void mixCommand(std::uint64_t& hash, const DrawCommand& command) noexcept {
+    if (command.segment != nullptr) {
+        mix(hash, 1);
+        mix(hash, command.segment->id());
+        mix64(hash, command.segment->hash());
+        mix(hash, command.indexCount);
+    } else {
+        mix(hash, 0);
+        mix(hash, command.vertexOffset);
+    }
+    mix(hash, command.firstIndex);
+    mix(hash, static_cast<std::uint32_t>(command.clip.x));
+    mix(hash, static_cast<std::uint32_t>(command.clip.y));
+    mix(hash, static_cast<std::uint32_t>(command.clip.width));
+    mix(hash, static_cast<std::uint32_t>(command.clip.height));
+}
+
+/// Whether command `a` of `left` draws exactly what command `b` of `right` does.
+[[nodiscard]] bool drawsTheSame(const DrawList& left, const DrawCommand& a,
+                                const DrawList& right, const DrawCommand& b) noexcept {
+    if (a.clip != b.clip || a.indexCount != b.indexCount ||
+        (a.segment == nullptr) != (b.segment == nullptr)) {
+        return false;
+    }
+    if (a.segment != nullptr) {
+        return a.segment->id() == b.segment->id() && a.segment->hash() == b.segment->hash() &&
+               a.firstIndex == b.firstIndex;
+    }
+    const std::span<const UiVertex> leftBatch = left.vertices().subspan(a.vertexOffset);
+    const std::span<const UiVertex> rightBatch = right.vertices().subspan(b.vertexOffset);
+    const Index* leftIndex = left.indices().data() + a.firstIndex;
+    const Index* rightIndex = right.indices().data() + b.firstIndex;
+    for (std::uint32_t i = 0; i < a.indexCount; ++i) {
+        if (leftBatch[leftIndex[i]] != rightBatch[rightIndex[i]]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// A vertex coordinate as a pixel edge. Clamped before conversion, because a float outside the
+/// range of `Px` converts with undefined behaviour, and a rectangle a billion pixels off-screen
+/// is no less off-screen for being clamped.
+[[nodiscard]] mdux::core::Px toPixel(float value, bool roundUp) noexcept {
+    constexpr float limit = 1073741824.0F;  // 2^30: far outside any viewport, far inside Px
+    const float clamped = std::clamp(roundUp ? std::ceil(value) : std::floor(value), -limit, limit);
+    return static_cast<mdux::core::Px>(clamped);
+}
+
+/// The part of `area` inside `clip`, empty when they do not overlap. An empty clip is "no clip".
+[[nodiscard]] constexpr mdux::core::Rect clipTo(const mdux::core::Rect& area,
+                                                const mdux::core::Rect& clip) noexcept {
+    if (clip.width <= 0 || clip.height <= 0) {
+        return area;
+    }
+    const mdux::core::Px left = std::max(area.x, clip.x);
+    const mdux::core::Px top = std::max(area.y, clip.y);
+    const mdux::core::Px right = std::min(area.right(), clip.right());
+    const mdux::core::Px bottom = std::min(area.bottom(), clip.bottom());
+    if (right <= left || bottom <= top) {
+        return {};
+    }
+    return mdux::core::Rect{.x = left, .y = top, .width = right - left, .height = bottom - top};
+}
+
+/// Where `inner` starts within `outer`, if it lies wholly inside it. Decided with `std::less`,
+/// which orders any two pointers, before anything is subtracted: subtracting pointers into
+/// different arrays is undefined, and a list that is not this one's shard is exactly that.
+template <typename T>
+[[nodiscard]] std::optional<std::size_t> sliceOffset(std::span<T> outer,
+                                                     std::span<T> inner) noexcept {
+    const std::less<const T*> before;
+    if (before(inner.data(), outer.data()) ||
+        before(outer.data() + outer.size(), inner.data() + inner.size())) {
+        return std::nullopt;
+    }
+    return static_cast<std::size_t>(inner.data() - outer.data());
+}
+
 }  // namespace
 
 std::string_view describe(DrawError error) noexcept {
@@ -35,7 +141,7 @@ std::string_view describe(DrawError error) noexcept {
     case DrawError::EmptyBudget:
         return "budget has no room for a primitive";
     case DrawError::BudgetExceedsIndexWidth:
-        return "budget exceeds what a 16-bit index can address";
+        return "budget exceeds what a vertex offset can address, or a primitive one batch";
     case DrawError::StorageTooSmall:
         return "supplied storage is smaller than the budget claims";
     case DrawError::VertexBudgetExceeded:
@@ -46,10 +152,76 @@ std::string_view describe(DrawError error) noexcept {
         return "command budget exceeded";
     case DrawError::DegenerateRect:
         return "rectangle has zero or negative width or height";
+    case DrawError::InvalidSegment:
+        return "segment is empty, not whole triangles, or indexes past its vertices";
+    case DrawError::BatchSizeMismatch:
+        return "batch spans differ in length from its rectangles";
+    case DrawError::InvalidPolyline:
+        return "polyline has under two distinct points, a non-finite value, no width, or a miter "
+               "limit under 1";
+    case DrawError::ShardMismatch:
+        return "merged lists are not this list's shards in order, or the list is not empty";
     }
     return "unknown draw error";
 }
 
+std::uint64_t contentHash(std::span<const UiVertex> vertices,
+                          std::span<const Index> indices) noexcept {
+    std::uint64_t hash = fnvOffset;
+    // Through the indices, so the hash sees what the GPU will draw and not where it was stored.
+    for (const Index index : indices) {
+        mixVertex(hash, vertices[index]);
+    }
+    return hash;
+}
+
+mdux::core::Rect geometryBounds(std::span<const UiVertex> vertices,
+                                std::span<const Index> indices) noexcept {
+    if (indices.empty()) {
+        return {};
+    }
+    float minX = std::numeric_limits<float>::max();
+    float minY = std::numeric_limits<float>::max();
+    float maxX = std::numeric_limits<float>::lowest();
+    float maxY = std::numeric_limits<float>::lowest();
+    for (const Index index : indices) {
+        const UiVertex& vertex = vertices[index];
+        minX = std::min(minX, vertex.x);
+        minY = std::min(minY, vertex.y);
+        maxX = std::max(maxX, vertex.x);
+        maxY = std::max(maxY, vertex.y);
+    }
+    const mdux::core::Px left = toPixel(minX, false);
+    const mdux::core::Px top = toPixel(minY, false);
+    return mdux::core::Rect{.x = left,
+                            .y = top,
+                            .width = toPixel(maxX, true) - left,
+                            .height = toPixel(maxY, true) - top};
+}
+
+Result<DrawSegment, DrawError> DrawSegment::create(SegmentId id,
+                                                   std::span<const UiVertex> vertices,
+                                                   std::span<const Index> indices) noexcept {
+    // Everything the renderer will trust without looking again: an index past the segment's own
+    // vertices would read another segment's geometry, or past the end of the resident range.
+    if (indices.empty() || indices.size() % 3 != 0 || vertices.size() > maxIndexableVertices) {
+        return err(DrawError::InvalidSegment);
+    }
+    for (const Index index : indices) {
+        if (index >= vertices.size()) {
+            return err(DrawError::InvalidSegment);
+        }
+    }
+
+    DrawSegment segment;
+    segment.id_ = id;
+    segment.vertices_ = vertices;
+    segment.indices_ = indices;
+    segment.hash_ = contentHash(vertices, indices);
+    segment.bounds_ = geometryBounds(vertices, indices);
+    return segment;
+}
+
 Result<DrawList, DrawError> DrawList::create(std::span<UiVertex> vertices, std::span<Index> indices,
                                              std::span<DrawCommand> commands,
                                              const DrawBudget& budget) noexcept {
@@ -57,7 +229,7 @@ Result<DrawList, DrawError> DrawList::create(std::span<UiVertex> vertices, std::
         budget.maxCommands == 0) {
         return err(DrawError::EmptyBudget);
     }
-    if (budget.maxVertices > maxIndexableVertices) {
+    if (budget.maxVertices > maxListVertices) {
         return err(DrawError::BudgetExceedsIndexWidth);
     }
     if (vertices.size() < budget.maxVertices || indices.size() < budget.maxIndices ||
@@ -70,14 +242,123 @@ Result<DrawList, DrawError> DrawList::create(std::span<UiVertex> vertices, std::
     list.indices_ = indices;
     list.commands_ = commands;
     list.budget_ = budget;
+    list.rehash();
     return list;
 }
 
+Result<DrawList, DrawError> DrawList::shard(std::span<const DrawBudget> budgets,
+                                            std::size_t which) const noexcept {
+    if (which >= budgets.size() || !empty()) {
+        return err(DrawError::ShardMismatch);
+    }
+    // Summed in 64 bits, so a set of budgets each near the 32-bit ceiling cannot wrap into
+    // looking as if it fits.
+    std::uint64_t vertices = 0;
+    std::uint64_t indices = 0;
+    std::uint64_t commands = 0;
+    std::size_t vertexOffset = 0;
+    std::size_t indexOffset = 0;
+    std::size_t commandOffset = 0;
+    for (std::size_t i = 0; i < budgets.size(); ++i) {
+        if (i == which) {
+            vertexOffset = static_cast<std::size_t>(vertices);
+            indexOffset = static_cast<std::size_t>(indices);
+            commandOffset = static_cast<std::size_t>(commands);
+        }
+        vertices += budgets[i].maxVertices;
+        indices += budgets[i].maxIndices;
+        commands += budgets[i].maxCommands;
+    }
+    if (vertices > budget_.maxVertices || indices > budget_.maxIndices ||
+        commands > budget_.maxCommands) {
+        return err(DrawError::StorageTooSmall);
+    }
+    const DrawBudget& budget = budgets[which];
+    return create(vertices_.subspan(vertexOffset, budget.maxVertices),
+                  indices_.subspan(indexOffset, budget.maxIndices),
+                  commands_.subspan(commandOffset, budget.maxCommands), budget);
+}
+
+ResultVoid<DrawError> DrawList::merge(std::span<const DrawList> shards) noexcept {
+    if (!empty()) {
+        return err(DrawError::ShardMismatch);
+    }
+    // Every shard is checked before anything moves. In order and disjoint is what makes the
+    // moves below safe: each shard's data is copied down, never up, onto storage that is free
+    // or already read.
+    std::size_t vertexEnd = 0;
+    std::size_t indexEnd = 0;
+    std::size_t commandEnd = 0;
+    for (const DrawList& shard : shards) {
+        const auto vertexOffset = sliceOffset(vertices_.first(budget_.maxVertices),
+                                              shard.vertices_.first(shard.budget_.maxVertices));
+        const auto indexOffset = sliceOffset(indices_.first(budget_.maxIndices),
+                                             shard.indices_.first(shard.budget_.maxIndices));
+        const auto commandOffset = sliceOffset(commands_.first(budget_.maxCommands),
+                                               shard.commands_.first(shard.budget_.maxCommands));
+        if (!vertexOffset || !indexOffset || !commandOffset || *vertexOffset < vertexEnd ||
+            *indexOffset < indexEnd || *commandOffset < commandEnd) {
+            return err(DrawError::ShardMismatch);
+        }
+        vertexEnd = *vertexOffset + shard.budget_.maxVertices;
+        indexEnd = *indexOffset + shard.budget_.maxIndices;
+        commandEnd = *commandOffset + shard.budget_.maxCommands;
+    }
+
+    // Past this point nothing can fail. Copying forwards with the destination at or below the
+    // source only ever overwrites elements already read.
+    for (const DrawList& shard : shards) {
+        // A shard of one batch that fits in the current one joins it, rebased exactly as
+        // building it here would have been; any other starts a batch of its own at its first
+        // vertex, and keeps its indices as they are.
+        const bool joins = shard.batchBase_ == 0 && !crossesBatch(shard.vertexCount_);
+        const std::uint32_t rebase = joins ? vertexCount_ - batchBase_ : 0;
+        const std::uint32_t batchStart = joins ? batchBase_ : vertexCount_;
+        const UiVertex* vertexSource = shard.vertices_.data();
+        UiVertex* const vertexTarget = vertices_.data() + vertexCount_;
+        for (std::uint32_t i = 0; i < shard.vertexCount_; ++i) {
+            vertexTarget[i] = vertexSource[i];
+        }
+        const Index* indexSource = shard.indices_.data();
+        Index* const indexTarget = indices_.data() + indexCount_;
+        for (std::uint32_t i = 0; i < shard.indexCount_; ++i) {
+            indexTarget[i] = static_cast<Index>(indexSource[i] + rebase);
+        }
+        for (std::uint32_t i = 0; i < shard.commandCount_; ++i) {
+            DrawCommand command = shard.commands_[i];
+            if (command.segment == nullptr) {
+                command.firstIndex += indexCount_;
+                command.vertexOffset += batchStart;
+            }
+            DrawCommand* const last =
+                commandCount_ == 0 ? nullptr : commands_.data() + (commandCount_ - 1);
+            if (i == 0 && last != nullptr && last->segment == nullptr &&
+                command.segment == nullptr && last->clip == command.clip &&
+                last->vertexOffset == command.vertexOffset) {
+                last->indexCount += command.indexCount;
+            } else {
+                commands_[commandCount_] = command;
+                ++commandCount_;
+            }
+        }
+        if (!joins) {
+            batchBase_ = vertexCount_ + shard.batchBase_;
+        }
+        vertexCount_ += shard.vertexCount_;
+        indexCount_ += shard.indexCount_;
+        clip_ = shard.clip_;
+    }
+    rehash();
+    return {};
+}
+
 void DrawList::reset() noexcept {
     vertexCount_ = 0;
     indexCount_ = 0;
     commandCount_ = 0;
+    batchBase_ = 0;
     clip_ = {};
+    rehash();
 }
 
 void DrawList::setClip(const mdux::core::Rect& clip) noexcept {
@@ -86,6 +367,22 @@ void DrawList::setClip(const mdux::core::Rect& clip) noexcept {
     clip_ = clip;
 }
 
+ResultVoid<DrawError> DrawList::addSegment(const DrawSegment& segment) noexcept {
+    if (commandCount_ == budget_.maxCommands) {
+        return err(DrawError::CommandBudgetExceeded);
+    }
+    // Always a command of its own, never an extension of the previous one: its indices live in
+    // the segment's resident range, not this list's.
+    commands_[commandCount_] =
+        DrawCommand{.firstIndex = 0,
+                    .indexCount = static_cast<std::uint32_t>(segment.indices().size()),
+                    .clip = clip_,
+                    .segment = &segment};
+    mixCommand(commandHash_, commands_[commandCount_]);
+    ++commandCount_;
+    return {};
+}
+
 ResultVoid<DrawError> DrawList::addSolidRect(const mdux::core::Rect& rect,
                                              mdux::core::ColorRgba8 color) noexcept {
     // A solid primitive still carries uv, because the vertex layout is fixed and the fragment
@@ -96,70 +393,279 @@ ResultVoid<DrawError> DrawList::addSolidRect(const mdux::core::Rect& rect,
 
 ResultVoid<DrawError> DrawList::addRect(const mdux::core::Rect& rect, mdux::core::ColorRgba8 color,
                                         DrawMode mode, const mdux::core::Rect& uv) noexcept {
-    if (rect.width <= 0 || rect.height <= 0) {
-        return err(DrawError::DegenerateRect);
+    return appendRects(std::span{&rect, 1}, std::span{&uv, 1}, std::span{&color, 1}, mode);
+}
+
+ResultVoid<DrawError> DrawList::addSolidRects(
+    std::span<const mdux::core::Rect> rects,
+    std::span<const mdux::core::ColorRgba8> colors) noexcept {
+    if (colors.size() != 1 && colors.size() != rects.size()) {
+        return err(DrawError::BatchSizeMismatch);
+    }
+    return appendRects(rects, {}, colors, DrawMode::Solid);
+}
+
+ResultVoid<DrawError> DrawList::addRects(std::span<const mdux::core::Rect> rects,
+                                         std::span<const mdux::core::Rect> uvs,
+                                         std::span<const mdux::core::ColorRgba8> colors,
+                                         DrawMode mode) noexcept {
+    if (uvs.size() != rects.size() || (colors.size() != 1 && colors.size() != rects.size())) {
+        return err(DrawError::BatchSizeMismatch);
+    }
+    return appendRects(rects, uvs, colors, mode);
+}
+
+ResultVoid<DrawError> DrawList::appendRects(std::span<const mdux::core::Rect> rects,
+                                            std::span<const mdux::core::Rect> uvs,
+                                            std::span<const mdux::core::ColorRgba8> colors,
+                                            DrawMode mode) noexcept {
+    if (rects.empty()) {
+        return {};
+    }
+    // Every check for the whole batch happens before the first write, so a batch is recorded
+    // completely or not at all - the same promise a single addRect() makes.
+    for (const mdux::core::Rect& rect : rects) {
+        if (rect.width <= 0 || rect.height <= 0) {
+            return err(DrawError::DegenerateRect);
+        }
     }
 
     // Subtraction against remaining capacity, never addition against the limit: with counts near
-    // the top of their range an addition could wrap and read as acceptable.
-    if (budget_.maxVertices - vertexCount_ < verticesPerRect) {
+    // the top of their range an addition could wrap and read as acceptable. Dividing the room
+    // rather than multiplying the count keeps that true for a batch of any size.
+    const std::size_t count = rects.size();
+    if ((budget_.maxVertices - vertexCount_) / verticesPerRect < count) {
         return err(DrawError::VertexBudgetExceeded);
     }
-    if (budget_.maxIndices - indexCount_ < indicesPerRect) {
+    if ((budget_.maxIndices - indexCount_) / indicesPerRect < count) {
         return err(DrawError::IndexBudgetExceeded);
     }
 
-    // A new command is needed when nothing has been recorded yet, or when the clip changed since
-    // the current command started.
-    const bool needsCommand =
-        commandCount_ == 0 || commands_[commandCount_ - 1].clip != clip_;
-    if (needsCommand && commandCount_ == budget_.maxCommands) {
+    // The rectangles share one clip, so they need at most one new command - plus one each time
+    // they cross into a new 16-bit vertex batch, which only a list budgeted past one batch can.
+    constexpr std::size_t rectsPerBatch = maxIndexableVertices / verticesPerRect;
+    const bool newBatch = crossesBatch(verticesPerRect);
+    std::size_t room = newBatch ? rectsPerBatch
+                                : (maxIndexableVertices - (vertexCount_ - batchBase_)) /
+                                      verticesPerRect;
+    const std::size_t crossings = count <= room ? 0 : (count - room - 1) / rectsPerBatch + 1;
+    const bool startCommand = newBatch || needsCommand();
+    if (budget_.maxCommands - commandCount_ < crossings + (startCommand ? 1U : 0U)) {
         return err(DrawError::CommandBudgetExceeded);
     }
 
-    // Past this point nothing can fail, so the list never holds a half-recorded primitive.
-    const auto baseVertex = static_cast<Index>(vertexCount_);
-    const auto left = static_cast<float>(rect.x);
-    const auto top = static_cast<float>(rect.y);
-    const auto right = static_cast<float>(rect.right());
-    const auto bottom = static_cast<float>(rect.bottom());
-    const auto u0 = static_cast<float>(uv.x);
-    const auto v0 = static_cast<float>(uv.y);
-    const auto u1 = static_cast<float>(uv.right());
-    const auto v1 = static_cast<float>(uv.bottom());
-    const std::uint32_t packed = packColor(color);
+    // Past this point nothing can fail, so the list never holds a half-recorded primitive. The
+    // loop body is branch-free apart from the colour and uv selects, which do not vary within a
+    // batch, and writes through raw pointers so the compiler need not prove the spans' bounds.
     const auto modeValue = static_cast<std::uint32_t>(mode);
+    const bool oneColor = colors.size() == 1;
+    const std::uint32_t sharedColor = packColor(colors.front());
+    if (newBatch) {
+        batchBase_ = vertexCount_;
+    }
+    bool start = startCommand;
+    for (std::size_t first = 0; first < count;) {
+        const std::size_t last = first + std::min(count - first, room);
+        UiVertex* vertex = vertices_.data() + vertexCount_;
+        Index* index = indices_.data() + indexCount_;
+        auto base = static_cast<Index>(vertexCount_ - batchBase_);
+
+        for (std::size_t i = first; i < last; ++i) {
+            const mdux::core::Rect& rect = rects[i];
+            const mdux::core::Rect uv = uvs.empty() ? mdux::core::Rect{} : uvs[i];
+            const std::uint32_t packed = oneColor ? sharedColor : packColor(colors[i]);
+            const auto left = static_cast<float>(rect.x);
+            const auto top = static_cast<float>(rect.y);
+            const auto right = static_cast<float>(rect.right());
+            const auto bottom = static_cast<float>(rect.bottom());
+            const auto u0 = static_cast<float>(uv.x);
+            const auto v0 = static_cast<float>(uv.y);
+            const auto u1 = static_cast<float>(uv.right());
+            const auto v1 = static_cast<float>(uv.bottom());
+
+            // Corner order is fixed: top-left, top-right, bottom-right, bottom-left. Two frames
+            // built from the same primitives must produce byte-identical buffers, which a varying
+            // order would break for no benefit. A solid rectangle's uv is zero rather than left
+            // undefined, for the same reason.
+            vertex[0] = UiVertex{.x = left, .y = top, .u = u0, .v = v0, .color = packed,
+                                 .mode = modeValue};
+            vertex[1] = UiVertex{.x = right, .y = top, .u = u1, .v = v0, .color = packed,
+                                 .mode = modeValue};
+            vertex[2] = UiVertex{.x = right, .y = bottom, .u = u1, .v = v1, .color = packed,
+                                 .mode = modeValue};
+            vertex[3] = UiVertex{.x = left, .y = bottom, .u = u0, .v = v1, .color = packed,
+                                 .mode = modeValue};
+
+            index[0] = base;
+            index[1] = static_cast<Index>(base + 1);
+            index[2] = static_cast<Index>(base + 2);
+            index[3] = base;
+            index[4] = static_cast<Index>(base + 2);
+            index[5] = static_cast<Index>(base + 3);
+
+            vertex += verticesPerRect;
+            index += indicesPerRect;
+            base = static_cast<Index>(base + verticesPerRect);
+        }
+
+        const auto chunkVertices = static_cast<std::uint32_t>((last - first) * verticesPerRect);
+        const auto chunkIndices = static_cast<std::uint32_t>((last - first) * indicesPerRect);
+        chargeCommand(start, chunkIndices);
+        hashAppended(chunkVertices, chunkIndices);
+        vertexCount_ += chunkVertices;
+        indexCount_ += chunkIndices;
+        // Rectangles left over start the next batch, and a command of its own there.
+        first = last;
+        if (first < count) {
+            batchBase_ = vertexCount_;
+        }
+        room = rectsPerBatch;
+        start = true;
+    }
+    return {};
+}
+
+bool DrawList::needsCommand() const noexcept {
+    return commandCount_ == 0 || commands_[commandCount_ - 1].clip != clip_ ||
+           commands_[commandCount_ - 1].segment != nullptr ||
+           commands_[commandCount_ - 1].vertexOffset != batchBase_;
+}
 
-    // Corner order is fixed: top-left, top-right, bottom-right, bottom-left. Two frames built
-    // from the same primitives must produce byte-identical buffers, which a varying order would
-    // break for no benefit.
-    vertices_[vertexCount_ + 0] = UiVertex{
-        .x = left, .y = top, .u = u0, .v = v0, .color = packed, .mode = modeValue};
-    vertices_[vertexCount_ + 1] = UiVertex{
-        .x = right, .y = top, .u = u1, .v = v0, .color = packed, .mode = modeValue};
-    vertices_[vertexCount_ + 2] = UiVertex{
-        .x = right, .y = bottom, .u = u1, .v = v1, .color = packed, .mode = modeValue};
-    vertices_[vertexCount_ + 3] = UiVertex{
-        .x = left, .y = bottom, .u = u0, .v = v1, .color = packed, .mode = modeValue};
-
-    indices_[indexCount_ + 0] = static_cast<Index>(baseVertex + 0);
-    indices_[indexCount_ + 1] = static_cast<Index>(baseVertex + 1);
-    indices_[indexCount_ + 2] = static_cast<Index>(baseVertex + 2);
-    indices_[indexCount_ + 3] = static_cast<Index>(baseVertex + 0);
-    indices_[indexCount_ + 4] = static_cast<Index>(baseVertex + 2);
-    indices_[indexCount_ + 5] = static_cast<Index>(baseVertex + 3);
-
-    if (needsCommand) {
+bool DrawList::crossesBatch(std::size_t vertices) const noexcept {
+    return vertexCount_ - batchBase_ > maxIndexableVertices - vertices;
+}
+
+std::uint32_t DrawList::compact() noexcept {
+    const std::uint32_t before = commandCount_;
+    std::uint32_t at = 1;
+    while (at < commandCount_) {
+        const DrawCommand moving = commands_[at];
+        if (moving.segment != nullptr) {
+            ++at;
+            continue;
+        }
+        // Walk back towards the nearest command this one could extend. Every command passed on
+        // the way will be drawn after it instead of before, which is invisible only if the two
+        // touch no pixel in common; the first one that might ends the search where it stands.
+        const mdux::core::Rect area = paintedArea(at);
+        std::uint32_t target = at;
+        for (std::uint32_t earlier = at; earlier-- > 0;) {
+            const DrawCommand& candidate = commands_[earlier];
+            if (candidate.segment == nullptr && candidate.clip == moving.clip &&
+                candidate.vertexOffset == moving.vertexOffset) {
+                target = earlier;
+                break;
+            }
+            if (paintedArea(earlier).overlaps(area)) {
+                break;
+            }
+        }
+        if (target == at) {
+            ++at;
+            continue;
+        }
+
+        // The list's own commands own consecutive index ranges in command order, so the commands
+        // jumped own exactly [join, moving.firstIndex). Rotating puts the moved indices at the
+        // end of the target's range and shifts the jumped ones up by as many.
+        const std::uint32_t join = commands_[target].firstIndex + commands_[target].indexCount;
+        Index* const indices = indices_.data();
+        std::rotate(indices + join, indices + moving.firstIndex,
+                    indices + moving.firstIndex + moving.indexCount);
+        for (std::uint32_t jumped = target + 1; jumped < at; ++jumped) {
+            if (commands_[jumped].segment == nullptr) {
+                commands_[jumped].firstIndex += moving.indexCount;
+            }
+        }
+        commands_[target].indexCount += moving.indexCount;
+        DrawCommand* const commands = commands_.data();
+        std::move(commands + at + 1, commands + commandCount_, commands + at);
+        --commandCount_;
+    }
+    if (commandCount_ != before) {
+        rehash();
+    }
+    return before - commandCount_;
+}
+
+mdux::core::Rect DrawList::paintedArea(std::uint32_t at) const noexcept {
+    const DrawCommand& command = commands_[at];
+    if (command.segment != nullptr) {
+        return clipTo(command.segment->bounds(), command.clip);
+    }
+    return clipTo(geometryBounds(vertices().subspan(command.vertexOffset),
+                                 indices().subspan(command.firstIndex, command.indexCount)),
+                  command.clip);
+}
+
+void DrawList::chargeCommand(bool startCommand, std::uint32_t indexCount) noexcept {
+    if (startCommand) {
         commands_[commandCount_] =
-            DrawCommand{.firstIndex = indexCount_, .indexCount = indicesPerRect, .clip = clip_};
+            DrawCommand{.firstIndex = indexCount_,
+                        .indexCount = indexCount,
+                        .clip = clip_,
+                        .vertexOffset = batchBase_};
+        mixCommand(commandHash_, commands_[commandCount_]);
         ++commandCount_;
     } else {
-        commands_[commandCount_ - 1].indexCount += indicesPerRect;
+        commands_[commandCount_ - 1].indexCount += indexCount;
     }
+}
 
-    vertexCount_ += verticesPerRect;
-    indexCount_ += indicesPerRect;
-    return {};
+std::uint64_t DrawList::hash() const noexcept {
+    // The counts stand in for the one thing the command stream leaves out: a list command's index
+    // count is the distance to the next list command's first index, or to the end of the indices.
+    std::uint64_t hash = commandHash_;
+    mix64(hash, vertexHash_);
+    mix64(hash, indexHash_);
+    mix(hash, vertexCount_);
+    mix(hash, indexCount_);
+    mix(hash, commandCount_);
+    return hash;
+}
+
+DrawDiff DrawList::diff(const DrawList& other) const noexcept {
+    const std::uint32_t shared = std::min(commandCount_, other.commandCount_);
+    std::uint32_t prefix = 0;
+    while (prefix < shared &&
+           drawsTheSame(*this, commands_[prefix], other, other.commands_[prefix])) {
+        ++prefix;
+    }
+    std::uint32_t suffix = 0;
+    while (suffix < shared - prefix &&
+           drawsTheSame(*this, commands_[commandCount_ - 1 - suffix], other,
+                        other.commands_[other.commandCount_ - 1 - suffix])) {
+        ++suffix;
+    }
+    return DrawDiff{.first = prefix,
+                    .count = commandCount_ - prefix - suffix,
+                    .otherCount = other.commandCount_ - prefix - suffix};
+}
+
+void DrawList::hashAppended(std::uint32_t vertices, std::uint32_t indices) noexcept {
+    const UiVertex* vertex = vertices_.data() + vertexCount_;
+    for (std::uint32_t i = 0; i < vertices; ++i) {
+        mixVertex(vertexHash_, vertex[i]);
+    }
+    const Index* index = indices_.data() + indexCount_;
+    for (std::uint32_t i = 0; i < indices; ++i) {
+        mix(indexHash_, index[i]);
+    }
+}
+
+void DrawList::rehash() noexcept {
+    vertexHash_ = fnvOffset;
+    indexHash_ = fnvOffset;
+    commandHash_ = fnvOffset;
+    for (const UiVertex& vertex : vertices()) {
+        mixVertex(vertexHash_, vertex);
+    }
+    for (const Index index : indices()) {
+        mix(indexHash_, index);
+    }
+    for (const DrawCommand& command : commands()) {
+        mixCommand(commandHash_, command);
+    }
 }
 
 }  // namespace mdux::draw
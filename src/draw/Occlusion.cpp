@@ -0,0 +1,227 @@
+/**
+ * @brief Implementation of occlusion culling for mdux.draw.
+ *
+ * @compliance ADR-004 Trust zones in C++
+ * @compliance ADR-005 Error handling and exceptions policy
+ *
+ * A third implementation unit of `mdux.draw`, beside `Polyline.cpp`. One backward walk tests
+ * each triangle against the grid and then offers it as an occluder; one forward walk removes what
+ * was marked. Both are linear in the list's indices, and an occluder costs the tiles it touches.
+ * Nothing here allocates, throws, or recurses.
+ */
+module;
+
+module mdux.draw;
+
+import std;
+import mdux.core.result;
+import mdux.core.units;
+
+namespace mdux::draw {
+
+using mdux::core::err;
+using mdux::core::Px;
+using mdux::core::Rect;
+using mdux::core::Result;
+
+namespace {
+
+[[nodiscard]] constexpr bool isEmpty(const Rect& rect) noexcept {
+    return rect.width <= 0 || rect.height <= 0;
+}
+
+[[nodiscard]] constexpr Rect intersect(const Rect& a, const Rect& b) noexcept {
+    const Px left = std::max(a.x, b.x);
+    const Px top = std::max(a.y, b.y);
+    const Px right = std::min(a.right(), b.right());
+    const Px bottom = std::min(a.bottom(), b.bottom());
+    if (right <= left || bottom <= top) {
+        return {};
+    }
+    return Rect{.x = left, .y = top, .width = right - left, .height = bottom - top};
+}
+
+/// `area` cut to `clip`. A zero-sized clip is "no clip", exactly as the renderer reads it.
+[[nodiscard]] constexpr Rect clipTo(const Rect& area, const Rect& clip) noexcept {
+    return isEmpty(clip) ? area : intersect(area, clip);
+}
+
+[[nodiscard]] constexpr std::int64_t areaOf(const Rect& rect) noexcept {
+    return isEmpty(rect) ? 0 : std::int64_t{rect.width} * std::int64_t{rect.height};
+}
+
+/// Whether a coordinate is a whole pixel edge that `Px` can hold. A rectangle whose edge falls
+/// mid-pixel covers that column only where the rasteriser says so, which is not all of it.
+[[nodiscard]] bool isPixelEdge(float value) noexcept {
+    constexpr float limit = 1073741824.0F;  // 2^30, as for toPixel()
+    return std::floor(value) == value && value > -limit && value < limit;
+}
+
+/// Marks a triangle for removal: three equal indices, which also draw nothing if left in.
+void markCulled(Index* corner) noexcept {
+    corner[1] = corner[0];
+    corner[2] = corner[0];
+}
+
+[[nodiscard]] bool isCulled(const Index* corner) noexcept {
+    return corner[0] == corner[1] && corner[0] == corner[2];
+}
+
+/// The rectangle the six indices at `corner` draw, if they are an opaque solid rectangle exactly
+/// as `appendRects()` writes one; empty otherwise.
+[[nodiscard]] Rect opaqueRect(std::span<const UiVertex> vertices, const Index* corner) noexcept {
+    const Index base = corner[0];
+    if (std::size_t{base} + 3 >= vertices.size() || corner[1] != base + 1 ||
+        corner[2] != base + 2 || corner[3] != base || corner[4] != base + 2 ||
+        corner[5] != base + 3) {
+        return {};
+    }
+    const UiVertex* quad = vertices.data() + base;
+    for (std::size_t i = 0; i < 4; ++i) {
+        if (quad[i].mode != static_cast<std::uint32_t>(DrawMode::Solid) ||
+            std::bit_cast<std::array<std::uint8_t, 4>>(quad[i].color)[3] != 255 ||
+            !isPixelEdge(quad[i].x) || !isPixelEdge(quad[i].y)) {
+            return {};
+        }
+    }
+    // Top-left, top-right, bottom-right, bottom-left, as appendRects() fixes the order.
+    if (quad[1].y != quad[0].y || quad[2].x != quad[1].x || quad[3].y != quad[2].y ||
+        quad[3].x != quad[0].x || quad[1].x <= quad[0].x || quad[3].y <= quad[0].y) {
+        return {};
+    }
+    const auto left = static_cast<Px>(quad[0].x);
+    const auto top = static_cast<Px>(quad[0].y);
+    return Rect{.x = left,
+                .y = top,
+                .width = static_cast<Px>(quad[2].x) - left,
+                .height = static_cast<Px>(quad[2].y) - top};
+}
+
+}  // namespace
+
+Result<OcclusionGrid, DrawError> OcclusionGrid::create(std::span<Rect> tiles,
+                                                       mdux::core::Extent2D viewport,
+                                                       Px tileSize) noexcept {
+    const std::size_t needed = occlusionTileCount(viewport, tileSize);
+    if (needed == 0) {
+        return err(DrawError::EmptyBudget);
+    }
+    if (tiles.size() < needed) {
+        return err(DrawError::StorageTooSmall);
+    }
+
+    OcclusionGrid grid;
+    grid.tiles_ = tiles.first(needed);
+    grid.viewport_ = viewport;
+    grid.tileSize_ = tileSize;
+    grid.columns_ = (viewport.width - 1) / tileSize + 1;
+    grid.rows_ = (viewport.height - 1) / tileSize + 1;
+    grid.clear();
+    return grid;
+}
+
+void OcclusionGrid::clear() noexcept {
+    std::ranges::fill(tiles_, Rect{});
+}
+
+std::size_t OcclusionGrid::tileAt(Px x, Px y) const noexcept {
+    // Clamped, so geometry partly off-screen still lands in an edge tile. Clamping is monotonic,
+    // which is what keeps the lookup sound: a point inside an occluder lands in a tile inside the
+    // occluder's clamped range, and the occluder was offered to every tile in that range.
+    const Px column = std::clamp(x, Px{0}, viewport_.width - 1) / tileSize_;
+    const Px row = std::clamp(y, Px{0}, viewport_.height - 1) / tileSize_;
+    return static_cast<std::size_t>(row) * static_cast<std::size_t>(columns_) +
+           static_cast<std::size_t>(column);
+}
+
+void OcclusionGrid::insert(const Rect& occluder) noexcept {
+    const std::size_t first = tileAt(occluder.x, occluder.y);
+    const std::size_t last = tileAt(occluder.right() - 1, occluder.bottom() - 1);
+    const auto columns = static_cast<std::size_t>(columns_);
+    for (std::size_t row = first / columns; row <= last / columns; ++row) {
+        for (std::size_t column = first % columns; column <= last % columns; ++column) {
+            const Rect tile{.x = static_cast<Px>(column) * tileSize_,
+                            .y = static_cast<Px>(row) * tileSize_,
+                            .width = tileSize_,
+                            .height = tileSize_};
+            Rect& kept = tiles_[row * columns + column];
+            if (areaOf(intersect(occluder, tile)) > areaOf(intersect(kept, tile))) {
+                kept = occluder;
+            }
+        }
+    }
+}
+
+bool OcclusionGrid::covers(const Rect& area) const noexcept {
+    const Rect& occluder = tiles_[tileAt(area.x, area.y)];
+    return !isEmpty(occluder) && occluder.x <= area.x && occluder.y <= area.y &&
+           occluder.right() >= area.right() && occluder.bottom() >= area.bottom();
+}
+
+std::uint32_t DrawList::cullOccluded(OcclusionGrid& grid) noexcept {
+    grid.clear();
+    Index* const indices = indices_.data();
+
+    // Backwards, so the grid only ever holds what is drawn after the triangle being tested. A
+    // rectangle's own two triangles are tested before it is offered, never against themselves.
+    for (std::uint32_t at = commandCount_; at-- > 0;) {
+        const DrawCommand& command = commands_[at];
+        if (command.segment != nullptr) {
+            continue;
+        }
+        const std::span<const UiVertex> batch = vertices().subspan(command.vertexOffset);
+        const std::uint32_t triangles = command.indexCount / 3;
+        for (std::uint32_t triangle = triangles; triangle-- > 0;) {
+            Index* const corner = indices + command.firstIndex + triangle * 3;
+            const Rect painted =
+                clipTo(geometryBounds(batch, std::span<const Index>{corner, 3}),
+                       command.clip);
+            if (isEmpty(painted) || grid.covers(painted)) {
+                markCulled(corner);
+                continue;
+            }
+            if (triangle + 1 < triangles) {
+                const Rect occluder = clipTo(opaqueRect(batch, corner), command.clip);
+                if (!isEmpty(occluder)) {
+                    grid.insert(occluder);
+                }
+            }
+        }
+    }
+
+    // Forwards, closing the gaps. The list's own commands own consecutive index ranges in
+    // command order, so the write position never passes the read position.
+    std::uint32_t written = 0;
+    std::uint32_t keptCommands = 0;
+    for (std::uint32_t at = 0; at < commandCount_; ++at) {
+        DrawCommand command = commands_[at];
+        if (command.segment == nullptr) {
+            const std::uint32_t first = written;
+            const std::uint32_t end = command.firstIndex + command.indexCount;
+            for (std::uint32_t read = command.firstIndex; read < end; read += 3) {
+                if (isCulled(indices + read)) {
+                    continue;
+                }
+                std::copy_n(indices + read, 3, indices + written);
+                written += 3;
+            }
+            command.firstIndex = first;
+            command.indexCount = written - first;
+            if (command.indexCount == 0) {
+                continue;
+            }
+        }
+        commands_[keptCommands] = command;
+        ++keptCommands;
+    }
+
+    const std::uint32_t culled = (indexCount_ - written) / 3;
+    indexCount_ = written;
+    commandCount_ = keptCommands;
+    if (culled != 0) {
+        rehash();
+    }
+    return culled;
+}
+
+}  // namespace mdux::draw
@@ -0,0 +1,279 @@
+/**
+ * @brief Implementation of polyline tessellation and trace decimation for mdux.draw.
+ *
+ * @compliance ADR-004 Trust zones in C++
+ * @compliance ADR-005 Error handling and exceptions policy
+ *
+ * A second implementation unit of `mdux.draw`, as `src/governance/` splits its module, because
+ * this is the only geometry in the module that is not an axis-aligned rectangle and it is long.
+ *
+ * The cost walk and the writing walk make the same decisions from the same arithmetic, in the
+ * same order, so the vertices written are exactly the vertices charged. Nothing here allocates,
+ * throws, or recurses.
+ */
+module;
+
+module mdux.draw;
+
+import std;
+import mdux.core.result;
+import mdux.core.units;
+
+namespace mdux::draw {
+
+using mdux::core::err;
+using mdux::core::Result;
+using mdux::core::ResultVoid;
+
+namespace {
+
+[[nodiscard]] bool isFinite(const Point2F& point) noexcept {
+    return std::isfinite(point.x) && std::isfinite(point.y);
+}
+
+/// The first point after `index` that differs from it, or `points.size()`. A repeated sample
+/// has no direction, and a segment of zero length has no normal to offset along.
+[[nodiscard]] std::size_t nextDistinct(std::span<const Point2F> points,
+                                       std::size_t index) noexcept {
+    std::size_t next = index + 1;
+    while (next < points.size() && points[next] == points[index]) {
+        ++next;
+    }
+    return next;
+}
+
+/// The unit direction from `from` to `to`, which must differ.
+[[nodiscard]] Point2F direction(const Point2F& from, const Point2F& to) noexcept {
+    const float dx = to.x - from.x;
+    const float dy = to.y - from.y;
+    const float length = std::hypot(dx, dy);
+    return Point2F{.x = dx / length, .y = dy / length};
+}
+
+/// The left-hand normal of a unit direction, scaled by `halfWidth`.
+[[nodiscard]] constexpr Point2F offset(const Point2F& unit, float halfWidth) noexcept {
+    return Point2F{.x = -unit.y * halfWidth, .y = unit.x * halfWidth};
+}
+
+/// Whether the join between unit directions `in` and `out` is drawn as a bevel.
+[[nodiscard]] bool bevels(const Point2F& in, const Point2F& out,
+                          const PolylineStyle& style) noexcept {
+    if (style.join == JoinStyle::Bevel) {
+        return true;
+    }
+    // The miter reaches halfWidth / cos(theta / 2) from the point, theta being the turn, and
+    // cos^2(theta / 2) = (1 + in.out) / 2. Compared squared, so no square root decides it.
+    // A reversal has no miter at all, whatever the limit, and is tested first so an infinite
+    // limit cannot turn 0 * inf into a NaN that compares as "fits".
+    const float cosSquared = (1.0F + (in.x * out.x) + (in.y * out.y)) * 0.5F;
+    return cosSquared <= 0.0F || cosSquared * style.miterLimit * style.miterLimit < 1.0F;
+}
+
+[[nodiscard]] bool validStyle(const PolylineStyle& style) noexcept {
+    // A miter is never shorter than half the width, so a limit under 1 would bevel every join
+    // while the style still says Miter. Written so that a NaN limit fails it too.
+    return std::isfinite(style.width) && style.width > 0.0F && style.miterLimit >= 1.0F;
+}
+
+}  // namespace
+
+Result<PrimitiveCost, DrawError> polylineCost(std::span<const Point2F> points,
+                                              const PolylineStyle& style) noexcept {
+    if (points.empty() || !validStyle(style) || !std::ranges::all_of(points, isFinite)) {
+        return err(DrawError::InvalidPolyline);
+    }
+    std::size_t previous = 0;
+    std::size_t current = nextDistinct(points, previous);
+    if (current == points.size()) {
+        return err(DrawError::InvalidPolyline);
+    }
+
+    std::size_t distinct = 2;
+    std::size_t bevelled = 0;
+    for (std::size_t next = nextDistinct(points, current); next < points.size();
+         next = nextDistinct(points, current)) {
+        if (bevels(direction(points[previous], points[current]),
+                   direction(points[current], points[next]), style)) {
+            ++bevelled;
+        }
+        ++distinct;
+        previous = current;
+        current = next;
+    }
+    return PrimitiveCost{.vertices = 2 * (distinct + bevelled),
+                         .indices = 6 * (distinct - 1) + 6 * bevelled};
+}
+
+ResultVoid<DrawError> DrawList::addPolyline(std::span<const Point2F> points,
+                                            const PolylineStyle& style,
+                                            mdux::core::ColorRgba8 color) noexcept {
+    const auto cost = polylineCost(points, style);
+    if (!cost.has_value()) {
+        return err(cost.error());
+    }
+    // Subtraction against remaining capacity, as for every other primitive.
+    if (budget_.maxVertices - vertexCount_ < cost->vertices) {
+        return err(DrawError::VertexBudgetExceeded);
+    }
+    if (budget_.maxIndices - indexCount_ < cost->indices) {
+        return err(DrawError::IndexBudgetExceeded);
+    }
+    // Its indices all count from one base, so a polyline is never split across batches: one
+    // longer than a batch is refused, and one that would cross the current batch starts a new one.
+    if (cost->vertices > maxIndexableVertices) {
+        return err(DrawError::BudgetExceedsIndexWidth);
+    }
+    const bool newBatch = crossesBatch(cost->vertices);
+    const bool startCommand = newBatch || needsCommand();
+    if (startCommand && commandCount_ == budget_.maxCommands) {
+        return err(DrawError::CommandBudgetExceeded);
+    }
+
+    // Past this point nothing can fail. Each pair is written left of the line then right of it,
+    // and each quad between two pairs is the same two triangles addRect() uses for its corners.
+    if (newBatch) {
+        batchBase_ = vertexCount_;
+    }
+    const std::uint32_t packed = packColor(color);
+    const auto solid = static_cast<std::uint32_t>(DrawMode::Solid);
+    const float halfWidth = style.width * 0.5F;
+    UiVertex* vertex = vertices_.data() + vertexCount_;
+    Index* index = indices_.data() + indexCount_;
+    auto next = static_cast<Index>(vertexCount_ - batchBase_);
+
+    const auto writePair = [&](const Point2F& at, const Point2F& side) noexcept {
+        vertex[0] = UiVertex{.x = at.x + side.x, .y = at.y + side.y, .u = 0.0F, .v = 0.0F,
+                             .color = packed, .mode = solid};
+        vertex[1] = UiVertex{.x = at.x - side.x, .y = at.y - side.y, .u = 0.0F, .v = 0.0F,
+                             .color = packed, .mode = solid};
+        vertex += 2;
+        const Index left = next;
+        next = static_cast<Index>(next + 2);
+        return left;
+    };
+    // From pair `from` to pair `to`, each a left index followed by its right: left, right,
+    // right', left' is the quad's perimeter.
+    const auto writeQuad = [&](Index from, Index to) noexcept {
+        index[0] = from;
+        index[1] = static_cast<Index>(from + 1);
+        index[2] = static_cast<Index>(to + 1);
+        index[3] = from;
+        index[4] = static_cast<Index>(to + 1);
+        index[5] = to;
+        index += 6;
+    };
+    // A bevel bridges the incoming pair to the outgoing one. Their four points lie on one circle
+    // about the join with each pair a diameter, so the quad's diagonal is the incoming pair and
+    // its perimeter alternates between the two.
+    const auto writeBridge = [&](Index in, Index out) noexcept {
+        index[0] = in;
+        index[1] = out;
+        index[2] = static_cast<Index>(in + 1);
+        index[3] = in;
+        index[4] = static_cast<Index>(in + 1);
+        index[5] = static_cast<Index>(out + 1);
+        index += 6;
+    };
+
+    std::size_t previous = 0;
+    std::size_t current = nextDistinct(points, previous);
+    Point2F incoming = direction(points[previous], points[current]);
+    Index last = writePair(points[previous], offset(incoming, halfWidth));
+    for (std::size_t following = nextDistinct(points, current); following < points.size();
+         following = nextDistinct(points, current)) {
+        const Point2F outgoing = direction(points[current], points[following]);
+        if (bevels(incoming, outgoing, style)) {
+            const Index in = writePair(points[current], offset(incoming, halfWidth));
+            writeQuad(last, in);
+            last = writePair(points[current], offset(outgoing, halfWidth));
+            writeBridge(in, last);
+        } else {
+            // The miter point: the sum of the two normals, lengthened so its projection onto
+            // either is the half width. `bevels()` has bounded 1 + in.out away from zero.
+            const Point2F sum = offset(Point2F{.x = incoming.x + outgoing.x,
+                                               .y = incoming.y + outgoing.y},
+                                       1.0F);
+            const float scale =
+                halfWidth / (1.0F + (incoming.x * outgoing.x) + (incoming.y * outgoing.y));
+            const Index joint =
+                writePair(points[current], Point2F{.x = sum.x * scale, .y = sum.y * scale});
+            writeQuad(last, joint);
+            last = joint;
+        }
+        incoming = outgoing;
+        previous = current;
+        current = following;
+    }
+    writeQuad(last, writePair(points[current], offset(incoming, halfWidth)));
+
+    const auto vertexCount = static_cast<std::uint32_t>(cost->vertices);
+    const auto indexCount = static_cast<std::uint32_t>(cost->indices);
+    chargeCommand(startCommand, indexCount);
+    hashAppended(vertexCount, indexCount);
+    vertexCount_ += vertexCount;
+    indexCount_ += indexCount;
+    return {};
+}
+
+Result<std::span<const Point2F>, DrawError> tracePoints(std::span<const float> samples,
+                                                        const mdux::core::Rect& area,
+                                                        float minValue, float maxValue,
+                                                        std::span<Point2F> out) noexcept {
+    if (area.width <= 0 || area.height <= 0) {
+        return err(DrawError::DegenerateRect);
+    }
+    if (!std::isfinite(minValue) || !std::isfinite(maxValue) || !(minValue < maxValue)) {
+        return err(DrawError::InvalidPolyline);
+    }
+    if (out.size() < maxTracePoints(samples.size(), area.width)) {
+        return err(DrawError::StorageTooSmall);
+    }
+
+    // Pixel centres, so a one-pixel line along the top or bottom row is not half outside it.
+    const float left = static_cast<float>(area.x) + 0.5F;
+    const float top = static_cast<float>(area.y) + 0.5F;
+    const float rows = static_cast<float>(area.height - 1);
+    const float span = maxValue - minValue;
+    const auto rowOf = [&](float value) noexcept {
+        return top + ((maxValue - std::clamp(value, minValue, maxValue)) / span) * rows;
+    };
+
+    const auto columns = static_cast<std::size_t>(area.width);
+    std::size_t written = 0;
+    if (samples.size() <= columns) {
+        const float step = samples.size() > 1 ? static_cast<float>(columns - 1) /
+                                                    static_cast<float>(samples.size() - 1)
+                                              : 0.0F;
+        for (std::size_t i = 0; i < samples.size(); ++i) {
+            out[written++] = Point2F{.x = left + (static_cast<float>(i) * step),
+                                     .y = rowOf(samples[i])};
+        }
+        return std::span<const Point2F>{out.first(written)};
+    }
+
+    for (std::size_t column = 0; column < columns; ++column) {
+        // Integer bounds, so every sample lands in exactly one column and none is skipped.
+        const std::size_t begin = column * samples.size() / columns;
+        const std::size_t end = (column + 1) * samples.size() / columns;
+        std::size_t low = begin;
+        std::size_t high = begin;
+        for (std::size_t i = begin + 1; i < end; ++i) {
+            if (samples[i] < samples[low]) {
+                low = i;
+            }
+            if (samples[i] > samples[high]) {
+                high = i;
+            }
+        }
+        const float x = left + static_cast<float>(column);
+        const std::size_t first = std::min(low, high);
+        const std::size_t second = std::max(low, high);
+        out[written++] = Point2F{.x = x, .y = rowOf(samples[first])};
+        if (samples[second] != samples[first]) {
+            out[written++] = Point2F{.x = x, .y = rowOf(samples[second])};
+        }
+    }
+    return std::span<const Point2F>{out.first(written)};
+}
+
+}  // namespace mdux::draw
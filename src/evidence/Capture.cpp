@@ -0,0 +1,333 @@
+/**
+ * @file Capture.cpp
+ * @brief Lossless frame encoding for the governed evidence zone.
+ *
+ * @compliance ADR-004 Trust zones in C++
+ * @compliance ADR-005 Error handling and exceptions policy
+ * @compliance ADR-007 Evidence pipeline doctrine
+ *
+ * The encoder and decoder keep the same state - the previous residual and the 64-entry index -
+ * and update it at the same points, so the decoder always knows what the encoder knew when it
+ * chose an operation. Both are one pass over the pixels; nothing allocates, throws, or recurses.
+ */
+module;
+
+module mdux.evidence.capture;
+
+import std;
+import mdux.core.result;
+import mdux.core.units;
+
+namespace mdux::evidence {
+
+using mdux::core::ColorRgba8;
+using mdux::core::err;
+using mdux::core::Extent2D;
+using mdux::core::Result;
+using mdux::core::ResultVoid;
+
+namespace {
+
+constexpr std::array<std::byte, 4> frameTag{std::byte{'M'}, std::byte{'D'}, std::byte{'X'},
+                                            std::byte{'F'}};
+constexpr std::uint8_t formatVersion = 1;
+constexpr std::uint8_t deltaFlag = 0x01;
+
+// The operations, as QOI defines them. The two-bit tags share the top bits with the two full
+// 8-bit tags, which are the run lengths 63 and 64 a run never uses.
+constexpr std::uint8_t opIndex = 0x00;
+constexpr std::uint8_t opDiff = 0x40;
+constexpr std::uint8_t opLuma = 0x80;
+constexpr std::uint8_t opRun = 0xC0;
+constexpr std::uint8_t opRgb = 0xFE;
+constexpr std::uint8_t opRgba = 0xFF;
+constexpr std::uint8_t tagMask = 0xC0;
+constexpr std::uint32_t maxRun = 62;
+
+/// The residuals a stream starts from. A delta frame starts at "unchanged", so an unchanged
+/// first pixel is already a run; a key frame at opaque black, the usual clear colour.
+constexpr ColorRgba8 deltaStart{.r = 0, .g = 0, .b = 0, .a = 0};
+constexpr ColorRgba8 keyStart{.r = 0, .g = 0, .b = 0, .a = 255};
+
+/// The index both sides start from: every entry zero, as QOI's is. Spelled out, because a
+/// value-initialised `ColorRgba8` is opaque black, not zero.
+[[nodiscard]] constexpr std::array<ColorRgba8, 64> emptyIndex() noexcept {
+    std::array<ColorRgba8, 64> index{};
+    index.fill(ColorRgba8{.r = 0, .g = 0, .b = 0, .a = 0});
+    return index;
+}
+
+[[nodiscard]] constexpr std::size_t indexOf(const ColorRgba8& pixel) noexcept {
+    return (std::size_t{pixel.r} * 3 + std::size_t{pixel.g} * 5 + std::size_t{pixel.b} * 7 +
+            std::size_t{pixel.a} * 11) %
+           64;
+}
+
+/// `a - b` per channel, mod 256; `plus` undoes it.
+[[nodiscard]] constexpr ColorRgba8 minus(const ColorRgba8& a, const ColorRgba8& b) noexcept {
+    return ColorRgba8{.r = static_cast<std::uint8_t>(a.r - b.r),
+                      .g = static_cast<std::uint8_t>(a.g - b.g),
+                      .b = static_cast<std::uint8_t>(a.b - b.b),
+                      .a = static_cast<std::uint8_t>(a.a - b.a)};
+}
+
+[[nodiscard]] constexpr ColorRgba8 plus(const ColorRgba8& a, const ColorRgba8& b) noexcept {
+    return ColorRgba8{.r = static_cast<std::uint8_t>(a.r + b.r),
+                      .g = static_cast<std::uint8_t>(a.g + b.g),
+                      .b = static_cast<std::uint8_t>(a.b + b.b),
+                      .a = static_cast<std::uint8_t>(a.a + b.a)};
+}
+
+/// The difference of two bytes as the signed value nearest zero, -128..127.
+[[nodiscard]] constexpr int wrapped(std::uint8_t now, std::uint8_t before) noexcept {
+    return static_cast<std::int8_t>(static_cast<std::uint8_t>(now - before));
+}
+
+void putU32(std::byte* at, std::uint32_t value) noexcept {
+    for (std::size_t i = 0; i < 4; ++i) {
+        at[i] = static_cast<std::byte>((value >> (8 * i)) & 0xFFu);
+    }
+}
+
+[[nodiscard]] std::uint32_t getU32(const std::byte* at) noexcept {
+    std::uint32_t value = 0;
+    for (std::size_t i = 0; i < 4; ++i) {
+        value |= std::to_integer<std::uint32_t>(at[i]) << (8 * i);
+    }
+    return value;
+}
+
+[[nodiscard]] std::size_t pixelCount(const Extent2D& extent) noexcept {
+    return static_cast<std::size_t>(extent.width) * static_cast<std::size_t>(extent.height);
+}
+
+}  // namespace
+
+std::string_view describe(CaptureError error) noexcept {
+    switch (error) {
+    case CaptureError::EmptyExtent: return "frame extent has zero width or height";
+    case CaptureError::ExtentTooLarge:
+        return "frame extent's worst-case encoding does not fit in memory";
+    case CaptureError::PixelCountMismatch: return "pixel span is not width * height long";
+    case CaptureError::PreviousFrameMismatch:
+        return "previous frame is not width * height long";
+    case CaptureError::MissingPreviousFrame:
+        return "delta frame decoded without the frame it was encoded against";
+    case CaptureError::StorageTooSmall:
+        return "output storage is smaller than the frame's worst-case encoding";
+    case CaptureError::NotAFrame: return "bytes do not begin with a frame header";
+    case CaptureError::UnsupportedVersion: return "frame format version is not supported";
+    case CaptureError::TruncatedFrame: return "frame ends before its last pixel";
+    case CaptureError::TrailingBytes: return "frame continues past its last pixel";
+    }
+    return "unknown capture error";
+}
+
+Result<std::span<const std::byte>, CaptureError> encodeFrame(
+    Extent2D extent, std::span<const ColorRgba8> pixels, std::span<const ColorRgba8> previous,
+    std::span<std::byte> out) noexcept {
+    if (extent.width <= 0 || extent.height <= 0) {
+        return err(CaptureError::EmptyExtent);
+    }
+    const std::size_t worstCase = maxEncodedFrameBytes(extent);
+    if (worstCase == 0) {
+        return err(CaptureError::ExtentTooLarge);
+    }
+    const std::size_t count = pixelCount(extent);
+    if (pixels.size() != count) {
+        return err(CaptureError::PixelCountMismatch);
+    }
+    const bool delta = !previous.empty();
+    if (delta && previous.size() != count) {
+        return err(CaptureError::PreviousFrameMismatch);
+    }
+    // The worst case, not the likely one: checked once here, so no write below needs a bound.
+    if (out.size() < worstCase) {
+        return err(CaptureError::StorageTooSmall);
+    }
+
+    std::byte* const begin = out.data();
+    std::copy(frameTag.begin(), frameTag.end(), begin);
+    begin[4] = std::byte{formatVersion};
+    begin[5] = std::byte{delta ? deltaFlag : std::uint8_t{0}};
+    begin[6] = std::byte{0};
+    begin[7] = std::byte{0};
+    putU32(begin + 8, static_cast<std::uint32_t>(extent.width));
+    putU32(begin + 12, static_cast<std::uint32_t>(extent.height));
+    std::byte* at = begin + frameHeaderBytes;
+    const auto put = [&at](std::uint8_t value) noexcept { *at++ = std::byte{value}; };
+
+    std::array<ColorRgba8, 64> seen = emptyIndex();
+    ColorRgba8 last = delta ? deltaStart : keyStart;
+    std::uint32_t run = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const ColorRgba8 residual = delta ? minus(pixels[i], previous[i]) : pixels[i];
+        if (residual == last) {
+            ++run;
+            if (run == maxRun) {
+                put(static_cast<std::uint8_t>(opRun | (run - 1)));
+                run = 0;
+            }
+            continue;
+        }
+        if (run > 0) {
+            put(static_cast<std::uint8_t>(opRun | (run - 1)));
+            run = 0;
+        }
+
+        const std::size_t slot = indexOf(residual);
+        if (seen[slot] == residual) {
+            put(static_cast<std::uint8_t>(opIndex | slot));
+        } else {
+            seen[slot] = residual;
+            if (residual.a != last.a) {
+                put(opRgba);
+                put(residual.r);
+                put(residual.g);
+                put(residual.b);
+                put(residual.a);
+            } else {
+                const int dr = wrapped(residual.r, last.r);
+                const int dg = wrapped(residual.g, last.g);
+                const int db = wrapped(residual.b, last.b);
+                const int drg = dr - dg;
+                const int dbg = db - dg;
+                if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                    put(static_cast<std::uint8_t>(opDiff | ((dr + 2) << 4) | ((dg + 2) << 2) |
+                                                  (db + 2)));
+                } else if (dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 && dbg >= -8 &&
+                           dbg <= 7) {
+                    put(static_cast<std::uint8_t>(opLuma | (dg + 32)));
+                    put(static_cast<std::uint8_t>(((drg + 8) << 4) | (dbg + 8)));
+                } else {
+                    put(opRgb);
+                    put(residual.r);
+                    put(residual.g);
+                    put(residual.b);
+                }
+            }
+        }
+        last = residual;
+    }
+    if (run > 0) {
+        put(static_cast<std::uint8_t>(opRun | (run - 1)));
+    }
+    return std::span<const std::byte>{begin, static_cast<std::size_t>(at - begin)};
+}
+
+Result<FrameInfo, CaptureError> readFrameInfo(std::span<const std::byte> encoded) noexcept {
+    if (encoded.size() < frameHeaderBytes ||
+        !std::equal(frameTag.begin(), frameTag.end(), encoded.begin())) {
+        return err(CaptureError::NotAFrame);
+    }
+    if (std::to_integer<std::uint8_t>(encoded[4]) != formatVersion) {
+        return err(CaptureError::UnsupportedVersion);
+    }
+    const auto flags = std::to_integer<std::uint8_t>(encoded[5]);
+    // Unknown flags and reserved bytes are refused rather than ignored: a later version that
+    // sets one means something this decoder would silently get wrong.
+    if ((flags & ~deltaFlag) != 0 || encoded[6] != std::byte{0} || encoded[7] != std::byte{0}) {
+        return err(CaptureError::NotAFrame);
+    }
+    const std::uint32_t width = getU32(encoded.data() + 8);
+    const std::uint32_t height = getU32(encoded.data() + 12);
+    if (width == 0 || height == 0) {
+        return err(CaptureError::EmptyExtent);
+    }
+    constexpr auto maxPx = static_cast<std::uint32_t>(std::numeric_limits<mdux::core::Px>::max());
+    const Extent2D extent{.width = static_cast<mdux::core::Px>(width),
+                          .height = static_cast<mdux::core::Px>(height)};
+    if (width > maxPx || height > maxPx || maxEncodedFrameBytes(extent) == 0) {
+        return err(CaptureError::ExtentTooLarge);
+    }
+    return FrameInfo{.extent = extent, .delta = (flags & deltaFlag) != 0};
+}
+
+ResultVoid<CaptureError> decodeFrame(std::span<const std::byte> encoded,
+                                     std::span<const ColorRgba8> previous,
+                                     std::span<ColorRgba8> out) noexcept {
+    const auto info = readFrameInfo(encoded);
+    if (!info.has_value()) {
+        return err(info.error());
+    }
+    const std::size_t count = pixelCount(info->extent);
+    if (out.size() != count) {
+        return err(CaptureError::PixelCountMismatch);
+    }
+    if (info->delta && previous.empty()) {
+        return err(CaptureError::MissingPreviousFrame);
+    }
+    if (info->delta && previous.size() != count) {
+        return err(CaptureError::PreviousFrameMismatch);
+    }
+
+    const std::span<const std::byte> ops = encoded.subspan(frameHeaderBytes);
+    std::size_t read = 0;
+    const auto take = [&ops, &read]() noexcept {
+        return std::to_integer<std::uint8_t>(ops[read++]);
+    };
+
+    std::array<ColorRgba8, 64> seen = emptyIndex();
+    ColorRgba8 last = info->delta ? deltaStart : keyStart;
+    std::size_t i = 0;
+    while (i < count) {
+        if (read == ops.size()) {
+            return err(CaptureError::TruncatedFrame);
+        }
+        const std::uint8_t op = take();
+        // Every operation but a run or an index carries bytes after its tag; each is checked
+        // before it is read, so a truncated stream is an error and never an out-of-bounds read.
+        const std::size_t left = ops.size() - read;
+        std::size_t pixelsOut = 1;
+        if (op == opRgb) {
+            if (left < 3) {
+                return err(CaptureError::TruncatedFrame);
+            }
+            last.r = take();
+            last.g = take();
+            last.b = take();
+            seen[indexOf(last)] = last;
+        } else if (op == opRgba) {
+            if (left < 4) {
+                return err(CaptureError::TruncatedFrame);
+            }
+            last.r = take();
+            last.g = take();
+            last.b = take();
+            last.a = take();
+            seen[indexOf(last)] = last;
+        } else if ((op & tagMask) == opIndex) {
+            last = seen[op & 0x3F];
+        } else if ((op & tagMask) == opDiff) {
+            last.r = static_cast<std::uint8_t>(last.r + ((op >> 4) & 0x03) - 2);
+            last.g = static_cast<std::uint8_t>(last.g + ((op >> 2) & 0x03) - 2);
+            last.b = static_cast<std::uint8_t>(last.b + (op & 0x03) - 2);
+            seen[indexOf(last)] = last;
+        } else if ((op & tagMask) == opLuma) {
+            if (left < 1) {
+                return err(CaptureError::TruncatedFrame);
+            }
+            const std::uint8_t second = take();
+            const int dg = (op & 0x3F) - 32;
+            last.r = static_cast<std::uint8_t>(last.r + dg + ((second >> 4) & 0x0F) - 8);
+            last.g = static_cast<std::uint8_t>(last.g + dg);
+            last.b = static_cast<std::uint8_t>(last.b + dg + (second & 0x0F) - 8);
+            seen[indexOf(last)] = last;
+        } else {
+            pixelsOut = std::size_t{op & 0x3Fu} + 1;
+        }
+        // A run may not reach past the frame: the encoder never writes one that does.
+        if (pixelsOut > count - i) {
+            return err(CaptureError::TrailingBytes);
+        }
+        for (const std::size_t end = i + pixelsOut; i < end; ++i) {
+            out[i] = info->delta ? plus(previous[i], last) : last;
+        }
+    }
+    if (read != ops.size()) {
+        return err(CaptureError::TrailingBytes);
+    }
+    return {};
+}
+
+}  // namespace mdux::evidence
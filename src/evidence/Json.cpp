@@ -30,62 +30,176 @@ namespace {
     return Error{.code = code, .offset = offset, .detail = std::move(detail)};
 }
 
+// ---------------------------------------------------------------------------
+// Word-at-a-time scanning
+// ---------------------------------------------------------------------------
+//
+// A canonical artifact is overwhelmingly ASCII: keys, digests, identifiers and indentation. The
+// byte loops below are the specification; these helpers let the default scanner test eight bytes
+// per step for "anything here that needs the byte loop?" and hand over only when the answer is
+// yes. Portable 64-bit arithmetic rather than platform intrinsics, because this is governed code
+// that builds for every target the project does and must not grow a per-ISA path whose
+// correctness nobody on the other ISA can check.
+//
+// Every byte predicate here is exact. The familiar `(x - 0x01..) & ~x & 0x80..` zero-byte trick
+// can flag a byte above a real match through a borrow, which is harmless when only "is there a
+// match" is asked but wrong when the answer is used as an offset - and an offset is exactly what
+// an error report carries. Masking each byte to seven bits before adding keeps every sum inside
+// its own byte, so a flag means that byte and no other.
+
+constexpr std::uint64_t lowBytes = 0x0101010101010101u;
+constexpr std::uint64_t highBits = 0x8080808080808080u;
+constexpr std::uint64_t lowSevenBits = 0x7f7f7f7f7f7f7f7fu;
+constexpr std::size_t wordBytes = 8;
+
+/// The eight bytes at `text[offset]`, first byte least significant. Assembled with shifts
+/// rather than memcpy, as in Digest.cpp, so the byte order is the algorithm's and a flagged bit
+/// maps to the same offset on a big-endian target. Compilers fold this into one load.
+[[nodiscard]] std::uint64_t loadWord(std::string_view text, std::size_t offset) noexcept {
+    std::uint64_t word = 0;
+    for (std::size_t k = 0; k < wordBytes; ++k) {
+        word |= static_cast<std::uint64_t>(static_cast<unsigned char>(text[offset + k])) << (8 * k);
+    }
+    return word;
+}
+
+/// High bit set in each byte of `word` that is below `limit`. `limit` must be at most 0x80.
+[[nodiscard]] constexpr std::uint64_t bytesBelow(std::uint64_t word, std::uint8_t limit) noexcept {
+    const std::uint64_t atLeast = (word & lowSevenBits) + lowBytes * (0x80u - limit);
+    return ~(atLeast | word) & highBits;
+}
+
+/// High bit set in each byte of `word` equal to `value`.
+[[nodiscard]] constexpr std::uint64_t bytesEqual(std::uint64_t word, std::uint8_t value) noexcept {
+    const std::uint64_t difference = word ^ (lowBytes * value);
+    const std::uint64_t nonZero = (difference & lowSevenBits) + lowSevenBits;
+    return ~(nonZero | difference) & highBits;
+}
+
+/// The offset within a word of the first flagged byte. `flags` must be non-zero.
+[[nodiscard]] constexpr std::size_t firstFlagged(std::uint64_t flags) noexcept {
+    return static_cast<std::size_t>(std::countr_zero(flags)) / 8;
+}
+
+/// The first offset at or after `from` holding a byte a string body cannot copy verbatim - a
+/// quote, a backslash or a control character - or `text.size()` if there is none.
+[[nodiscard]] std::size_t findStringSpecial(std::string_view text, std::size_t from) noexcept {
+    std::size_t i = from;
+    while (i + wordBytes <= text.size()) {
+        const std::uint64_t word = loadWord(text, i);
+        const std::uint64_t flags =
+            bytesEqual(word, std::uint8_t{'"'}) | bytesEqual(word, std::uint8_t{'\\'}) |
+            bytesBelow(word, 0x20);
+        if (flags != 0) {
+            return i + firstFlagged(flags);
+        }
+        i += wordBytes;
+    }
+    while (i < text.size()) {
+        const auto byte = static_cast<unsigned char>(text[i]);
+        if (byte == '"' || byte == '\\' || byte < 0x20) {
+            return i;
+        }
+        ++i;
+    }
+    return text.size();
+}
+
 // ---------------------------------------------------------------------------
 // UTF-8 validation
 // ---------------------------------------------------------------------------
 
-/// Validates `text` as UTF-8, rejecting overlong encodings, surrogates and out-of-range code
-/// points - the three classes a naive length-driven decoder waves through. Returns the byte
-/// offset of the first invalid sequence, or npos if the whole string is well-formed.
+/// The length of the well-formed multi-byte sequence starting at `text[i]`, or 0 if it is
+/// malformed. Rejects overlong encodings, surrogates and out-of-range code points - the three
+/// classes a naive length-driven decoder waves through. `text[i]` must not be ASCII.
+[[nodiscard]] std::size_t multiByteSequenceLength(std::string_view text, std::size_t i) noexcept {
+    const auto byte0 = static_cast<unsigned char>(text[i]);
+    std::size_t length = 0;
+    std::uint32_t codePoint = 0;
+
+    if ((byte0 & 0xe0u) == 0xc0u) {
+        length = 2;
+        codePoint = byte0 & 0x1fu;
+    } else if ((byte0 & 0xf0u) == 0xe0u) {
+        length = 3;
+        codePoint = byte0 & 0x0fu;
+    } else if ((byte0 & 0xf8u) == 0xf0u) {
+        length = 4;
+        codePoint = byte0 & 0x07u;
+    } else {
+        return 0;  // continuation byte or 0xf8+ as a lead byte
+    }
+
+    if (i + length > text.size()) {
+        return 0;
+    }
+    for (std::size_t k = 1; k < length; ++k) {
+        const auto continuation = static_cast<unsigned char>(text[i + k]);
+        if ((continuation & 0xc0u) != 0x80u) {
+            return 0;
+        }
+        codePoint = (codePoint << 6) | (continuation & 0x3fu);
+    }
+
+    // Overlong: a code point encodable in fewer bytes than were used.
+    static constexpr std::array<std::uint32_t, 5> minimum{0, 0, 0x80, 0x800, 0x10000};
+    if (codePoint < minimum[length]) {
+        return 0;
+    }
+    // UTF-16 surrogate halves are not valid scalar values in UTF-8.
+    if (codePoint >= 0xd800 && codePoint <= 0xdfff) {
+        return 0;
+    }
+    if (codePoint > 0x10ffff) {
+        return 0;
+    }
+    return length;
+}
+
+/// Validates `text` as UTF-8 one byte at a time. Returns the byte offset of the first invalid
+/// sequence, or npos if the whole string is well-formed.
 ///
 /// This matters for byte-identity as much as for correctness: a writer that emits an invalid
 /// sequence produces a file whose bytes depend on whatever produced the bad input, and the
 /// promise is UTF-8 without a byte-order mark, not "whatever bytes were handed to us".
-[[nodiscard]] std::size_t findInvalidUtf8(std::string_view text) noexcept {
+///
+/// The reference implementation. findInvalidUtf8() must return exactly what this returns for
+/// every input, and the tests hold it to that through Scanner::Reference.
+[[nodiscard]] std::size_t findInvalidUtf8Reference(std::string_view text) noexcept {
     std::size_t i = 0;
     while (i < text.size()) {
-        const auto byte0 = static_cast<unsigned char>(text[i]);
-        std::size_t length = 0;
-        std::uint32_t codePoint = 0;
-
-        if (byte0 < 0x80) {
+        if (static_cast<unsigned char>(text[i]) < 0x80) {
             i += 1;
             continue;
         }
-        if ((byte0 & 0xe0u) == 0xc0u) {
-            length = 2;
-            codePoint = byte0 & 0x1fu;
-        } else if ((byte0 & 0xf0u) == 0xe0u) {
-            length = 3;
-            codePoint = byte0 & 0x0fu;
-        } else if ((byte0 & 0xf8u) == 0xf0u) {
-            length = 4;
-            codePoint = byte0 & 0x07u;
-        } else {
-            return i;  // continuation byte or 0xf8+ as a lead byte
-        }
-
-        if (i + length > text.size()) {
+        const std::size_t length = multiByteSequenceLength(text, i);
+        if (length == 0) {
             return i;
         }
-        for (std::size_t k = 1; k < length; ++k) {
-            const auto continuation = static_cast<unsigned char>(text[i + k]);
-            if ((continuation & 0xc0u) != 0x80u) {
-                return i;
-            }
-            codePoint = (codePoint << 6) | (continuation & 0x3fu);
-        }
+        i += length;
+    }
+    return std::string_view::npos;
+}
 
-        // Overlong: a code point encodable in fewer bytes than were used.
-        static constexpr std::array<std::uint32_t, 5> minimum{0, 0, 0x80, 0x800, 0x10000};
-        if (codePoint < minimum[length]) {
-            return i;
+/// findInvalidUtf8Reference(), skipping ASCII a word at a time. A word with no high bit set is
+/// eight one-byte sequences the reference would have accepted individually; anything else drops
+/// to the reference's per-sequence check, so the two differ only in how fast they reach the
+/// same answer.
+[[nodiscard]] std::size_t findInvalidUtf8(std::string_view text) noexcept {
+    std::size_t i = 0;
+    while (i < text.size()) {
+        while (i + wordBytes <= text.size() && (loadWord(text, i) & highBits) == 0) {
+            i += wordBytes;
         }
-        // UTF-16 surrogate halves are not valid scalar values in UTF-8.
-        if (codePoint >= 0xd800 && codePoint <= 0xdfff) {
-            return i;
+        if (i >= text.size()) {
+            break;
         }
-        if (codePoint > 0x10ffff) {
+        if (static_cast<unsigned char>(text[i]) < 0x80) {
+            i += 1;
+            continue;
+        }
+        const std::size_t length = multiByteSequenceLength(text, i);
+        if (length == 0) {
             return i;
         }
         i += length;
@@ -305,11 +419,22 @@ ResultVoid<Error> writeValue(std::string& out, const Value& value, std::size_t d
 // Reader
 // ---------------------------------------------------------------------------
 
+/// Whether the parser builds the tree or only checks the text could produce one.
+enum class Tree : std::uint8_t {
+    Build,  ///< parse(): return the decoded Value
+    Check,  ///< parseLazy(): run every rule, keep only what the rules themselves need
+};
+
 /// Recursive-descent parser over a string_view. Holds no allocation of its own beyond the Values
 /// it builds, and every failure path produces an offset so a diagnostic can point at the byte.
+///
+/// `scanner` only decides how fast the byte-level checks get through runs of ordinary bytes,
+/// and `tree` only whether arrays and objects are assembled. The grammar, and therefore every
+/// accept, reject, code and offset, is shared by all four combinations.
 class Parser {
 public:
-    explicit Parser(std::string_view text) noexcept : text_{text} {}
+    Parser(std::string_view text, Scanner scanner, Tree tree) noexcept
+        : text_{text}, scanner_{scanner}, tree_{tree} {}
 
     [[nodiscard]] Result<Value, Error> run() noexcept {
         // A byte-order mark is valid UTF-8 and invisible in an editor, which makes it exactly
@@ -318,7 +443,9 @@ public:
             return err(makeError(ErrorCode::ByteOrderMarkRejected, 0,
                                   "input begins with a UTF-8 byte-order mark"));
         }
-        if (const std::size_t bad = findInvalidUtf8(text_); bad != std::string_view::npos) {
+        const std::size_t bad = scanner_ == Scanner::Reference ? findInvalidUtf8Reference(text_)
+                                                               : findInvalidUtf8(text_);
+        if (bad != std::string_view::npos) {
             return err(makeError(ErrorCode::InvalidUtf8, bad, "invalid UTF-8 sequence"));
         }
 
@@ -498,6 +625,15 @@ private:
         ++position_;
         std::string out;
         while (true) {
+            // Copy the run up to the next byte that needs a decision in one append. The byte
+            // loop below then sees exactly the byte it would have reached one push_back at a
+            // time, so the Reference scanner - which skips this - takes the same path to the
+            // same result.
+            if (scanner_ == Scanner::Wide) {
+                const std::size_t runEnd = findStringSpecial(text_, position_);
+                out.append(text_.substr(position_, runEnd - position_));
+                position_ = runEnd;
+            }
             if (atEnd()) {
                 return err(makeError(ErrorCode::UnexpectedEnd, position_,
                                       "string is not terminated"));
@@ -651,7 +787,9 @@ private:
             if (!element.has_value()) {
                 return element;
             }
-            elements.push_back(std::move(*element));
+            if (tree_ == Tree::Build) {
+                elements.push_back(std::move(*element));
+            }
 
             skipWhitespace();
             if (atEnd()) {
@@ -673,6 +811,9 @@ private:
     [[nodiscard]] Result<Value, Error> parseObject(std::size_t depth) noexcept {
         ++position_;  // consume '{'
         Value object = Value::emptyObject();
+        // Tree::Check keeps the keys alone, sorted, because duplicate detection is a rule and
+        // must fire at the same key whether or not the values are kept.
+        std::vector<std::string> checkedKeys;
         skipWhitespace();
         if (!atEnd() && peek() == '}') {
             ++position_;
@@ -704,14 +845,25 @@ private:
             if (!value.has_value()) {
                 return value;
             }
-            // set() rejects duplicates, which is where DuplicateKey comes from - but its error
-            // has no offset, so re-report with the offending key's position.
-            if (auto inserted = object.set(*key, std::move(*value)); !inserted.has_value()) {
-                if (inserted.error().code == ErrorCode::DuplicateKey) {
+            if (tree_ == Tree::Check) {
+                const auto slot = std::ranges::lower_bound(
+                    checkedKeys, std::string_view{*key}, {},
+                    [](const std::string& checked) { return std::string_view{checked}; });
+                if (slot != checkedKeys.end() && *slot == *key) {
                     return err(makeError(ErrorCode::DuplicateKey, keyOffset,
                                           "duplicate key '" + *key + "'"));
                 }
-                return err(inserted.error());
+                checkedKeys.insert(slot, std::move(*key));
+            } else {
+                // set() rejects duplicates, which is where DuplicateKey comes from - but its
+                // error has no offset, so re-report with the offending key's position.
+                if (auto inserted = object.set(*key, std::move(*value)); !inserted.has_value()) {
+                    if (inserted.error().code == ErrorCode::DuplicateKey) {
+                        return err(makeError(ErrorCode::DuplicateKey, keyOffset,
+                                              "duplicate key '" + *key + "'"));
+                    }
+                    return err(inserted.error());
+                }
             }
 
             skipWhitespace();
@@ -732,9 +884,82 @@ private:
     }
 
     std::string_view text_;
+    Scanner scanner_{Scanner::Wide};
+    Tree tree_{Tree::Build};
     std::size_t position_{0};
 };
 
+// ---------------------------------------------------------------------------
+// Navigation over validated text
+// ---------------------------------------------------------------------------
+//
+// Everything here runs only over text parseLazy() has accepted, so none of it re-checks the
+// grammar: a string is known to be terminated, brackets are known to balance, and a scalar is
+// known to end at a delimiter. Each helper is correct only under that precondition, which
+// LazyValue's private constructor is what guarantees.
+
+[[nodiscard]] std::size_t skipWhitespaceFrom(std::string_view text, std::size_t i) noexcept {
+    while (i < text.size() &&
+           (text[i] == ' ' || text[i] == '\t' || text[i] == '\n' || text[i] == '\r')) {
+        ++i;
+    }
+    return i;
+}
+
+/// The offset one past the closing quote of the string opening at `text[begin]`.
+[[nodiscard]] std::size_t stringEnd(std::string_view text, std::size_t begin) noexcept {
+    std::size_t i = begin + 1;
+    while (true) {
+        i = findStringSpecial(text, i);
+        if (text[i] == '"') {
+            return i + 1;
+        }
+        i += 2;  // a backslash and the byte it escapes; control bytes cannot occur here
+    }
+}
+
+/// The offset one past the value starting at `text[begin]`.
+[[nodiscard]] std::size_t valueEnd(std::string_view text, std::size_t begin) noexcept {
+    const char first = text[begin];
+    if (first == '"') {
+        return stringEnd(text, begin);
+    }
+    if (first == '{' || first == '[') {
+        std::size_t depth = 0;
+        std::size_t i = begin;
+        while (true) {
+            const char c = text[i];
+            if (c == '"') {
+                i = stringEnd(text, i);
+                continue;
+            }
+            if (c == '{' || c == '[') {
+                ++depth;
+            } else if ((c == '}' || c == ']') && --depth == 0) {
+                return i + 1;
+            }
+            ++i;
+        }
+    }
+    std::size_t i = begin;
+    while (i < text.size() && text[i] != ',' && text[i] != ']' && text[i] != '}' &&
+           text[i] != ' ' && text[i] != '\t' && text[i] != '\n' && text[i] != '\r') {
+        ++i;
+    }
+    return i;
+}
+
+/// Whether the key string `quoted`, quotes included, decodes to `key`. Compares the raw bytes
+/// when there is no escape to decode, which is every key the writer emits.
+[[nodiscard]] bool keyEquals(std::string_view quoted, std::string_view key) noexcept {
+    const std::string_view raw = quoted.substr(1, quoted.size() - 2);
+    if (raw.find('\\') == std::string_view::npos) {
+        return raw == key;
+    }
+    const auto decoded = parse(quoted);
+    return decoded.has_value() && decoded->asString().value_or(std::string_view{}) == key;
+}
+
 }  // namespace
 
 // ---------------------------------------------------------------------------
@@ -962,8 +1187,108 @@ Result<std::string, Error> write(const Value& value) noexcept {
 }
 
 Result<Value, Error> parse(std::string_view text) noexcept {
-    Parser parser{text};
+    return parse(text, Scanner::Wide);
+}
+
+Result<Value, Error> parse(std::string_view text, Scanner scanner) noexcept {
+    Parser parser{text, scanner, Tree::Build};
     return parser.run();
 }
 
+// ---------------------------------------------------------------------------
+// LazyValue / parseLazy()
+// ---------------------------------------------------------------------------
+
+Value::Kind LazyValue::kind() const noexcept {
+    switch (text_.front()) {
+    case '{': return Value::Kind::Object;
+    case '[': return Value::Kind::Array;
+    case '"': return Value::Kind::String;
+    case 't':
+    case 'f': return Value::Kind::Bool;
+    case 'n': return Value::Kind::Null;
+    case '-': return Value::Kind::Int;  // as parse() decides it: a sign means Int, none UInt
+    default:  return Value::Kind::UInt;
+    }
+}
+
+std::optional<LazyValue> LazyValue::find(std::string_view key) const noexcept {
+    if (kind() != Value::Kind::Object) {
+        return std::nullopt;
+    }
+    std::size_t i = skipWhitespaceFrom(text_, 1);
+    while (text_[i] != '}') {
+        const std::size_t keyEnd = stringEnd(text_, i);
+        const std::string_view quoted = text_.substr(i, keyEnd - i);
+        const std::size_t colon = skipWhitespaceFrom(text_, keyEnd);
+        const std::size_t valueBegin = skipWhitespaceFrom(text_, colon + 1);
+        const std::size_t end = valueEnd(text_, valueBegin);
+        if (keyEquals(quoted, key)) {
+            return LazyValue{text_.substr(valueBegin, end - valueBegin)};
+        }
+        i = skipWhitespaceFrom(text_, end);
+        if (text_[i] == ',') {
+            i = skipWhitespaceFrom(text_, i + 1);
+        }
+    }
+    return std::nullopt;
+}
+
+Result<LazyValue, Error> LazyValue::require(std::string_view key) const noexcept {
+    if (kind() != Value::Kind::Object) {
+        return err(makeError(ErrorCode::WrongKind, 0, "value is not an object"));
+    }
+    if (const auto found = find(key); found.has_value()) {
+        return *found;
+    }
+    return err(makeError(ErrorCode::MissingMember, 0,
+                          "object has no member '" + std::string{key} + "'"));
+}
+
+LazyElements LazyValue::elements() const noexcept {
+    return LazyElements{kind() == Value::Kind::Array ? text_ : std::string_view{}};
+}
+
+LazyElements::Iterator::Iterator(std::string_view array, std::size_t begin) noexcept
+    : array_{array},
+      begin_{begin},
+      end_{array[begin] == ']' ? begin : valueEnd(array, begin)} {}
+
+LazyValue LazyElements::Iterator::operator*() const noexcept {
+    return element(array_.substr(begin_, end_ - begin_));
+}
+
+LazyElements::Iterator& LazyElements::Iterator::operator++() noexcept {
+    std::size_t i = skipWhitespaceFrom(array_, end_);
+    if (array_[i] == ',') {
+        i = skipWhitespaceFrom(array_, i + 1);
+    }
+    *this = Iterator{array_, i};
+    return *this;
+}
+
+LazyElements::Iterator LazyElements::begin() const noexcept {
+    return array_.empty() ? Iterator{} : Iterator{array_, skipWhitespaceFrom(array_, 1)};
+}
+
+LazyElements::Iterator LazyElements::end() const noexcept {
+    // The closing bracket: a LazyValue's text carries no trailing whitespace.
+    return array_.empty() ? Iterator{} : Iterator{array_, array_.size() - 1};
+}
+
+Result<Value, Error> LazyValue::materialise() const noexcept {
+    // A complete JSON value in its own right, and one that already passed: parsing it again
+    // yields the subtree parse() would have built, through the one decoder there is.
+    return parse(text_);
+}
+
+Result<LazyValue, Error> parseLazy(std::string_view text) noexcept {
+    Parser parser{text, Scanner::Wide, Tree::Check};
+    if (auto checked = parser.run(); !checked.has_value()) {
+        return err(checked.error());
+    }
+    const std::size_t begin = skipWhitespaceFrom(text, 0);
+    return LazyValue{text.substr(begin, valueEnd(text, begin) - begin)};
+}
+
 }  // namespace mdux::evidence::json
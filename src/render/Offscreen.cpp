@@ -63,7 +63,17 @@ std::string_view describe(OffscreenError error) noexcept {
     case OffscreenError::BeginCommandBufferFailed: return "vkBeginCommandBuffer failed";
     case OffscreenError::EndCommandBufferFailed:   return "vkEndCommandBuffer failed";
     case OffscreenError::SubmitFailed:             return "vkQueueSubmit failed";
-    case OffscreenError::WaitFailed:               return "vkQueueWaitIdle failed";
+    case OffscreenError::WaitFailed:
+        return "vkResetFences, vkGetFenceStatus or vkWaitForFences failed";
+    case OffscreenError::FenceCreationFailed:      return "vkCreateFence failed";
+    case OffscreenError::ReadbackSlotsOutOfRange:
+        return "readback slot count is zero or exceeds the offscreen slot ceiling";
+    case OffscreenError::ReadbackSlotBusy:
+        return "next readback slot's frame has not finished on the GPU";
+    case OffscreenError::ReadbackNotReady:
+        return "frame did not finish before the readback timeout";
+    case OffscreenError::ReadbackExpired:
+        return "readback slot has since been submitted into again";
     }
     return "unknown offscreen error";
 }
@@ -95,7 +105,10 @@ OffscreenTarget& OffscreenTarget::operator=(OffscreenTarget&& other) noexcept {
     readbackMemory_ = std::exchange(other.readbackMemory_, VK_NULL_HANDLE);
     readbackMapped_ = std::exchange(other.readbackMapped_, nullptr);
     commandPool_ = std::exchange(other.commandPool_, VK_NULL_HANDLE);
-    commandBuffer_ = std::exchange(other.commandBuffer_, VK_NULL_HANDLE);
+    slots_ = std::exchange(other.slots_, {});
+    nextSlot_ = std::exchange(other.nextSlot_, 0);
+    submitted_ = std::exchange(other.submitted_, 0);
+    readSlot_ = std::exchange(other.readSlot_, 0);
     extent_ = std::exchange(other.extent_, mdux::core::Extent2D{});
     return *this;
 }
@@ -106,12 +119,26 @@ void OffscreenTarget::destroy() noexcept {
     }
     // Reverse creation order, every handle nulled, tolerant of any subset being null - which is
     // what lets create() return early on any failure and leave the local's destructor to clean up.
+    // A frame still in flight reads the image and writes a readback buffer, so it is waited for
+    // first; its result no longer has anywhere to go. A failed wait leaves nothing better to do
+    // than destroy regardless.
+    for (ReadbackSlot& slot : slots_) {
+        if (slot.pending) {
+            static_cast<void>(vkWaitForFences(device_, 1, &slot.fence, VK_TRUE,
+                                              std::numeric_limits<std::uint64_t>::max()));
+            slot.pending = false;
+        }
+        if (slot.fence != VK_NULL_HANDLE) {
+            vkDestroyFence(device_, slot.fence, nullptr);
+            slot.fence = VK_NULL_HANDLE;
+        }
+    }
     if (commandPool_ != VK_NULL_HANDLE) {
-        // Frees the command buffer allocated from it; no separate vkFreeCommandBuffers needed.
+        // Frees the command buffers allocated from it; no separate vkFreeCommandBuffers needed.
         vkDestroyCommandPool(device_, commandPool_, nullptr);
         commandPool_ = VK_NULL_HANDLE;
-        commandBuffer_ = VK_NULL_HANDLE;
     }
+    slots_.clear();
     if (readbackMapped_ != nullptr) {
         vkUnmapMemory(device_, readbackMemory_);
         readbackMapped_ = nullptr;
@@ -153,7 +180,7 @@ void OffscreenTarget::destroy() noexcept {
 
 Result<OffscreenTarget, OffscreenError> OffscreenTarget::create(
     VkDevice device, VkPhysicalDevice physicalDevice, mdux::core::Extent2D extent,
-    std::uint32_t queueFamilyIndex) noexcept {
+    std::uint32_t queueFamilyIndex, std::uint32_t readbackSlots) noexcept {
     if (device == VK_NULL_HANDLE) {
         return err(OffscreenError::NullDevice);
     }
@@ -168,6 +195,9 @@ Result<OffscreenTarget, OffscreenError> OffscreenTarget::create(
     if (pixels > maxPixels) {
         return err(OffscreenError::ExtentTooLarge);
     }
+    if (readbackSlots == 0 || readbackSlots > maxReadbackSlots) {
+        return err(OffscreenError::ReadbackSlotsOutOfRange);
+    }
 
     OffscreenTarget target;
     target.device_ = device;
@@ -252,15 +282,24 @@ Result<OffscreenTarget, OffscreenError> OffscreenTarget::create(
                                        .pDepthStencilAttachment = nullptr,
                                        .preserveAttachmentCount = 0,
                                        .pPreserveAttachments = nullptr};
-    // Makes the copy that follows the render pass wait for the colour writes to complete.
-    const VkSubpassDependency dependency{
-        .srcSubpass = 0,
-        .dstSubpass = VK_SUBPASS_EXTERNAL,
-        .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-        .dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT,
-        .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
-        .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
-        .dependencyFlags = 0};
+    // The first makes the clear wait for the previous frame's copy out of the image, which with
+    // frames in flight is no longer finished by the time the next is submitted. The second makes
+    // the copy that follows the render pass wait for the colour writes to complete.
+    const std::array<VkSubpassDependency, 2> dependencies{
+        VkSubpassDependency{.srcSubpass = VK_SUBPASS_EXTERNAL,
+                            .dstSubpass = 0,
+                            .srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT,
+                            .dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                            .srcAccessMask = 0,
+                            .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                            .dependencyFlags = 0},
+        VkSubpassDependency{.srcSubpass = 0,
+                            .dstSubpass = VK_SUBPASS_EXTERNAL,
+                            .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                            .dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT,
+                            .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                            .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+                            .dependencyFlags = 0}};
     const VkRenderPassCreateInfo renderPassInfo{
         .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
         .pNext = nullptr,
@@ -269,8 +308,8 @@ Result<OffscreenTarget, OffscreenError> OffscreenTarget::create(
         .pAttachments = &attachment,
         .subpassCount = 1,
         .pSubpasses = &subpass,
-        .dependencyCount = 1,
-        .pDependencies = &dependency};
+        .dependencyCount = static_cast<std::uint32_t>(dependencies.size()),
+        .pDependencies = dependencies.data()};
     if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &target.renderPass_) != VK_SUCCESS) {
         return err(OffscreenError::RenderPassCreationFailed);
     }
@@ -290,7 +329,9 @@ Result<OffscreenTarget, OffscreenError> OffscreenTarget::create(
         return err(OffscreenError::FramebufferCreationFailed);
     }
 
-    const VkDeviceSize readbackBytes = pixels * 4;
+    // One buffer, a frame's worth per slot, so there is one allocation and one mapping however
+    // many frames are in flight. A slot's offset is a multiple of 4, as a copy's must be.
+    const VkDeviceSize readbackBytes = pixels * 4 * readbackSlots;
     const VkBufferCreateInfo bufferInfo{.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
                                         .pNext = nullptr,
                                         .flags = 0,
@@ -335,33 +376,74 @@ Result<OffscreenTarget, OffscreenError> OffscreenTarget::create(
     if (vkCreateCommandPool(device, &poolInfo, nullptr, &target.commandPool_) != VK_SUCCESS) {
         return err(OffscreenError::CommandPoolCreationFailed);
     }
-    const VkCommandBufferAllocateInfo commandInfo{
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-        .pNext = nullptr,
-        .commandPool = target.commandPool_,
-        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-        .commandBufferCount = 1};
-    if (vkAllocateCommandBuffers(device, &commandInfo, &target.commandBuffer_) != VK_SUCCESS) {
-        return err(OffscreenError::CommandBufferAllocationFailed);
+    target.slots_.resize(readbackSlots);
+    for (ReadbackSlot& slot : target.slots_) {
+        const VkCommandBufferAllocateInfo commandInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .pNext = nullptr,
+            .commandPool = target.commandPool_,
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = 1};
+        if (vkAllocateCommandBuffers(device, &commandInfo, &slot.commandBuffer) != VK_SUCCESS) {
+            return err(OffscreenError::CommandBufferAllocationFailed);
+        }
+        // Unsignalled: a slot nothing was submitted into is not pending, so its fence is never
+        // asked about.
+        const VkFenceCreateInfo fenceInfo{
+            .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, .pNext = nullptr, .flags = 0};
+        if (vkCreateFence(device, &fenceInfo, nullptr, &slot.fence) != VK_SUCCESS) {
+            return err(OffscreenError::FenceCreationFailed);
+        }
     }
 
     return target;
 }
 
 // ---------------------------------------------------------------------------
-// renderAndRead()
+// renderAndRead() and submit()
 // ---------------------------------------------------------------------------
 
 Result<std::span<const mdux::core::ColorRgba8>, OffscreenError> OffscreenTarget::renderAndRead(
-    VkQueue queue, mdux::core::ColorRgba8 clear, RecordCommands record, void* context) noexcept {
+    VkQueue queue, mdux::core::ColorRgba8 clear, RecordCommands record, void* context,
+    RecordCommands prepare, VkSubpassContents contents) noexcept {
+    const auto handle = submit(queue, clear, record, context, prepare, contents);
+    if (!handle.has_value()) {
+        return err(handle.error());
+    }
+    return wait(*handle);
+}
+
+Result<ReadbackHandle, OffscreenError> OffscreenTarget::submit(
+    VkQueue queue, mdux::core::ColorRgba8 clear, RecordCommands record, void* context,
+    RecordCommands prepare, VkSubpassContents contents) noexcept {
     if (queue == VK_NULL_HANDLE) {
         return err(OffscreenError::NullQueue);
     }
 
+    // Polled, never waited on: a caller that must not stall is told the slot is busy instead.
+    const std::uint32_t at = nextSlot_;
+    ReadbackSlot& slot = slots_[at];
+    if (slot.pending) {
+        const VkResult status = vkGetFenceStatus(device_, slot.fence);
+        if (status == VK_NOT_READY) {
+            return err(OffscreenError::ReadbackSlotBusy);
+        }
+        if (status != VK_SUCCESS) {
+            return err(OffscreenError::WaitFailed);
+        }
+        slot.pending = false;
+    }
+    // Reset only once the slot is known to be idle, and only here, so a fence is unsignalled
+    // exactly while its slot's submission is outstanding.
+    if (vkResetFences(device_, 1, &slot.fence) != VK_SUCCESS) {
+        return err(OffscreenError::WaitFailed);
+    }
+    const VkCommandBuffer commandBuffer = slot.commandBuffer;
+
     // Checked, not discarded. A failed reset (VK_ERROR_OUT_OF_DEVICE_MEMORY is the realistic one)
     // leaves the buffer in an invalid state, and recording into it afterwards is undefined - so
     // the failure has to stop here rather than become a confusing error at submit time.
-    if (vkResetCommandBuffer(commandBuffer_, 0) != VK_SUCCESS) {
+    if (vkResetCommandBuffer(commandBuffer, 0) != VK_SUCCESS) {
         return err(OffscreenError::ResetCommandBufferFailed);
     }
     const VkCommandBufferBeginInfo begin{
@@ -369,9 +451,12 @@ Result<std::span<const mdux::core::ColorRgba8>, OffscreenError> OffscreenTarget:
         .pNext = nullptr,
         .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
         .pInheritanceInfo = nullptr};
-    if (vkBeginCommandBuffer(commandBuffer_, &begin) != VK_SUCCESS) {
+    if (vkBeginCommandBuffer(commandBuffer, &begin) != VK_SUCCESS) {
         return err(OffscreenError::BeginCommandBufferFailed);
     }
+    if (prepare != nullptr) {
+        prepare(commandBuffer, context);
+    }
 
     // The clear colour goes through the same 0..1 normalisation the shader's outputs do, so an
     // expected colour written as ColorRgba8 compares equal to a cleared pixel exactly.
@@ -389,16 +474,16 @@ Result<std::span<const mdux::core::ColorRgba8>, OffscreenError> OffscreenTarget:
                         static_cast<std::uint32_t>(extent_.height)}},
         .clearValueCount = 1,
         .pClearValues = &clearValue};
-    vkCmdBeginRenderPass(commandBuffer_, &renderPassBegin, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBeginRenderPass(commandBuffer, &renderPassBegin, contents);
 
     if (record != nullptr) {
-        record(commandBuffer_, context);
+        record(commandBuffer, context);
     }
 
-    vkCmdEndRenderPass(commandBuffer_);
+    vkCmdEndRenderPass(commandBuffer);
 
     const VkBufferImageCopy copy{
-        .bufferOffset = 0,
+        .bufferOffset = slotPixels(at).size_bytes() * VkDeviceSize{at},
         // Zero means tightly packed at the image's width, which is what pixelAt() assumes.
         .bufferRowLength = 0,
         .bufferImageHeight = 0,
@@ -406,35 +491,89 @@ Result<std::span<const mdux::core::ColorRgba8>, OffscreenError> OffscreenTarget:
         .imageOffset = {0, 0, 0},
         .imageExtent = {static_cast<std::uint32_t>(extent_.width),
                         static_cast<std::uint32_t>(extent_.height), 1}};
-    vkCmdCopyImageToBuffer(commandBuffer_, image_, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+    vkCmdCopyImageToBuffer(commandBuffer, image_, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
                            readbackBuffer_, 1, &copy);
-
-    if (vkEndCommandBuffer(commandBuffer_) != VK_SUCCESS) {
+    // The fence says the copy finished, not that the host can see what it wrote; this does.
+    const VkMemoryBarrier toHost{.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                                 .pNext = nullptr,
+                                 .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                                 .dstAccessMask = VK_ACCESS_HOST_READ_BIT};
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &toHost, 0, nullptr, 0, nullptr);
+
+    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
         return err(OffscreenError::EndCommandBufferFailed);
     }
 
-    const VkSubmitInfo submit{.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-                              .pNext = nullptr,
-                              .waitSemaphoreCount = 0,
-                              .pWaitSemaphores = nullptr,
-                              .pWaitDstStageMask = nullptr,
-                              .commandBufferCount = 1,
-                              .pCommandBuffers = &commandBuffer_,
-                              .signalSemaphoreCount = 0,
-                              .pSignalSemaphores = nullptr};
-    if (vkQueueSubmit(queue, 1, &submit, VK_NULL_HANDLE) != VK_SUCCESS) {
+    const VkSubmitInfo submitInfo{.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+                                  .pNext = nullptr,
+                                  .waitSemaphoreCount = 0,
+                                  .pWaitSemaphores = nullptr,
+                                  .pWaitDstStageMask = nullptr,
+                                  .commandBufferCount = 1,
+                                  .pCommandBuffers = &commandBuffer,
+                                  .signalSemaphoreCount = 0,
+                                  .pSignalSemaphores = nullptr};
+    if (vkQueueSubmit(queue, 1, &submitInfo, slot.fence) != VK_SUCCESS) {
         return err(OffscreenError::SubmitFailed);
     }
-    // Wait rather than fence-and-poll: a test that polls is a test that can hang, and there is no
-    // frame rate to keep up with here.
-    if (vkQueueWaitIdle(queue) != VK_SUCCESS) {
+
+    // Only a submission that happened expires the slot's last handle and moves on; a refused
+    // one leaves both exactly as they were.
+    slot.pending = true;
+    slot.sequence = ++submitted_;
+    nextSlot_ = (at + 1) % static_cast<std::uint32_t>(slots_.size());
+    return ReadbackHandle{.slot = at, .sequence = slot.sequence};
+}
+
+Result<bool, OffscreenError> OffscreenTarget::ready(const ReadbackHandle& handle) const noexcept {
+    if (!current(handle)) {
+        return err(OffscreenError::ReadbackExpired);
+    }
+    const ReadbackSlot& slot = slots_[handle.slot];
+    if (!slot.pending) {
+        return true;
+    }
+    const VkResult status = vkGetFenceStatus(device_, slot.fence);
+    if (status != VK_SUCCESS && status != VK_NOT_READY) {
         return err(OffscreenError::WaitFailed);
     }
+    return status == VK_SUCCESS;
+}
+
+Result<std::span<const mdux::core::ColorRgba8>, OffscreenError> OffscreenTarget::wait(
+    const ReadbackHandle& handle, std::uint64_t timeout) noexcept {
+    if (!current(handle)) {
+        return err(OffscreenError::ReadbackExpired);
+    }
+    ReadbackSlot& slot = slots_[handle.slot];
+    if (slot.pending) {
+        const VkResult status = vkWaitForFences(device_, 1, &slot.fence, VK_TRUE, timeout);
+        if (status == VK_TIMEOUT) {
+            return err(OffscreenError::ReadbackNotReady);
+        }
+        if (status != VK_SUCCESS) {
+            return err(OffscreenError::WaitFailed);
+        }
+        slot.pending = false;
+    }
+    readSlot_ = handle.slot;
+    return slotPixels(handle.slot);
+}
+
+bool OffscreenTarget::current(const ReadbackHandle& handle) const noexcept {
+    // Sequence zero is never issued, so a default-constructed handle names nothing.
+    return handle.slot < slots_.size() && handle.sequence != 0 &&
+           slots_[handle.slot].sequence == handle.sequence;
+}
 
+std::span<const mdux::core::ColorRgba8> OffscreenTarget::slotPixels(
+    std::uint32_t slot) const noexcept {
     const auto pixels = static_cast<std::size_t>(extent_.width) *
                         static_cast<std::size_t>(extent_.height);
     return std::span<const mdux::core::ColorRgba8>{
-        reinterpret_cast<const mdux::core::ColorRgba8*>(readbackMapped_), pixels};
+        reinterpret_cast<const mdux::core::ColorRgba8*>(readbackMapped_) + (pixels * slot),
+        pixels};
 }
 
 std::optional<mdux::core::ColorRgba8> OffscreenTarget::pixelAt(mdux::core::Px x,
@@ -444,7 +583,7 @@ std::optional<mdux::core::ColorRgba8> OffscreenTarget::pixelAt(mdux::core::Px x,
     }
     const auto index = static_cast<std::size_t>(y) * static_cast<std::size_t>(extent_.width) +
                        static_cast<std::size_t>(x);
-    return reinterpret_cast<const mdux::core::ColorRgba8*>(readbackMapped_)[index];
+    return slotPixels(readSlot_)[index];
 }
 
 }  // namespace mdux::render
@@ -20,6 +20,7 @@ import std;
 import mdux.core.result;
 import mdux.core.units;
 import mdux.draw;
+import mdux.evidence.digest;
 import mdux.shader.schema;
 
 namespace mdux::render {
@@ -32,7 +33,8 @@ namespace shader = mdux::shader;
 
 namespace {
 
-/// Host-visible and host-coherent, so a frame is a memcpy with no explicit flush.
+/// Host-visible and host-coherent, so a frame is a memcpy with no explicit flush. The staging
+/// mirrors use the same properties, for the same reason.
 ///
 /// Coherent rather than merely visible on purpose: a non-coherent mapping needs
 /// vkFlushMappedMemoryRanges with correctly aligned ranges, and getting that alignment wrong is
@@ -56,15 +58,47 @@ constexpr VkMemoryPropertyFlags frameMemoryProperties =
     return std::nullopt;
 }
 
-/// Creates a buffer, backs it with mapped host-coherent memory, and hands back all three.
+/// Whether geometry is better kept device-local and staged: the device has device-local memory,
+/// and the host cannot map the bulk of it, so whatever the host can map is either read across a
+/// bus on every draw or too scarce to hold geometry. Mappable device-local memory counts only in
+/// the device's largest device-local heap: an integrated GPU's one heap, or a discrete GPU's
+/// memory behind resizable BAR, answers no. The 256 MiB BAR window a discrete GPU exposes
+/// without it is a heap of its own, shared with the driver, and there staging still pays.
+[[nodiscard]] bool stagingPays(VkPhysicalDevice physicalDevice) noexcept {
+    VkPhysicalDeviceMemoryProperties memory{};
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memory);
+    VkDeviceSize largestHeap = 0;
+    for (std::uint32_t i = 0; i < memory.memoryHeapCount; ++i) {
+        if ((memory.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0) {
+            largestHeap = std::max(largestHeap, memory.memoryHeaps[i].size);
+        }
+    }
+    bool deviceLocal = false;
+    for (std::uint32_t i = 0; i < memory.memoryTypeCount; ++i) {
+        const VkMemoryPropertyFlags flags = memory.memoryTypes[i].propertyFlags;
+        if ((flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) == 0) {
+            continue;
+        }
+        if ((flags & frameMemoryProperties) == frameMemoryProperties &&
+            memory.memoryHeaps[memory.memoryTypes[i].heapIndex].size == largestHeap) {
+            return false;
+        }
+        deviceLocal = true;
+    }
+    return deviceLocal;
+}
+
+/// Creates a buffer, backs it with memory of the `required` properties, and hands back all
+/// three. Mapped only when that memory is host-visible; `preferred` properties are tried first.
 struct MappedBuffer {
     VkBuffer buffer{VK_NULL_HANDLE};
     VkDeviceMemory memory{VK_NULL_HANDLE};
     void* mapped{nullptr};
 };
 
-[[nodiscard]] Result<MappedBuffer, RenderError> createMappedBuffer(
-    const VulkanRenderContext& context, VkDeviceSize size, VkBufferUsageFlags usage) noexcept {
+[[nodiscard]] Result<MappedBuffer, RenderError> createBuffer(
+    const VulkanRenderContext& context, VkDeviceSize size, VkBufferUsageFlags usage,
+    VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred) noexcept {
     MappedBuffer result;
 
     const VkBufferCreateInfo bufferInfo{.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
@@ -82,18 +116,30 @@ struct MappedBuffer {
     VkMemoryRequirements requirements{};
     vkGetBufferMemoryRequirements(context.device, result.buffer, &requirements);
 
-    const auto typeIndex = findMemoryType(context.physicalDevice, requirements.memoryTypeBits,
-                                          frameMemoryProperties);
+    const auto fallback =
+        findMemoryType(context.physicalDevice, requirements.memoryTypeBits, required);
+    auto typeIndex = findMemoryType(context.physicalDevice, requirements.memoryTypeBits,
+                                    required | preferred);
+    if (!typeIndex.has_value()) {
+        typeIndex = fallback;
+    }
     if (!typeIndex.has_value()) {
         vkDestroyBuffer(context.device, result.buffer, nullptr);
         return err(RenderError::NoSuitableMemoryType);
     }
 
-    const VkMemoryAllocateInfo allocateInfo{.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-                                            .pNext = nullptr,
-                                            .allocationSize = requirements.size,
-                                            .memoryTypeIndex = *typeIndex};
-    if (vkAllocateMemory(context.device, &allocateInfo, nullptr, &result.memory) != VK_SUCCESS) {
+    VkMemoryAllocateInfo allocateInfo{.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+                                      .pNext = nullptr,
+                                      .allocationSize = requirements.size,
+                                      .memoryTypeIndex = *typeIndex};
+    VkResult allocated = vkAllocateMemory(context.device, &allocateInfo, nullptr, &result.memory);
+    // A preferred type can live in a small heap - a discrete GPU's BAR window - that is full
+    // while the required-only type's is not. A preference is not worth failing create() over.
+    if (allocated != VK_SUCCESS && fallback.has_value() && *fallback != *typeIndex) {
+        allocateInfo.memoryTypeIndex = *fallback;
+        allocated = vkAllocateMemory(context.device, &allocateInfo, nullptr, &result.memory);
+    }
+    if (allocated != VK_SUCCESS) {
         vkDestroyBuffer(context.device, result.buffer, nullptr);
         return err(RenderError::MemoryAllocationFailed);
     }
@@ -102,6 +148,9 @@ struct MappedBuffer {
         vkDestroyBuffer(context.device, result.buffer, nullptr);
         return err(RenderError::MemoryAllocationFailed);
     }
+    if ((required & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) == 0) {
+        return result;
+    }
     // Mapped once, for the renderer's lifetime. Mapping per frame would be a driver round trip
     // per frame for no benefit: the memory is host-coherent and never moves.
     if (vkMapMemory(context.device, result.memory, 0, VK_WHOLE_SIZE, 0, &result.mapped) !=
@@ -114,6 +163,35 @@ struct MappedBuffer {
     return result;
 }
 
+[[nodiscard]] Result<MappedBuffer, RenderError> createMappedBuffer(
+    const VulkanRenderContext& context, VkDeviceSize size, VkBufferUsageFlags usage,
+    VkMemoryPropertyFlags preferred = 0) noexcept {
+    return createBuffer(context, size, usage, frameMemoryProperties, preferred);
+}
+
+/// The elements [first, last) outside which `now` matches `mirror`, compared over the first
+/// `mirrored` of them. Every element at or past `mirrored` counts as changed: the mirror was never
+/// copied there, so matching it there says nothing about the device-local buffer. Compared as
+/// bytes, because a vertex that compares equal as floats (0.0 and -0.0) may not be the same bits.
+template <typename T>
+[[nodiscard]] std::pair<std::size_t, std::size_t> changedRange(std::span<const T> now,
+                                                               const T* mirror,
+                                                               std::size_t mirrored) noexcept {
+    const std::size_t common = std::min(now.size(), mirrored);
+    std::size_t first = 0;
+    while (first < common && std::memcmp(&now[first], mirror + first, sizeof(T)) == 0) {
+        ++first;
+    }
+    if (now.size() > common) {
+        return {first, now.size()};
+    }
+    std::size_t last = common;
+    while (last > first && std::memcmp(&now[last - 1], mirror + last - 1, sizeof(T)) == 0) {
+        --last;
+    }
+    return {first, last};
+}
+
 [[nodiscard]] Result<VkShaderModule, RenderError> createShaderModule(
     VkDevice device, std::span<const std::byte> spirv) noexcept {
     // vkCreateShaderModule wants 32-bit words and requires 4-byte alignment. The generated data
@@ -135,7 +213,8 @@ struct MappedBuffer {
     return module;
 }
 
-/// Creates the 1x1 opaque white default atlas, uploads it, and leaves it sampleable.
+/// Creates the atlas, clears it to opaque white, and leaves it sampleable. 1x1 unless the caller
+/// asked for room to upload into.
 ///
 /// White is the neutral value rather than a placeholder: multiplying the vertex colour by white is
 /// the identity for the sampled-RGBA path, and a red channel of 1.0 is full coverage for the R8
@@ -148,7 +227,7 @@ struct DefaultAtlas {
 };
 
 [[nodiscard]] Result<DefaultAtlas, RenderError> createDefaultAtlas(
-    const VulkanRenderContext& context) noexcept {
+    const VulkanRenderContext& context, mdux::core::Extent2D extent) noexcept {
     DefaultAtlas atlas;
 
     const VkImageCreateInfo imageInfo{
@@ -157,7 +236,8 @@ struct DefaultAtlas {
         .flags = 0,
         .imageType = VK_IMAGE_TYPE_2D,
         .format = VK_FORMAT_R8G8B8A8_UNORM,
-        .extent = {1, 1, 1},
+        .extent = {static_cast<std::uint32_t>(extent.width),
+                   static_cast<std::uint32_t>(extent.height), 1},
         .mipLevels = 1,
         .arrayLayers = 1,
         .samples = VK_SAMPLE_COUNT_1_BIT,
@@ -190,16 +270,9 @@ struct DefaultAtlas {
         return err(RenderError::MemoryAllocationFailed);
     }
 
-    // Four bytes through a staging buffer and a one-shot command buffer. Everything created here
-    // is destroyed before returning: the atlas outlives this function, the machinery does not.
-    auto staging = createMappedBuffer(context, 4, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
-    if (!staging.has_value()) {
-        vkFreeMemory(context.device, atlas.memory, nullptr);
-        vkDestroyImage(context.device, atlas.image, nullptr);
-        return err(staging.error());
-    }
-    constexpr std::array<std::uint8_t, 4> white{255, 255, 255, 255};
-    std::memcpy(staging->mapped, white.data(), white.size());
+    // A clear in a one-shot command buffer: no staging, however large the atlas. Everything
+    // created here is destroyed before returning: the atlas outlives this function, the machinery
+    // does not. Later contents arrive through updateAtlas(), recorded into the caller's frames.
 
     const VkCommandPoolCreateInfo poolInfo{.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
                                            .pNext = nullptr,
@@ -251,14 +324,10 @@ struct DefaultAtlas {
                              VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1,
                              &toTransfer);
 
-        const VkBufferImageCopy copy{.bufferOffset = 0,
-                                     .bufferRowLength = 0,
-                                     .bufferImageHeight = 0,
-                                     .imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
-                                     .imageOffset = {0, 0, 0},
-                                     .imageExtent = {1, 1, 1}};
-        vkCmdCopyBufferToImage(commands, staging->buffer, atlas.image,
-                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy);
+        const VkClearColorValue white{.float32 = {1.0F, 1.0F, 1.0F, 1.0F}};
+        const VkImageSubresourceRange whole{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        vkCmdClearColorImage(commands, atlas.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &white,
+                             1, &whole);
 
         VkImageMemoryBarrier toShader{
             .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
@@ -295,9 +364,6 @@ struct DefaultAtlas {
     if (pool != VK_NULL_HANDLE) {
         vkDestroyCommandPool(context.device, pool, nullptr);
     }
-    vkUnmapMemory(context.device, staging->memory);
-    vkDestroyBuffer(context.device, staging->buffer, nullptr);
-    vkFreeMemory(context.device, staging->memory, nullptr);
 
     if (!ok) {
         vkFreeMemory(context.device, atlas.memory, nullptr);
@@ -323,6 +389,9 @@ struct DefaultAtlas {
     return atlas;
 }
 
+static_assert(sizeof(mdux::core::ColorRgba8) == 4,
+              "RGBA atlas texels are staged exactly as they are laid out");
+
 [[nodiscard]] VkDescriptorType toVulkan(shader::DescriptorKind kind) noexcept {
     switch (kind) {
     case shader::DescriptorKind::UniformBuffer: return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
@@ -346,6 +415,14 @@ struct DefaultAtlas {
     return flags;
 }
 
+/// The tag a serialised pipeline cache opens with; its last byte is the header's version.
+constexpr std::array<std::byte, 8> pipelineCacheTag{
+    std::byte{'M'}, std::byte{'D'}, std::byte{'U'}, std::byte{'X'},
+    std::byte{'P'}, std::byte{'C'}, std::byte{'C'}, std::byte{1}};
+
+constexpr std::size_t pipelineCacheKeyAt = pipelineCacheTag.size();
+constexpr std::size_t pipelineCacheLengthAt = pipelineCacheKeyAt + 32;
+
 }  // namespace
 
 std::string_view describe(RenderError error) noexcept {
@@ -357,7 +434,7 @@ std::string_view describe(RenderError error) noexcept {
     case RenderError::EmptyViewport:       return "context viewport has zero width or height";
     case RenderError::EmptyBudget:         return "budget has no room for a primitive";
     case RenderError::BudgetExceedsIndexWidth:
-        return "budget exceeds what a 16-bit index can address";
+        return "budget exceeds what a command's vertex offset or first index can address";
     case RenderError::MissingVertexModule: return "shader package declares no vertex stage";
     case RenderError::MissingFragmentModule:
         return "shader package declares no fragment stage";
@@ -371,21 +448,64 @@ std::string_view describe(RenderError error) noexcept {
         return "no host-visible, host-coherent memory type on this device";
     case RenderError::MemoryAllocationFailed: return "vkAllocateMemory failed";
     case RenderError::MemoryMapFailed:        return "vkMapMemory failed";
-    case RenderError::ImageCreationFailed:    return "vkCreateImage failed for the default atlas";
+    case RenderError::ImageCreationFailed:    return "vkCreateImage failed for the atlas";
     case RenderError::ImageViewCreationFailed:
-        return "vkCreateImageView failed for the default atlas";
+        return "vkCreateImageView failed for the atlas";
     case RenderError::SamplerCreationFailed:  return "vkCreateSampler failed";
     case RenderError::DescriptorPoolCreationFailed: return "vkCreateDescriptorPool failed";
     case RenderError::DescriptorSetAllocationFailed:
         return "vkAllocateDescriptorSets failed";
-    case RenderError::CommandPoolCreationFailed:
-        return "vkCreateCommandPool failed for the atlas upload";
-    case RenderError::CommandBufferAllocationFailed:
-        return "vkAllocateCommandBuffers failed for the atlas upload";
-    case RenderError::AtlasUploadFailed:      return "uploading the default atlas failed";
+    case RenderError::CommandPoolCreationFailed: return "vkCreateCommandPool failed";
+    case RenderError::CommandBufferAllocationFailed: return "vkAllocateCommandBuffers failed";
+    case RenderError::AtlasUploadFailed:      return "clearing the atlas failed";
     case RenderError::NullCommandBuffer:      return "command buffer is null";
     case RenderError::FrameExceedsBudget:
         return "draw list is larger than the renderer's budget";
+    case RenderError::SegmentIdOutOfRange:
+        return "segment id is outside the renderer's segment budget";
+    case RenderError::SegmentAlreadyRetained:
+        return "a segment is already retained under this id";
+    case RenderError::SegmentBudgetExceeded:
+        return "resident range has no room left for the segment";
+    case RenderError::SegmentNotRetained:
+        return "frame draws a segment the renderer has not retained";
+    case RenderError::FrameSlotOutOfRange:
+        return "frame slot is outside the renderer's frames in flight";
+    case RenderError::FrameNotStaged:
+        return "device-local geometry was recorded without being staged first";
+    case RenderError::AtlasRegionOutOfBounds:
+        return "atlas update region is empty or extends past the atlas";
+    case RenderError::AtlasTexelsMismatch:
+        return "atlas update does not carry exactly one texel span matching its region";
+    case RenderError::AtlasStagingExhausted:
+        return "atlas updates exceed the frame slot's share of the staging ring";
+    case RenderError::PipelineCacheNotProvided:
+        return "renderer was created without a pipeline cache";
+    case RenderError::PipelineCacheStorageTooSmall:
+        return "storage is smaller than the serialised pipeline cache";
+    case RenderError::PipelineCacheReadFailed: return "vkGetPipelineCacheData failed";
+    case RenderError::TimestampsUnsupported:
+        return "queue family has no valid timestamp bits";
+    case RenderError::QueryPoolCreationFailed: return "vkCreateQueryPool failed";
+    case RenderError::TimestampsNotEnabled:
+        return "renderer was created without a timestamp budget";
+    case RenderError::TimestampsNotReset:
+        return "timed frame slot was recorded without resetting its timestamps";
+    case RenderError::TimestampsNotAvailable:
+        return "frame slot's timestamps were not recorded or have not executed";
+    case RenderError::LayerIdOutOfRange:
+        return "layer id is outside the renderer's layer budget";
+    case RenderError::LayerNotStatic:
+        return "layer draws geometry that is not a retained segment";
+    case RenderError::LayerNotRecorded:
+        return "layer was executed without a current recording";
+    case RenderError::LayerRecordingFailed:
+        return "beginning or ending a layer's command buffer failed";
+    case RenderError::ViewCountOutOfRange:
+        return "frame has no views, or more than the renderer's view budget";
+    case RenderError::NullDrawList: return "view has no draw list";
+    case RenderError::InvalidViewArea:
+        return "view area is empty or has an origin off the target";
     case RenderError::UnsupportedDescriptorSet:
         return "package declares a descriptor outside set 0; this renderer builds one set layout";
     case RenderError::DuplicateDescriptorBinding:
@@ -399,6 +519,40 @@ std::string_view describe(RenderError error) noexcept {
     return "unknown render error";
 }
 
+// ---------------------------------------------------------------------------
+// Pipeline cache persistence
+// ---------------------------------------------------------------------------
+
+mdux::evidence::Digest pipelineCacheKey(const shader::PackageView& package) noexcept {
+    mdux::evidence::Sha256 hash;
+    hash.update(package.spirv);
+    return hash.finish();
+}
+
+std::span<const std::byte> pipelineCacheInitialData(std::span<const std::byte> saved,
+                                                    const shader::PackageView& package) noexcept {
+    if (saved.size() < pipelineCacheHeaderBytes ||
+        !std::ranges::equal(saved.first(pipelineCacheTag.size()), pipelineCacheTag)) {
+        return {};
+    }
+    const mdux::evidence::Digest key = pipelineCacheKey(package);
+    if (!std::ranges::equal(saved.subspan(pipelineCacheKeyAt, key.size()),
+                            std::as_bytes(std::span{key}))) {
+        return {};
+    }
+    // Little-endian, written byte by byte, so the header reads the same on any host.
+    std::uint64_t length = 0;
+    for (std::size_t i = 0; i < 8; ++i) {
+        length |= std::uint64_t{std::to_integer<std::uint8_t>(saved[pipelineCacheLengthAt + i])}
+                  << (8 * i);
+    }
+    const std::span<const std::byte> data = saved.subspan(pipelineCacheHeaderBytes);
+    if (length != data.size()) {
+        return {};
+    }
+    return data;
+}
+
 // ---------------------------------------------------------------------------
 // Lifetime
 // ---------------------------------------------------------------------------
@@ -435,12 +589,34 @@ UiRenderer& UiRenderer::operator=(UiRenderer&& other) noexcept {
     descriptorPool_ = std::exchange(other.descriptorPool_, VK_NULL_HANDLE);
     // The set is owned by the pool and freed with it, so it is carried but never freed directly.
     descriptorSet_ = std::exchange(other.descriptorSet_, VK_NULL_HANDLE);
+    atlasExtent_ = std::exchange(other.atlasExtent_, mdux::core::Extent2D{});
+    atlasStaging_ = std::exchange(other.atlasStaging_, VK_NULL_HANDLE);
+    atlasStagingMemory_ = std::exchange(other.atlasStagingMemory_, VK_NULL_HANDLE);
+    atlasStagingMapped_ = std::exchange(other.atlasStagingMapped_, nullptr);
+    atlasStagingBytes_ = std::exchange(other.atlasStagingBytes_, 0);
+    atlasStagingStride_ = std::exchange(other.atlasStagingStride_, 0);
     vertexMapped_ = std::exchange(other.vertexMapped_, nullptr);
     indexMapped_ = std::exchange(other.indexMapped_, nullptr);
     vertexBytes_ = std::exchange(other.vertexBytes_, 0);
     indexBytes_ = std::exchange(other.indexBytes_, 0);
     budget_ = std::exchange(other.budget_, draw::DrawBudget{});
     viewport_ = std::exchange(other.viewport_, mdux::core::Extent2D{});
+    segmentBudget_ = std::exchange(other.segmentBudget_, draw::SegmentBudget{});
+    resident_ = std::exchange(other.resident_, {});
+    residentVertices_ = std::exchange(other.residentVertices_, 0);
+    residentIndices_ = std::exchange(other.residentIndices_, 0);
+    framesInFlight_ = std::exchange(other.framesInFlight_, 0);
+    viewBudget_ = std::exchange(other.viewBudget_, ViewBudget{});
+    uploaded_ = std::exchange(other.uploaded_, {});
+    vertexCopies_ = std::exchange(other.vertexCopies_, {});
+    indexCopies_ = std::exchange(other.indexCopies_, {});
+    geometryMemory_ = std::exchange(other.geometryMemory_, GeometryMemory::HostVisible);
+    vertexStaging_ = std::exchange(other.vertexStaging_, VK_NULL_HANDLE);
+    vertexStagingMemory_ = std::exchange(other.vertexStagingMemory_, VK_NULL_HANDLE);
+    indexStaging_ = std::exchange(other.indexStaging_, VK_NULL_HANDLE);
+    indexStagingMemory_ = std::exchange(other.indexStagingMemory_, VK_NULL_HANDLE);
+    pendingVertices_ = std::exchange(other.pendingVertices_, PendingCopy{});
+    pendingIndices_ = std::exchange(other.pendingIndices_, PendingCopy{});
     // The validated package contract. Not handles, but just as load-bearing: record() pushes
     // constants using pushSize_, so a member left behind here means a moved-from renderer pushes
     // nothing and every vertex reads a zero viewport. create() returns by value, so *every*
@@ -449,6 +625,22 @@ UiRenderer& UiRenderer::operator=(UiRenderer&& other) noexcept {
     pushStages_ = std::exchange(other.pushStages_, 0);
     pushOffset_ = std::exchange(other.pushOffset_, 0);
     pushSize_ = std::exchange(other.pushSize_, 0);
+    pipelineCache_ = std::exchange(other.pipelineCache_, VK_NULL_HANDLE);
+    pipelineCacheKey_ = std::exchange(other.pipelineCacheKey_, mdux::evidence::Digest{});
+    queryPool_ = std::exchange(other.queryPool_, VK_NULL_HANDLE);
+    timestampBudget_ = std::exchange(other.timestampBudget_, TimestampBudget{});
+    queriesPerFrame_ = std::exchange(other.queriesPerFrame_, 0);
+    timestampMask_ = std::exchange(other.timestampMask_, 0);
+    timestampPeriod_ = std::exchange(other.timestampPeriod_, 0.0);
+    timed_ = std::exchange(other.timed_, {});
+    ticks_ = std::exchange(other.ticks_, {});
+    commandTimes_ = std::exchange(other.commandTimes_, {});
+    renderPass_ = std::exchange(other.renderPass_, VK_NULL_HANDLE);
+    subpass_ = std::exchange(other.subpass_, 0);
+    layerPool_ = std::exchange(other.layerPool_, VK_NULL_HANDLE);
+    layerBudget_ = std::exchange(other.layerBudget_, LayerBudget{});
+    layers_ = std::exchange(other.layers_, {});
+    executing_ = std::exchange(other.executing_, {});
     return *this;
 }
 
@@ -458,10 +650,30 @@ void UiRenderer::destroy() noexcept {
     }
     // Reverse order of creation, and every handle nulled so a second call is a no-op. The
     // partially-built object on a create() error path relies on exactly that tolerance.
+    if (layerPool_ != VK_NULL_HANDLE) {
+        // Frees the layers' command buffers with it, as the descriptor pool frees its set.
+        vkDestroyCommandPool(device_, layerPool_, nullptr);
+        layerPool_ = VK_NULL_HANDLE;
+        layers_.clear();
+    }
+    if (queryPool_ != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(device_, queryPool_, nullptr);
+        queryPool_ = VK_NULL_HANDLE;
+    }
+    // With device-local geometry the mappings are the staging mirrors', not the buffers'.
     if (indexMapped_ != nullptr) {
-        vkUnmapMemory(device_, indexMemory_);
+        vkUnmapMemory(device_,
+                      indexStagingMemory_ != VK_NULL_HANDLE ? indexStagingMemory_ : indexMemory_);
         indexMapped_ = nullptr;
     }
+    if (indexStaging_ != VK_NULL_HANDLE) {
+        vkDestroyBuffer(device_, indexStaging_, nullptr);
+        indexStaging_ = VK_NULL_HANDLE;
+    }
+    if (indexStagingMemory_ != VK_NULL_HANDLE) {
+        vkFreeMemory(device_, indexStagingMemory_, nullptr);
+        indexStagingMemory_ = VK_NULL_HANDLE;
+    }
     if (indexBuffer_ != VK_NULL_HANDLE) {
         vkDestroyBuffer(device_, indexBuffer_, nullptr);
         indexBuffer_ = VK_NULL_HANDLE;
@@ -471,9 +683,18 @@ void UiRenderer::destroy() noexcept {
         indexMemory_ = VK_NULL_HANDLE;
     }
     if (vertexMapped_ != nullptr) {
-        vkUnmapMemory(device_, vertexMemory_);
+        vkUnmapMemory(device_, vertexStagingMemory_ != VK_NULL_HANDLE ? vertexStagingMemory_
+                                                                       : vertexMemory_);
         vertexMapped_ = nullptr;
     }
+    if (vertexStaging_ != VK_NULL_HANDLE) {
+        vkDestroyBuffer(device_, vertexStaging_, nullptr);
+        vertexStaging_ = VK_NULL_HANDLE;
+    }
+    if (vertexStagingMemory_ != VK_NULL_HANDLE) {
+        vkFreeMemory(device_, vertexStagingMemory_, nullptr);
+        vertexStagingMemory_ = VK_NULL_HANDLE;
+    }
     if (vertexBuffer_ != VK_NULL_HANDLE) {
         vkDestroyBuffer(device_, vertexBuffer_, nullptr);
         vertexBuffer_ = VK_NULL_HANDLE;
@@ -482,6 +703,18 @@ void UiRenderer::destroy() noexcept {
         vkFreeMemory(device_, vertexMemory_, nullptr);
         vertexMemory_ = VK_NULL_HANDLE;
     }
+    if (atlasStagingMapped_ != nullptr) {
+        vkUnmapMemory(device_, atlasStagingMemory_);
+        atlasStagingMapped_ = nullptr;
+    }
+    if (atlasStaging_ != VK_NULL_HANDLE) {
+        vkDestroyBuffer(device_, atlasStaging_, nullptr);
+        atlasStaging_ = VK_NULL_HANDLE;
+    }
+    if (atlasStagingMemory_ != VK_NULL_HANDLE) {
+        vkFreeMemory(device_, atlasStagingMemory_, nullptr);
+        atlasStagingMemory_ = VK_NULL_HANDLE;
+    }
     if (descriptorPool_ != VK_NULL_HANDLE) {
         // Frees the set allocated from it; no separate vkFreeDescriptorSets is needed or allowed
         // without VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT.
@@ -534,7 +767,14 @@ void UiRenderer::destroy() noexcept {
 
 Result<UiRenderer, RenderError> UiRenderer::create(const VulkanRenderContext& context,
                                                    const shader::PackageView& package,
-                                                   const draw::DrawBudget& budget) noexcept {
+                                                   const draw::DrawBudget& budget,
+                                                   const draw::SegmentBudget& segments,
+                                                   std::uint32_t framesInFlight,
+                                                   GeometryMemory memory,
+                                                   const AtlasBudget& atlasBudget,
+                                                   const TimestampBudget& timestamps,
+                                                   const LayerBudget& layers,
+                                                   const ViewBudget& views) noexcept {
     // Context and budget first: both are cheap to check and neither needs a device call, so a
     // caller's mistake is reported before anything is created.
     if (context.device == VK_NULL_HANDLE) {
@@ -552,12 +792,31 @@ Result<UiRenderer, RenderError> UiRenderer::create(const VulkanRenderContext& co
     if (context.viewport.width <= 0 || context.viewport.height <= 0) {
         return err(RenderError::EmptyViewport);
     }
-    if (budget.maxVertices < 4 || budget.maxIndices < 6 || budget.maxCommands == 0) {
+    if (budget.maxVertices < 4 || budget.maxIndices < 6 || budget.maxCommands == 0 ||
+        framesInFlight == 0 || views.maxViews == 0) {
         return err(RenderError::EmptyBudget);
     }
-    if (budget.maxVertices > draw::maxIndexableVertices) {
+    // Past one 16-bit batch the list splits itself and each command carries its batch's vertex
+    // offset, which the region's own offset is added to - and the sum must still fit the
+    // signed 32-bit vertexOffset vkCmdDrawIndexed takes, as the last region's first index must
+    // fit its 32-bit firstIndex. A region per view per frame slot, multiplied in 64 bits, where
+    // 32-bit counts cannot wrap.
+    const std::uint64_t regions = std::uint64_t{framesInFlight} * views.maxViews;
+    const std::uint64_t ringVertices = std::uint64_t{budget.maxVertices} * regions;
+    const std::uint64_t ringIndices = std::uint64_t{budget.maxIndices} * regions;
+    if (budget.maxVertices > draw::maxListVertices ||
+        segments.maxVertices + ringVertices > draw::maxListVertices ||
+        segments.maxIndices + ringIndices > std::numeric_limits<std::uint32_t>::max()) {
         return err(RenderError::BudgetExceedsIndexWidth);
     }
+    // Segments are optional, but a budget that allows some and gives them no room is a mistake
+    // better reported here than as SegmentBudgetExceeded on the first retain().
+    if (segments.maxSegments > 0 && (segments.maxVertices < 3 || segments.maxIndices < 3)) {
+        return err(RenderError::EmptyBudget);
+    }
+    if (atlasBudget.extent.width <= 0 || atlasBudget.extent.height <= 0) {
+        return err(RenderError::EmptyBudget);
+    }
 
     const shader::ModuleView* vertex = nullptr;
     const shader::ModuleView* fragment = nullptr;
@@ -625,13 +884,19 @@ Result<UiRenderer, RenderError> UiRenderer::create(const VulkanRenderContext& co
     const std::uint32_t pushOffset = declaredPush.offset;
     const std::uint32_t pushSize = declaredPush.size;
 
-
     // Built into a local whose destructor cleans up on every error path below, so there is one
     // teardown routine rather than one per failure point.
     UiRenderer renderer;
     renderer.device_ = context.device;
     renderer.budget_ = budget;
     renderer.viewport_ = context.viewport;
+    renderer.segmentBudget_ = segments;
+    renderer.resident_.resize(segments.maxSegments);
+    renderer.framesInFlight_ = framesInFlight;
+    renderer.viewBudget_ = views;
+    renderer.uploaded_.resize(static_cast<std::size_t>(regions));
+    renderer.vertexCopies_.resize(std::size_t{1} + views.maxViews);
+    renderer.indexCopies_.resize(std::size_t{1} + views.maxViews);
     renderer.atlasBinding_ = atlasBinding;
     renderer.pushStages_ = pushStages;
     renderer.pushOffset_ = pushOffset;
@@ -833,16 +1098,42 @@ Result<UiRenderer, RenderError> UiRenderer::create(const VulkanRenderContext& co
         .basePipelineHandle = VK_NULL_HANDLE,
         .basePipelineIndex = -1};
 
-    if (vkCreateGraphicsPipelines(context.device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr,
-                                  &renderer.pipeline_) != VK_SUCCESS) {
+    // Through the caller's cache when there is one, which turns this into a lookup on every boot
+    // after the first; with none, the driver compiles from SPIR-V as it always did.
+    renderer.pipelineCache_ = context.pipelineCache;
+    renderer.pipelineCacheKey_ = mdux::render::pipelineCacheKey(package);
+    if (vkCreateGraphicsPipelines(context.device, context.pipelineCache, 1, &pipelineInfo,
+                                  nullptr, &renderer.pipeline_) != VK_SUCCESS) {
         return err(RenderError::PipelineCreationFailed);
     }
 
-    renderer.vertexBytes_ = static_cast<VkDeviceSize>(budget.maxVertices) * sizeof(draw::UiVertex);
-    renderer.indexBytes_ = static_cast<VkDeviceSize>(budget.maxIndices) * sizeof(draw::Index);
-
-    auto vertexBuffer = createMappedBuffer(context, renderer.vertexBytes_,
-                                           VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+    // Resident range first, the ring of frame regions after it. All of it allocated here, once:
+    // recording a frame into any slot writes into memory that already exists.
+    renderer.vertexBytes_ = (segments.maxVertices + ringVertices) * sizeof(draw::UiVertex);
+    renderer.indexBytes_ = (segments.maxIndices + ringIndices) * sizeof(draw::Index);
+
+    if (memory == GeometryMemory::Automatic) {
+        memory = stagingPays(context.physicalDevice) ? GeometryMemory::DeviceLocal
+                                                     : GeometryMemory::HostVisible;
+    }
+    renderer.geometryMemory_ = memory;
+    const bool staged = memory == GeometryMemory::DeviceLocal;
+
+    // Staged, the buffers are device-local transfer destinations and each has a mapped mirror of
+    // the same size. Host-cached is preferred for the mirrors because stage() reads them back to
+    // find what changed, and reading uncached memory is what would cost there. Mapped directly,
+    // device-local is preferred: where stagingPays() said no, a mappable device-local type is
+    // what made it say so, and without the preference the first host-visible type found - on
+    // most drivers plain system memory - would be read across the bus on every draw.
+    const VkMemoryPropertyFlags geometryProperties =
+        staged ? VkMemoryPropertyFlags{VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT} : frameMemoryProperties;
+    const VkMemoryPropertyFlags geometryPreferred =
+        staged ? VkMemoryPropertyFlags{0}
+               : VkMemoryPropertyFlags{VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT};
+    const VkBufferUsageFlags transfer = staged ? VK_BUFFER_USAGE_TRANSFER_DST_BIT : 0;
+    auto vertexBuffer = createBuffer(context, renderer.vertexBytes_,
+                                     VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | transfer,
+                                     geometryProperties, geometryPreferred);
     if (!vertexBuffer.has_value()) {
         return err(vertexBuffer.error());
     }
@@ -850,8 +1141,9 @@ Result<UiRenderer, RenderError> UiRenderer::create(const VulkanRenderContext& co
     renderer.vertexMemory_ = vertexBuffer->memory;
     renderer.vertexMapped_ = vertexBuffer->mapped;
 
-    auto indexBuffer =
-        createMappedBuffer(context, renderer.indexBytes_, VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+    auto indexBuffer = createBuffer(context, renderer.indexBytes_,
+                                    VK_BUFFER_USAGE_INDEX_BUFFER_BIT | transfer,
+                                    geometryProperties, geometryPreferred);
     if (!indexBuffer.has_value()) {
         return err(indexBuffer.error());
     }
@@ -859,15 +1151,52 @@ Result<UiRenderer, RenderError> UiRenderer::create(const VulkanRenderContext& co
     renderer.indexMemory_ = indexBuffer->memory;
     renderer.indexMapped_ = indexBuffer->mapped;
 
+    if (staged) {
+        auto vertexStaging =
+            createMappedBuffer(context, renderer.vertexBytes_, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                               VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+        if (!vertexStaging.has_value()) {
+            return err(vertexStaging.error());
+        }
+        renderer.vertexStaging_ = vertexStaging->buffer;
+        renderer.vertexStagingMemory_ = vertexStaging->memory;
+        renderer.vertexMapped_ = vertexStaging->mapped;
+
+        auto indexStaging =
+            createMappedBuffer(context, renderer.indexBytes_, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                               VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+        if (!indexStaging.has_value()) {
+            return err(indexStaging.error());
+        }
+        renderer.indexStaging_ = indexStaging->buffer;
+        renderer.indexStagingMemory_ = indexStaging->memory;
+        renderer.indexMapped_ = indexStaging->mapped;
+    }
+
     // The default atlas, and the descriptor set that binds it. Without these a draw is undefined
     // behaviour whatever mode its vertices carry, because the pipeline layout declares a sampler.
-    auto atlas = createDefaultAtlas(context);
+    auto atlas = createDefaultAtlas(context, atlasBudget.extent);
     if (!atlas.has_value()) {
         return err(atlas.error());
     }
     renderer.atlasImage_ = atlas->image;
     renderer.atlasMemory_ = atlas->memory;
     renderer.atlasView_ = atlas->view;
+    renderer.atlasExtent_ = atlasBudget.extent;
+
+    if (atlasBudget.stagingBytes > 0) {
+        renderer.atlasStagingBytes_ = atlasBudget.stagingBytes;
+        renderer.atlasStagingStride_ =
+            (VkDeviceSize{atlasBudget.stagingBytes} + 3) & ~VkDeviceSize{3};
+        auto staging = createMappedBuffer(context, renderer.atlasStagingStride_ * framesInFlight,
+                                          VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+        if (!staging.has_value()) {
+            return err(staging.error());
+        }
+        renderer.atlasStaging_ = staging->buffer;
+        renderer.atlasStagingMemory_ = staging->memory;
+        renderer.atlasStagingMapped_ = staging->mapped;
+    }
 
     const VkSamplerCreateInfo samplerInfo{
         .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
@@ -944,33 +1273,485 @@ Result<UiRenderer, RenderError> UiRenderer::create(const VulkanRenderContext& co
                                      .pTexelBufferView = nullptr};
     vkUpdateDescriptorSets(context.device, 1, &write, 0, nullptr);
 
+    if (timestamps.maxCommands > 0) {
+        std::uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice, &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice, &familyCount,
+                                                 families.data());
+        if (context.queueFamilyIndex >= familyCount ||
+            families[context.queueFamilyIndex].timestampValidBits == 0) {
+            return err(RenderError::TimestampsUnsupported);
+        }
+        const std::uint32_t validBits = families[context.queueFamilyIndex].timestampValidBits;
+        renderer.timestampMask_ = validBits >= 64 ? ~std::uint64_t{0}
+                                                  : (std::uint64_t{1} << validBits) - 1;
+        VkPhysicalDeviceProperties properties{};
+        vkGetPhysicalDeviceProperties(context.physicalDevice, &properties);
+        renderer.timestampPeriod_ = properties.limits.timestampPeriod;
+
+        // A frame never has more commands than its budget in each view, so timing more would be
+        // queries no frame can write. In 64 bits, as the product of two counts.
+        renderer.timestampBudget_.maxCommands = static_cast<std::uint32_t>(
+            std::min(std::uint64_t{timestamps.maxCommands},
+                     std::uint64_t{budget.maxCommands} * views.maxViews));
+        const std::uint64_t queryCount =
+            (std::uint64_t{renderer.timestampBudget_.maxCommands} + 1) * framesInFlight;
+        if (queryCount > std::numeric_limits<std::uint32_t>::max()) {
+            return err(RenderError::QueryPoolCreationFailed);
+        }
+        renderer.queriesPerFrame_ = renderer.timestampBudget_.maxCommands + 1;
+        const VkQueryPoolCreateInfo queryInfo{
+            .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = 0,
+            .queryType = VK_QUERY_TYPE_TIMESTAMP,
+            .queryCount = static_cast<std::uint32_t>(queryCount),
+            .pipelineStatistics = 0};
+        if (vkCreateQueryPool(context.device, &queryInfo, nullptr, &renderer.queryPool_) !=
+            VK_SUCCESS) {
+            return err(RenderError::QueryPoolCreationFailed);
+        }
+        renderer.timed_.resize(framesInFlight);
+        renderer.ticks_.resize(renderer.queriesPerFrame_);
+        renderer.commandTimes_.resize(renderer.timestampBudget_.maxCommands);
+    }
+
+    renderer.renderPass_ = context.renderPass;
+    renderer.subpass_ = context.subpass;
+    if (layers.maxLayers > 0) {
+        // Resettable one by one, so re-recording a layer leaves the others as they were.
+        const VkCommandPoolCreateInfo poolInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+            .queueFamilyIndex = context.queueFamilyIndex};
+        if (vkCreateCommandPool(context.device, &poolInfo, nullptr, &renderer.layerPool_) !=
+            VK_SUCCESS) {
+            return err(RenderError::CommandPoolCreationFailed);
+        }
+        std::vector<VkCommandBuffer> buffers(layers.maxLayers, VK_NULL_HANDLE);
+        const VkCommandBufferAllocateInfo allocateInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .pNext = nullptr,
+            .commandPool = renderer.layerPool_,
+            .level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+            .commandBufferCount = layers.maxLayers};
+        if (vkAllocateCommandBuffers(context.device, &allocateInfo, buffers.data()) !=
+            VK_SUCCESS) {
+            return err(RenderError::CommandBufferAllocationFailed);
+        }
+        renderer.layerBudget_ = layers;
+        renderer.layers_.reserve(layers.maxLayers);
+        for (VkCommandBuffer buffer : buffers) {
+            renderer.layers_.push_back(StaticLayer{.commandBuffer = buffer, .recorded = false});
+        }
+        renderer.executing_.resize(layers.maxLayers);
+    }
+
     return renderer;
 }
 
 // ---------------------------------------------------------------------------
-// record()
+// Retained segments
 // ---------------------------------------------------------------------------
 
-ResultVoid<RenderError> UiRenderer::record(VkCommandBuffer commandBuffer,
-                                           const draw::DrawList& list) noexcept {
+ResultVoid<RenderError> UiRenderer::retain(const draw::DrawSegment& segment) noexcept {
+    if (segment.id() >= resident_.size()) {
+        return err(RenderError::SegmentIdOutOfRange);
+    }
+    ResidentSegment& slot = resident_[segment.id()];
+    if (slot.indexCount != 0) {
+        return err(RenderError::SegmentAlreadyRetained);
+    }
+    // Subtraction against remaining capacity, as in DrawList: the counts cannot wrap into fitting.
+    const std::size_t vertexCount = segment.vertices().size();
+    const std::size_t indexCount = segment.indices().size();
+    if (segmentBudget_.maxVertices - residentVertices_ < vertexCount ||
+        segmentBudget_.maxIndices - residentIndices_ < indexCount) {
+        return err(RenderError::SegmentBudgetExceeded);
+    }
+
+    // The segment's indices are its own, starting at zero; they stay that way, and the draw
+    // supplies the resident vertex offset. Copying them unchanged keeps retain() a memcpy.
+    std::memcpy(static_cast<std::byte*>(vertexMapped_) +
+                    static_cast<std::size_t>(residentVertices_) * sizeof(draw::UiVertex),
+                segment.vertices().data(), vertexCount * sizeof(draw::UiVertex));
+    std::memcpy(static_cast<std::byte*>(indexMapped_) +
+                    static_cast<std::size_t>(residentIndices_) * sizeof(draw::Index),
+                segment.indices().data(), indexCount * sizeof(draw::Index));
+    // Staged, that was the mirror; the next stage() copies it across.
+    if (geometryMemory_ == GeometryMemory::DeviceLocal) {
+        pendingVertices_.widen(VkDeviceSize{residentVertices_} * sizeof(draw::UiVertex),
+                               (VkDeviceSize{residentVertices_} + vertexCount) *
+                                   sizeof(draw::UiVertex));
+        pendingIndices_.widen(VkDeviceSize{residentIndices_} * sizeof(draw::Index),
+                              (VkDeviceSize{residentIndices_} + indexCount) * sizeof(draw::Index));
+    }
+
+    slot = ResidentSegment{.firstIndex = residentIndices_,
+                           .vertexOffset = static_cast<std::int32_t>(residentVertices_),
+                           .indexCount = static_cast<std::uint32_t>(indexCount),
+                           .hash = segment.hash()};
+    residentVertices_ += static_cast<std::uint32_t>(vertexCount);
+    residentIndices_ += static_cast<std::uint32_t>(indexCount);
+    return {};
+}
+
+Result<std::size_t, RenderError> UiRenderer::pipelineCacheSize() const noexcept {
+    if (pipelineCache_ == VK_NULL_HANDLE) {
+        return err(RenderError::PipelineCacheNotProvided);
+    }
+    std::size_t size = 0;
+    if (vkGetPipelineCacheData(device_, pipelineCache_, &size, nullptr) != VK_SUCCESS) {
+        return err(RenderError::PipelineCacheReadFailed);
+    }
+    return pipelineCacheHeaderBytes + size;
+}
+
+Result<std::span<const std::byte>, RenderError> UiRenderer::writePipelineCache(
+    std::span<std::byte> storage) const noexcept {
+    if (pipelineCache_ == VK_NULL_HANDLE) {
+        return err(RenderError::PipelineCacheNotProvided);
+    }
+    if (storage.size() < pipelineCacheHeaderBytes) {
+        return err(RenderError::PipelineCacheStorageTooSmall);
+    }
+    // The driver writes straight after the header. VK_INCOMPLETE means it wrote what fit and
+    // stopped, which is a truncated cache rather than a smaller one, so it is refused.
+    std::size_t size = storage.size() - pipelineCacheHeaderBytes;
+    const VkResult read = vkGetPipelineCacheData(device_, pipelineCache_, &size,
+                                                 storage.data() + pipelineCacheHeaderBytes);
+    if (read == VK_INCOMPLETE) {
+        return err(RenderError::PipelineCacheStorageTooSmall);
+    }
+    if (read != VK_SUCCESS) {
+        return err(RenderError::PipelineCacheReadFailed);
+    }
+
+    std::ranges::copy(pipelineCacheTag, storage.begin());
+    std::ranges::copy(std::as_bytes(std::span{pipelineCacheKey_}),
+                      storage.begin() + pipelineCacheKeyAt);
+    for (std::size_t i = 0; i < 8; ++i) {
+        storage[pipelineCacheLengthAt + i] =
+            static_cast<std::byte>((std::uint64_t{size} >> (8 * i)) & 0xFFU);
+    }
+    return std::span<const std::byte>{storage.first(pipelineCacheHeaderBytes + size)};
+}
+
+void UiRenderer::releaseSegments() noexcept {
+    std::ranges::fill(resident_, ResidentSegment{});
+    // Every layer draws segments, so none of them is still drawing what it was recorded against.
+    for (StaticLayer& layer : layers_) {
+        layer.recorded = false;
+    }
+    residentVertices_ = 0;
+    residentIndices_ = 0;
+    // Nothing released is drawn again, so its copy no longer needs to happen.
+    pendingVertices_ = {};
+    pendingIndices_ = {};
+}
+
+// ---------------------------------------------------------------------------
+// Atlas updates
+// ---------------------------------------------------------------------------
+
+ResultVoid<RenderError> UiRenderer::updateAtlas(VkCommandBuffer commandBuffer,
+                                                std::span<const AtlasUpdate> updates,
+                                                std::uint32_t frame) noexcept {
     if (commandBuffer == VK_NULL_HANDLE) {
         return err(RenderError::NullCommandBuffer);
     }
-    // A list built against a larger budget than this renderer was created for would overrun the
-    // mapped buffers. Refused rather than clamped: a silently truncated frame is a wrong frame.
-    if (list.vertices().size() > budget_.maxVertices ||
-        list.indices().size() > budget_.maxIndices ||
-        list.commands().size() > budget_.maxCommands) {
-        return err(RenderError::FrameExceedsBudget);
+    if (frame >= framesInFlight_) {
+        return err(RenderError::FrameSlotOutOfRange);
+    }
+    // The whole batch is checked before a byte is written, so a refused one leaves the staging
+    // share, the atlas and the command buffer exactly as they were. Summed in VkDeviceSize, where
+    // texel counts bounded by a 32-bit extent cannot wrap.
+    VkDeviceSize total = 0;
+    for (const AtlasUpdate& update : updates) {
+        const mdux::core::Rect& region = update.region;
+        if (region.width <= 0 || region.height <= 0 || region.x < 0 || region.y < 0 ||
+            region.width > atlasExtent_.width - region.x ||
+            region.height > atlasExtent_.height - region.y) {
+            return err(RenderError::AtlasRegionOutOfBounds);
+        }
+        const std::size_t texels =
+            static_cast<std::size_t>(region.width) * static_cast<std::size_t>(region.height);
+        const bool coverage = !update.coverage.empty();
+        if (coverage == !update.pixels.empty() ||
+            (coverage ? update.coverage.size() : update.pixels.size()) != texels) {
+            return err(RenderError::AtlasTexelsMismatch);
+        }
+        total += texels * sizeof(mdux::core::ColorRgba8);
+    }
+    if (total > atlasStagingBytes_) {
+        return err(RenderError::AtlasStagingExhausted);
+    }
+    if (updates.empty()) {
+        return {};
     }
 
-    if (!list.empty()) {
-        std::memcpy(vertexMapped_, list.vertices().data(),
-                    list.vertices().size() * sizeof(draw::UiVertex));
-        std::memcpy(indexMapped_, list.indices().data(),
-                    list.indices().size() * sizeof(draw::Index));
+    // Out of SHADER_READ_ONLY rather than UNDEFINED, so what is not overwritten is kept. The
+    // fragment-shader source stage also orders this after earlier frames still sampling.
+    VkImageMemoryBarrier toTransfer{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .pNext = nullptr,
+        .srcAccessMask = VK_ACCESS_SHADER_READ_BIT,
+        .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = atlasImage_,
+        .subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1}};
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1,
+                         &toTransfer);
+
+    // Copies are batched into fixed-size groups: one vkCmdCopyBufferToImage per group rather
+    // than per glyph, with no storage that grows with the batch.
+    const VkDeviceSize shareOffset = VkDeviceSize{frame} * atlasStagingStride_;
+    auto* const share =
+        static_cast<std::byte*>(atlasStagingMapped_) + static_cast<std::size_t>(shareOffset);
+    std::array<VkBufferImageCopy, 16> copies{};
+    std::uint32_t pending = 0;
+    VkDeviceSize written = 0;
+    for (const AtlasUpdate& update : updates) {
+        std::byte* const out = share + static_cast<std::size_t>(written);
+        if (!update.coverage.empty()) {
+            for (std::size_t i = 0; i < update.coverage.size(); ++i) {
+                std::memset(out + (i * 4), update.coverage[i], 4);
+            }
+        } else {
+            std::memcpy(out, update.pixels.data(), update.pixels.size_bytes());
+        }
+        const mdux::core::Rect& region = update.region;
+        copies[pending++] = VkBufferImageCopy{
+            .bufferOffset = shareOffset + written,
+            .bufferRowLength = 0,  // tightly packed, as the texels arrived
+            .bufferImageHeight = 0,
+            .imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+            .imageOffset = {region.x, region.y, 0},
+            .imageExtent = {static_cast<std::uint32_t>(region.width),
+                            static_cast<std::uint32_t>(region.height), 1}};
+        written += static_cast<VkDeviceSize>(region.width) *
+                   static_cast<VkDeviceSize>(region.height) * sizeof(mdux::core::ColorRgba8);
+        if (pending == copies.size()) {
+            vkCmdCopyBufferToImage(commandBuffer, atlasStaging_, atlasImage_,
+                                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, pending, copies.data());
+            pending = 0;
+        }
+    }
+    if (pending != 0) {
+        vkCmdCopyBufferToImage(commandBuffer, atlasStaging_, atlasImage_,
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, pending, copies.data());
     }
 
+    VkImageMemoryBarrier toShader = toTransfer;
+    toShader.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    toShader.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    toShader.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    toShader.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1,
+                         &toShader);
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// Static layers
+// ---------------------------------------------------------------------------
+
+ResultVoid<RenderError> UiRenderer::checkResident(const draw::DrawList& list) const noexcept {
+    // Every segment a command names must be the one retained under its id.
+    for (const draw::DrawCommand& command : list.commands()) {
+        if (command.segment == nullptr) {
+            continue;
+        }
+        const draw::SegmentId id = command.segment->id();
+        if (id >= resident_.size()) {
+            return err(RenderError::SegmentNotRetained);
+        }
+        const ResidentSegment& resident = resident_[id];
+        if (resident.indexCount == 0 || resident.hash != command.segment->hash() ||
+            command.firstIndex > resident.indexCount ||
+            command.indexCount > resident.indexCount - command.firstIndex) {
+            return err(RenderError::SegmentNotRetained);
+        }
+    }
+    return {};
+}
+
+VkCommandBufferInheritanceInfo UiRenderer::layerInheritance() const noexcept {
+    return VkCommandBufferInheritanceInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+        .pNext = nullptr,
+        .renderPass = renderPass_,
+        .subpass = subpass_,
+        .framebuffer = VK_NULL_HANDLE,
+        .occlusionQueryEnable = VK_FALSE,
+        .queryFlags = 0,
+        .pipelineStatistics = 0};
+}
+
+ResultVoid<RenderError> UiRenderer::recordLayer(std::uint32_t layer,
+                                                const draw::DrawList& list) noexcept {
+    if (layer >= layers_.size()) {
+        return err(RenderError::LayerIdOutOfRange);
+    }
+    if (!std::ranges::all_of(list.commands(), [](const draw::DrawCommand& command) noexcept {
+            return command.segment != nullptr;
+        })) {
+        return err(RenderError::LayerNotStatic);
+    }
+    if (auto resident = checkResident(list); !resident.has_value()) {
+        return resident;
+    }
+
+    // Not recorded until it ends cleanly: a layer that failed halfway is never executed.
+    StaticLayer& target = layers_[layer];
+    target.recorded = false;
+    const VkCommandBufferInheritanceInfo inheritance = layerInheritance();
+    const VkCommandBufferBeginInfo beginInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .pNext = nullptr,
+        .flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT |
+                 VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT,
+        .pInheritanceInfo = &inheritance};
+    if (vkBeginCommandBuffer(target.commandBuffer, &beginInfo) != VK_SUCCESS) {
+        return err(RenderError::LayerRecordingFailed);
+    }
+
+    // The same state and the same draws record() makes for a segment, scissored to each
+    // command's clip. Every draw reads the resident range, which nothing overwrites.
+    bindFrameState(target.commandBuffer, fullArea());
+    const VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(target.commandBuffer, 0, 1, &vertexBuffer_, &offset);
+    vkCmdBindIndexBuffer(target.commandBuffer, indexBuffer_, 0, VK_INDEX_TYPE_UINT16);
+    const VkRect2D full{.offset = {0, 0},
+                        .extent = {static_cast<std::uint32_t>(viewport_.width),
+                                   static_cast<std::uint32_t>(viewport_.height)}};
+    vkCmdSetScissor(target.commandBuffer, 0, 1, &full);
+    for (const draw::DrawCommand& command : list.commands()) {
+        VkRect2D scissor = full;
+        if (command.clip.width > 0 && command.clip.height > 0) {
+            const mdux::core::Px left = std::max(command.clip.x, 0);
+            const mdux::core::Px top = std::max(command.clip.y, 0);
+            const mdux::core::Px right = std::min(command.clip.right(), viewport_.width);
+            const mdux::core::Px bottom = std::min(command.clip.bottom(), viewport_.height);
+            if (right <= left || bottom <= top) {
+                continue;
+            }
+            scissor = VkRect2D{.offset = {left, top},
+                               .extent = {static_cast<std::uint32_t>(right - left),
+                                          static_cast<std::uint32_t>(bottom - top)}};
+        }
+        const ResidentSegment& resident = resident_[command.segment->id()];
+        vkCmdSetScissor(target.commandBuffer, 0, 1, &scissor);
+        vkCmdDrawIndexed(target.commandBuffer, command.indexCount, 1,
+                         resident.firstIndex + command.firstIndex, resident.vertexOffset, 0);
+    }
+
+    if (vkEndCommandBuffer(target.commandBuffer) != VK_SUCCESS) {
+        return err(RenderError::LayerRecordingFailed);
+    }
+    target.recorded = true;
+    return {};
+}
+
+ResultVoid<RenderError> UiRenderer::executeLayers(VkCommandBuffer commandBuffer,
+                                                  std::span<const std::uint32_t> layers) noexcept {
+    if (commandBuffer == VK_NULL_HANDLE) {
+        return err(RenderError::NullCommandBuffer);
+    }
+    for (const std::uint32_t layer : layers) {
+        if (layer >= layers_.size()) {
+            return err(RenderError::LayerIdOutOfRange);
+        }
+        if (!layers_[layer].recorded) {
+            return err(RenderError::LayerNotRecorded);
+        }
+    }
+    // A segment retained since its layer was recorded is drawn from the device-local buffer,
+    // so it must have been copied there first, exactly as for record().
+    if (!pendingVertices_.empty() || !pendingIndices_.empty()) {
+        return err(RenderError::FrameNotStaged);
+    }
+    // In batches the size of the budget, so a list naming a layer more than once needs no more
+    // storage than was allocated at create().
+    std::size_t batched = 0;
+    for (const std::uint32_t layer : layers) {
+        executing_[batched++] = layers_[layer].commandBuffer;
+        if (batched == executing_.size()) {
+            vkCmdExecuteCommands(commandBuffer, static_cast<std::uint32_t>(batched),
+                                 executing_.data());
+            batched = 0;
+        }
+    }
+    if (batched != 0) {
+        vkCmdExecuteCommands(commandBuffer, static_cast<std::uint32_t>(batched), executing_.data());
+    }
+    return {};
+}
+
+// ---------------------------------------------------------------------------
+// GPU timing
+// ---------------------------------------------------------------------------
+
+ResultVoid<RenderError> UiRenderer::resetTimestamps(VkCommandBuffer commandBuffer,
+                                                    std::uint32_t frame) noexcept {
+    if (commandBuffer == VK_NULL_HANDLE) {
+        return err(RenderError::NullCommandBuffer);
+    }
+    if (queryPool_ == VK_NULL_HANDLE) {
+        return err(RenderError::TimestampsNotEnabled);
+    }
+    if (frame >= framesInFlight_) {
+        return err(RenderError::FrameSlotOutOfRange);
+    }
+    vkCmdResetQueryPool(commandBuffer, queryPool_, frame * queriesPerFrame_, queriesPerFrame_);
+    timed_[frame] = TimedFrame{.reset = true, .queries = 0, .commands = 0};
+    return {};
+}
+
+Result<GpuTimings, RenderError> UiRenderer::timings(std::uint32_t frame) noexcept {
+    if (queryPool_ == VK_NULL_HANDLE) {
+        return err(RenderError::TimestampsNotEnabled);
+    }
+    if (frame >= framesInFlight_) {
+        return err(RenderError::FrameSlotOutOfRange);
+    }
+    const TimedFrame& timed = timed_[frame];
+    if (timed.queries == 0) {
+        return err(RenderError::TimestampsNotAvailable);
+    }
+    // No WAIT_BIT: a frame still executing is reported, not waited for.
+    if (vkGetQueryPoolResults(device_, queryPool_, frame * queriesPerFrame_, timed.queries,
+                              timed.queries * sizeof(std::uint64_t), ticks_.data(),
+                              sizeof(std::uint64_t), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS) {
+        return err(RenderError::TimestampsNotAvailable);
+    }
+    // Differences are taken modulo the valid bits, so a counter that wrapped mid-frame still
+    // gives the right duration.
+    const auto elapsed = [this](std::uint64_t from, std::uint64_t to) noexcept {
+        const auto ticks = static_cast<double>((to - from) & timestampMask_);
+        return std::chrono::nanoseconds{std::llround(ticks * timestampPeriod_)};
+    };
+    for (std::uint32_t i = 0; i < timed.commands; ++i) {
+        commandTimes_[i] = elapsed(ticks_[i], ticks_[i + 1]);
+    }
+    return GpuTimings{
+        .frame = elapsed(ticks_.front(), ticks_[timed.queries - 1]),
+        .commands = std::span<const std::chrono::nanoseconds>{commandTimes_}.first(timed.commands)};
+}
+
+// ---------------------------------------------------------------------------
+// record()
+// ---------------------------------------------------------------------------
+
+void UiRenderer::bindFrameState(VkCommandBuffer commandBuffer,
+                                const mdux::core::Rect& area) const noexcept {
     vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_);
     // Bound for every frame, including one that draws nothing but solid rectangles: the pipeline
     // layout declares the sampler, so a draw without a set bound is undefined behaviour whatever
@@ -979,46 +1760,334 @@ ResultVoid<RenderError> UiRenderer::record(VkCommandBuffer commandBuffer,
     vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout_, 0, 1,
                             &descriptorSet_, 0, nullptr);
 
-    const VkViewport viewport{.x = 0.0F,
-                              .y = 0.0F,
-                              .width = static_cast<float>(viewport_.width),
-                              .height = static_cast<float>(viewport_.height),
+    // The viewport places the view; the push constants are only its extent, so the shader's
+    // pixel-to-clip conversion is the same for every view and the list never learns its offset.
+    const VkViewport viewport{.x = static_cast<float>(area.x),
+                              .y = static_cast<float>(area.y),
+                              .width = static_cast<float>(area.width),
+                              .height = static_cast<float>(area.height),
                               .minDepth = 0.0F,
                               .maxDepth = 1.0F};
     vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 
-    const UiPushConstants push{.viewportWidth = static_cast<float>(viewport_.width),
-                               .viewportHeight = static_cast<float>(viewport_.height)};
+    const UiPushConstants push{.viewportWidth = static_cast<float>(area.width),
+                               .viewportHeight = static_cast<float>(area.height)};
     // Stage, offset and size come from what create() validated the package declares, not from
     // literals here: record() must agree with the pipeline layout that was actually built.
     vkCmdPushConstants(commandBuffer, pipelineLayout_, pushStages_, pushOffset_, pushSize_, &push);
+}
+
+void UiRenderer::uploadMapped(const draw::DrawList& list, std::uint32_t region) noexcept {
+    // The list's own geometry goes into its region, after the resident range. Retained segments
+    // are not copied: that is the per-frame upload they exist to remove.
+    const std::uint32_t regionFirstIndex = segmentBudget_.maxIndices + region * budget_.maxIndices;
+    const std::uint32_t regionFirstVertex =
+        segmentBudget_.maxVertices + region * budget_.maxVertices;
+    // A frame whose hash matches the one already in its region is not copied again: a static
+    // screen then costs no upload at all. The hash covers every vertex and index byte and both
+    // counts, so a match means the same bytes up to a 64-bit collision. Kept per region, because
+    // each region holds whatever was last recorded into it.
+    const std::uint64_t frameHash = list.hash();
+    UploadedFrame& uploaded = uploaded_[region];
+    if (list.vertices().empty() || (uploaded.valid && frameHash == uploaded.hash)) {
+        return;
+    }
+    std::memcpy(static_cast<std::byte*>(vertexMapped_) +
+                    static_cast<std::size_t>(regionFirstVertex) * sizeof(draw::UiVertex),
+                list.vertices().data(), list.vertices().size() * sizeof(draw::UiVertex));
+    std::memcpy(static_cast<std::byte*>(indexMapped_) +
+                    static_cast<std::size_t>(regionFirstIndex) * sizeof(draw::Index),
+                list.indices().data(), list.indices().size() * sizeof(draw::Index));
+    uploaded.hash = frameHash;
+    uploaded.valid = true;
+}
+
+ResultVoid<RenderError> UiRenderer::checkViews(VkCommandBuffer commandBuffer,
+                                               std::span<const RenderView> views,
+                                               std::uint32_t frame) const noexcept {
+    if (commandBuffer == VK_NULL_HANDLE) {
+        return err(RenderError::NullCommandBuffer);
+    }
+    if (frame >= framesInFlight_) {
+        return err(RenderError::FrameSlotOutOfRange);
+    }
+    if (views.empty() || views.size() > viewBudget_.maxViews) {
+        return err(RenderError::ViewCountOutOfRange);
+    }
+    for (const RenderView& view : views) {
+        if (view.list == nullptr) {
+            return err(RenderError::NullDrawList);
+        }
+        // A scissor's offset may not be negative, the viewport has to have an area, and a view
+        // whose origin is past the target's edge would draw nothing anyone sees.
+        if (view.area.width <= 0 || view.area.height <= 0 || view.area.x < 0 || view.area.y < 0 ||
+            view.area.x >= viewport_.width || view.area.y >= viewport_.height) {
+            return err(RenderError::InvalidViewArea);
+        }
+        // A list built against a larger budget than this renderer was created for would overrun
+        // its region. Refused rather than clamped: a silently truncated frame is a wrong frame.
+        const draw::DrawList& list = *view.list;
+        if (list.vertices().size() > budget_.maxVertices ||
+            list.indices().size() > budget_.maxIndices ||
+            list.commands().size() > budget_.maxCommands) {
+            return err(RenderError::FrameExceedsBudget);
+        }
+    }
+    return {};
+}
+
+ResultVoid<RenderError> UiRenderer::stage(VkCommandBuffer commandBuffer,
+                                          const draw::DrawList& list,
+                                          std::uint32_t frame) noexcept {
+    const RenderView view{.list = &list, .area = fullArea()};
+    return stage(commandBuffer, std::span<const RenderView>{&view, 1}, frame);
+}
 
-    // An empty frame still binds and sets state, so a caller that records every frame the same
-    // way gets the same command stream shape whether or not anything was drawn.
-    if (list.empty()) {
-        const VkRect2D scissor{.offset = {0, 0},
-                               .extent = {static_cast<std::uint32_t>(viewport_.width),
-                                          static_cast<std::uint32_t>(viewport_.height)}};
-        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+ResultVoid<RenderError> UiRenderer::stage(VkCommandBuffer commandBuffer,
+                                          std::span<const RenderView> views,
+                                          std::uint32_t frame) noexcept {
+    if (auto checked = checkViews(commandBuffer, views, frame); !checked.has_value()) {
+        return checked;
+    }
+    if (geometryMemory_ != GeometryMemory::DeviceLocal) {
+        for (std::uint32_t view = 0; view < views.size(); ++view) {
+            uploadMapped(*views[view].list, frame * viewBudget_.maxViews + view);
+        }
         return {};
     }
 
-    const VkDeviceSize offset = 0;
-    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer_, &offset);
-    vkCmdBindIndexBuffer(commandBuffer, indexBuffer_, 0, VK_INDEX_TYPE_UINT16);
+    // The resident range and each view's changed range, as separate regions. Never one region
+    // spanning them, which would also rewrite other slots' regions while their frames may be in
+    // flight.
+    std::uint32_t vertexRegionCount = 0;
+    std::uint32_t indexRegionCount = 0;
+    const auto add = [](std::vector<VkBufferCopy>& regions, std::uint32_t& count,
+                        VkDeviceSize begin, VkDeviceSize end) noexcept {
+        if (end > begin) {
+            regions[count++] = VkBufferCopy{.srcOffset = begin, .dstOffset = begin,
+                                            .size = end - begin};
+        }
+    };
+    add(vertexCopies_, vertexRegionCount, pendingVertices_.begin, pendingVertices_.end);
+    add(indexCopies_, indexRegionCount, pendingIndices_.begin, pendingIndices_.end);
+
+    for (std::uint32_t view = 0; view < views.size(); ++view) {
+        // Only what differs from the mirror is written to it and copied; an unchanged list, by
+        // hash, is not even compared.
+        const draw::DrawList& list = *views[view].list;
+        const std::uint32_t region = frame * viewBudget_.maxViews + view;
+        UploadedFrame& uploaded = uploaded_[region];
+        const std::uint64_t frameHash = list.hash();
+        if (uploaded.valid && uploaded.hash == frameHash) {
+            continue;
+        }
+        const std::size_t regionFirstVertex =
+            segmentBudget_.maxVertices + std::size_t{region} * budget_.maxVertices;
+        const std::size_t regionFirstIndex =
+            segmentBudget_.maxIndices + std::size_t{region} * budget_.maxIndices;
+        auto* const vertexMirror = static_cast<draw::UiVertex*>(vertexMapped_) + regionFirstVertex;
+        auto* const indexMirror = static_cast<draw::Index*>(indexMapped_) + regionFirstIndex;
+
+        const auto [firstVertex, lastVertex] =
+            changedRange(list.vertices(), vertexMirror, uploaded.mirroredVertices);
+        std::copy(list.vertices().begin() + static_cast<std::ptrdiff_t>(firstVertex),
+                  list.vertices().begin() + static_cast<std::ptrdiff_t>(lastVertex),
+                  vertexMirror + firstVertex);
+        add(vertexCopies_, vertexRegionCount,
+            (regionFirstVertex + firstVertex) * sizeof(draw::UiVertex),
+            (regionFirstVertex + lastVertex) * sizeof(draw::UiVertex));
+
+        const auto [firstIndex, lastIndex] =
+            changedRange(list.indices(), indexMirror, uploaded.mirroredIndices);
+        std::copy(list.indices().begin() + static_cast<std::ptrdiff_t>(firstIndex),
+                  list.indices().begin() + static_cast<std::ptrdiff_t>(lastIndex),
+                  indexMirror + firstIndex);
+        add(indexCopies_, indexRegionCount, (regionFirstIndex + firstIndex) * sizeof(draw::Index),
+            (regionFirstIndex + lastIndex) * sizeof(draw::Index));
+
+        uploaded.hash = frameHash;
+        uploaded.valid = true;
+        uploaded.mirroredVertices = std::max(
+            uploaded.mirroredVertices, static_cast<std::uint32_t>(list.vertices().size()));
+        uploaded.mirroredIndices = std::max(uploaded.mirroredIndices,
+                                            static_cast<std::uint32_t>(list.indices().size()));
+    }
+
+    if (vertexRegionCount != 0) {
+        vkCmdCopyBuffer(commandBuffer, vertexStaging_, vertexBuffer_, vertexRegionCount,
+                        vertexCopies_.data());
+    }
+    if (indexRegionCount != 0) {
+        vkCmdCopyBuffer(commandBuffer, indexStaging_, indexBuffer_, indexRegionCount,
+                        indexCopies_.data());
+    }
+    if (vertexRegionCount + indexRegionCount != 0) {
+        const VkMemoryBarrier visible{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .pNext = nullptr,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT};
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &visible, 0, nullptr, 0,
+                             nullptr);
+    }
+    pendingVertices_ = {};
+    pendingIndices_ = {};
+    return {};
+}
 
-    for (const draw::DrawCommand& command : list.commands()) {
-        // A zero-sized clip means "no clip", which is what a DrawList carries until setClip is
-        // called. Scissoring to a zero rectangle would discard the whole command silently.
-        const bool clipped = command.clip.width > 0 && command.clip.height > 0;
-        const VkRect2D scissor{
-            .offset = {clipped ? command.clip.x : 0, clipped ? command.clip.y : 0},
-            .extent = {clipped ? static_cast<std::uint32_t>(command.clip.width)
-                               : static_cast<std::uint32_t>(viewport_.width),
-                       clipped ? static_cast<std::uint32_t>(command.clip.height)
-                               : static_cast<std::uint32_t>(viewport_.height)}};
-        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-        vkCmdDrawIndexed(commandBuffer, command.indexCount, 1, command.firstIndex, 0, 0);
+ResultVoid<RenderError> UiRenderer::record(VkCommandBuffer commandBuffer,
+                                           const draw::DrawList& list,
+                                           std::uint32_t frame) noexcept {
+    // Undamaged recording is one view over the context's viewport, drawn whole: every command is
+    // drawn once under exactly the scissor it always had.
+    const RenderView view{.list = &list, .area = fullArea()};
+    return recordViews(commandBuffer, std::span<const RenderView>{&view, 1}, std::nullopt, frame);
+}
+
+ResultVoid<RenderError> UiRenderer::record(VkCommandBuffer commandBuffer,
+                                           const draw::DrawList& list,
+                                           std::span<const mdux::core::Rect> damage,
+                                           std::uint32_t frame) noexcept {
+    const RenderView view{.list = &list, .area = fullArea()};
+    return recordViews(commandBuffer, std::span<const RenderView>{&view, 1}, damage, frame);
+}
+
+ResultVoid<RenderError> UiRenderer::record(VkCommandBuffer commandBuffer,
+                                           std::span<const RenderView> views,
+                                           std::uint32_t frame) noexcept {
+    return recordViews(commandBuffer, views, std::nullopt, frame);
+}
+
+ResultVoid<RenderError> UiRenderer::recordViews(
+    VkCommandBuffer commandBuffer, std::span<const RenderView> views,
+    std::optional<std::span<const mdux::core::Rect>> damage, std::uint32_t frame) noexcept {
+    if (auto checked = checkViews(commandBuffer, views, frame); !checked.has_value()) {
+        return checked;
+    }
+    // Checked before any command is recorded, so a refused frame leaves the command buffer as it
+    // found it.
+    for (const RenderView& view : views) {
+        if (auto resident = checkResident(*view.list); !resident.has_value()) {
+            return resident;
+        }
+    }
+    // A query written twice without a reset between is undefined, not merely stale.
+    const bool timed = queryPool_ != VK_NULL_HANDLE;
+    if (timed && !timed_[frame].reset) {
+        return err(RenderError::TimestampsNotReset);
+    }
+    // Staged geometry was copied by stage(), which must have been given these very lists; mapped
+    // geometry is copied now. Either way, before anything is recorded.
+    const std::uint32_t firstRegion = frame * viewBudget_.maxViews;
+    if (geometryMemory_ == GeometryMemory::DeviceLocal) {
+        if (!pendingVertices_.empty() || !pendingIndices_.empty()) {
+            return err(RenderError::FrameNotStaged);
+        }
+        for (std::uint32_t view = 0; view < views.size(); ++view) {
+            const draw::DrawList& list = *views[view].list;
+            const UploadedFrame& uploaded = uploaded_[firstRegion + view];
+            if (!list.vertices().empty() && !(uploaded.valid && uploaded.hash == list.hash())) {
+                return err(RenderError::FrameNotStaged);
+            }
+        }
+    } else {
+        for (std::uint32_t view = 0; view < views.size(); ++view) {
+            uploadMapped(*views[view].list, firstRegion + view);
+        }
+    }
+
+    // The frame's start, then the end of each command up to the budget, counting across the
+    // views in order; the last timestamp is always the frame's end, so commands past the budget
+    // fall into the last duration.
+    std::size_t commandCount = 0;
+    for (const RenderView& view : views) {
+        commandCount += view.list->commands().size();
+    }
+    const std::uint32_t firstQuery = frame * queriesPerFrame_;
+    const auto timedCommands = static_cast<std::uint32_t>(
+        std::min<std::size_t>(commandCount, timestampBudget_.maxCommands));
+    const std::uint32_t endQuery = firstQuery + std::max(timedCommands, 1U);
+    if (timed) {
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool_,
+                            firstQuery);
+        timed_[frame] = TimedFrame{
+            .reset = false, .queries = endQuery - firstQuery + 1, .commands = timedCommands};
+    }
+
+    std::uint32_t at = 0;
+    for (std::uint32_t view = 0; view < views.size(); ++view) {
+        const draw::DrawList& list = *views[view].list;
+        const mdux::core::Rect& area = views[view].area;
+        // create() has checked the last region's offsets fit, so neither product can wrap.
+        const std::uint32_t region = firstRegion + view;
+        const std::uint32_t regionFirstIndex =
+            segmentBudget_.maxIndices + region * budget_.maxIndices;
+        const auto regionVertexOffset =
+            static_cast<std::int32_t>(segmentBudget_.maxVertices + region * budget_.maxVertices);
+
+        bindFrameState(commandBuffer, area);
+
+        // An empty view still binds and sets state, so a caller that records every frame the
+        // same way gets the same command stream shape whether or not anything was drawn.
+        if (list.empty()) {
+            const VkRect2D scissor{.offset = {area.x, area.y},
+                                   .extent = {static_cast<std::uint32_t>(area.width),
+                                              static_cast<std::uint32_t>(area.height)}};
+            vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+            continue;
+        }
+
+        const VkDeviceSize offset = 0;
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer_, &offset);
+        vkCmdBindIndexBuffer(commandBuffer, indexBuffer_, 0, VK_INDEX_TYPE_UINT16);
+
+        // Clips and damage are in the view's own coordinates, cut to it and then placed by its
+        // origin, so no view's commands can shade another view's pixels.
+        const mdux::core::Rect local{.x = 0, .y = 0, .width = area.width, .height = area.height};
+        const std::array<mdux::core::Rect, 1> whole{local};
+        const std::span<const mdux::core::Rect> areas = damage.value_or(whole);
+        for (const draw::DrawCommand& command : list.commands()) {
+            // A zero-sized clip means "no clip", which is what a DrawList carries until setClip
+            // is called. Scissoring to a zero rectangle would discard the whole command silently.
+            const bool clipped = command.clip.width > 0 && command.clip.height > 0;
+            const mdux::core::Rect clip = clipped ? command.clip : local;
+            std::uint32_t firstIndex = regionFirstIndex + command.firstIndex;
+            std::int32_t vertexOffset =
+                regionVertexOffset + static_cast<std::int32_t>(command.vertexOffset);
+            if (command.segment != nullptr) {
+                const ResidentSegment& resident = resident_[command.segment->id()];
+                firstIndex = resident.firstIndex + command.firstIndex;
+                vertexOffset = resident.vertexOffset;
+            }
+            for (const mdux::core::Rect& damaged : areas) {
+                const mdux::core::Px left = std::max({clip.x, damaged.x, 0});
+                const mdux::core::Px top = std::max({clip.y, damaged.y, 0});
+                const mdux::core::Px right =
+                    std::min({clip.right(), damaged.right(), local.right()});
+                const mdux::core::Px bottom =
+                    std::min({clip.bottom(), damaged.bottom(), local.bottom()});
+                // Outside this rectangle: nothing it would shade changed, so it is not drawn.
+                if (right <= left || bottom <= top) {
+                    continue;
+                }
+                const VkRect2D scissor{.offset = {area.x + left, area.y + top},
+                                       .extent = {static_cast<std::uint32_t>(right - left),
+                                                  static_cast<std::uint32_t>(bottom - top)}};
+                vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+                vkCmdDrawIndexed(commandBuffer, command.indexCount, 1, firstIndex, vertexOffset,
+                                 0);
+            }
+            if (timed && at + 1 < timedCommands) {
+                vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                    queryPool_, firstQuery + at + 1);
+            }
+            ++at;
+        }
+    }
+    if (timed) {
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool_,
+                            endQuery);
     }
 
     return {};
@@ -0,0 +1,301 @@
+/**
+ * @file DamageTests.cpp
+ * @brief BDD scenarios for mdux.draw.damage, the frame-to-frame comparison behind dirty rectangles.
+ *
+ * @compliance ADR-004 Trust zones in C++ (governed zone)
+ *
+ * A damage tracker can fail in two directions, and only one of them is visible on a screen. Too
+ * much damage costs power. Too little leaves a stale readout on a patient monitor - the previous
+ * heart rate, drawn correctly, at the wrong time - which no pixel test of a single frame catches.
+ * So most of what follows changes exactly one thing between two frames and requires the damage
+ * to cover it, and only then checks that it covers nothing else.
+ */
+
+import std;
+import speclab;
+import mdux.core.result;
+import mdux.core.units;
+import mdux.draw;
+import mdux.draw.damage;
+
+#include "../framework/SpecLabBridge.hpp"
+
+namespace {
+
+using namespace mdux::draw;
+namespace core = mdux::core;
+
+constexpr DrawBudget budget{.maxVertices = 64, .maxIndices = 96, .maxCommands = 4};
+constexpr core::Extent2D viewport{.width = 320, .height = 240};
+constexpr core::ColorRgba8 white{.r = 255, .g = 255, .b = 255, .a = 255};
+constexpr core::ColorRgba8 green{.r = 0, .g = 255, .b = 0, .a = 255};
+
+/// A list and a tracker over storage held by value, so nothing allocates.
+struct Frames {
+    std::array<UiVertex, 64> vertices{};
+    std::array<Index, 96> indices{};
+    std::array<DrawCommand, 4> commands{};
+    std::array<CommandSignature, 4> history{};
+    std::array<core::Rect, 2> rects{};
+    std::optional<DrawList> list;
+    std::optional<DamageTracker> tracker;
+
+    Frames() {
+        auto created = DrawList::create(vertices, indices, commands, budget);
+        auto tracked = DamageTracker::create(history, rects, budget, viewport);
+        if (!created.has_value() || !tracked.has_value()) {
+            throw speclab::core::AssertionFailure("list and tracker must be created",
+                                                  std::source_location::current());
+        }
+        list = std::move(*created);
+        tracker = std::move(*tracked);
+    }
+
+    /// A background, a clipped readout whose colour is `readout`, and `extra` more rectangles.
+    std::span<const core::Rect> frame(core::ColorRgba8 readout, int extra = 0) {
+        list->reset();
+        (void)list->addSolidRect({.x = 0, .y = 0, .width = 320, .height = 240}, white);
+        list->setClip({.x = 200, .y = 10, .width = 100, .height = 40});
+        (void)list->addSolidRect({.x = 190, .y = 20, .width = 50, .height = 20}, readout);
+        for (int i = 0; i < extra; ++i) {
+            list->setClip({.x = 20 * i, .y = 100, .width = 10, .height = 10});
+            (void)list->addSolidRect({.x = 20 * i, .y = 100, .width = 10, .height = 10}, green);
+        }
+        return tracker->update(*list);
+    }
+};
+
+[[nodiscard]] bool covers(std::span<const core::Rect> damage, const core::Rect& area) {
+    // Every pixel of `area` inside some damage rectangle. Small areas only; this is a test.
+    for (core::Px y = area.y; y < area.bottom(); ++y) {
+        for (core::Px x = area.x; x < area.right(); ++x) {
+            const auto inside = [&](const core::Rect& rect) { return rect.contains(x, y); };
+            if (std::ranges::none_of(damage, inside)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Scenarios
+// ---------------------------------------------------------------------------
+
+const mdux::spec::Register firstFrameIsFullyDamaged{
+    "The first frame, and the first after invalidate(), is damaged in full", "evidence-unit", [] {
+        return speclab::Test("damage-first-frame-full")
+            .Given("a fresh tracker", [] {})
+            .When("a frame is compared, then repeated, then compared after invalidate()", [] {})
+            .Then("the fresh and invalidated frames are the whole viewport; the repeat is nothing",
+                  [] {
+                      mdux::spec::Checks checks;
+                      Frames frames;
+                      const core::Rect everything{.x = 0, .y = 0, .width = 320, .height = 240};
+
+                      const auto first = frames.frame(green);
+                      checks.expect(first.size() == 1 && first.front() == everything,
+                                    "the first frame has nothing to compare against");
+
+                      checks.expect(frames.frame(green).empty(),
+                                    "an identical frame damages nothing");
+
+                      frames.tracker->invalidate();
+                      const auto after = frames.frame(green);
+                      checks.expect(after.size() == 1 && after.front() == everything,
+                                    "invalidate() forgets the previous frame");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register changedCommandDamagesItsBounds{
+    "A changed command damages its own clipped bounds and nothing else", "evidence-unit", [] {
+        return speclab::Test("damage-changed-command")
+            .Given("two frames differing only in a clipped readout's colour", [] {})
+            .When("the second is compared against the first", [] {})
+            .Then("the damage is the readout clipped to its clip",
+                  [] {
+                      mdux::spec::Checks checks;
+                      Frames frames;
+                      (void)frames.frame(green);
+                      const auto damage = frames.frame(white);
+                      // The readout spans x 190..240 but its clip starts at 200.
+                      const core::Rect expected{.x = 200, .y = 20, .width = 40, .height = 20};
+                      checks.expect(damage.size() == 1 && damage.front() == expected,
+                                    "exactly the visible readout is damaged");
+                      checks.expect(frames.tracker->bounds() == expected,
+                                    "bounds() is the render area for it");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register addedAndRemovedCommandsAreDamaged{
+    "Commands that appear or disappear damage what they draw or drew", "evidence-unit", [] {
+        return speclab::Test("damage-added-and-removed")
+            .Given("a frame that gains a command, then one that loses it", [] {})
+            .When("each is compared against the one before", [] {})
+            .Then("both damage the command's area, so its pixels are drawn and later cleared",
+                  [] {
+                      mdux::spec::Checks checks;
+                      Frames frames;
+                      const core::Rect extra{.x = 0, .y = 100, .width = 10, .height = 10};
+                      (void)frames.frame(green);
+                      const auto added = frames.frame(green, 1);
+                      checks.expect(covers(added, extra) && frames.tracker->bounds() == extra,
+                                    "an added command damages exactly its area");
+                      const auto removed = frames.frame(green);
+                      checks.expect(covers(removed, extra) && frames.tracker->bounds() == extra,
+                                    "a removed command damages exactly what it drew");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register damageListIsBounded{
+    "More disjoint damage than the list holds collapses to one covering rectangle",
+    "evidence-unit", [] {
+        return speclab::Test("damage-list-is-bounded")
+            .Given("a tracker holding two rectangles, and three disjoint changes", [] {})
+            .When("the frame is compared", [] {})
+            .Then("one rectangle covers every change",
+                  [] {
+                      mdux::spec::Checks checks;
+                      Frames frames;
+                      (void)frames.frame(green);
+                      (void)frames.frame(white);
+                      // The readout changes back and two small, separated commands appear.
+                      (void)frames.frame(green, 2);
+                      const auto damage = frames.tracker->damage();
+                      checks.expect(damage.size() <= frames.rects.size(),
+                                    "never more rectangles than the caller provided");
+                      checks.expect(covers(damage, {.x = 200, .y = 20, .width = 40, .height = 20}),
+                                    "the readout is covered");
+                      checks.expect(covers(damage, {.x = 0, .y = 100, .width = 10, .height = 10}),
+                                    "the first added command is covered");
+                      checks.expect(covers(damage, {.x = 20, .y = 100, .width = 10, .height = 10}),
+                                    "the second added command is covered");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register mergedDamageStaysDisjoint{
+    "Damage that bridges two rectangles merges all three, so none overlap", "evidence-unit", [] {
+        return speclab::Test("damage-merge-stays-disjoint")
+            .Given("two disjoint changes, then a third that touches both", [] {})
+            .When("the frame is compared", [] {})
+            .Then("one rectangle covers all three, and no two listed rectangles overlap",
+                  [] {
+                      mdux::spec::Checks checks;
+                      Frames frames;
+                      std::array<core::Rect, 4> rects{};
+                      auto tracked =
+                          DamageTracker::create(frames.history, rects, budget, viewport);
+                      if (!tracked.has_value()) {
+                          throw speclab::core::AssertionFailure("tracker must be created",
+                                                                std::source_location::current());
+                      }
+                      DamageTracker& tracker = *tracked;
+
+                      constexpr std::array<core::Rect, 3> changes{
+                          core::Rect{.x = 0, .y = 100, .width = 10, .height = 10},
+                          core::Rect{.x = 40, .y = 100, .width = 10, .height = 10},
+                          core::Rect{.x = 5, .y = 100, .width = 40, .height = 10}};
+                      frames.list->reset();
+                      (void)frames.list->addSolidRect({.x = 0, .y = 0, .width = 320,
+                                                       .height = 240},
+                                                      white);
+                      (void)tracker.update(*frames.list);
+                      // Each under its own clip, so each is its own command and its own damage.
+                      // The third, merged into the first, grows to overlap the second.
+                      for (const core::Rect& change : changes) {
+                          frames.list->setClip(change);
+                          (void)frames.list->addSolidRect(change, green);
+                      }
+                      const auto damage = tracker.update(*frames.list);
+
+                      for (std::size_t i = 0; i < damage.size(); ++i) {
+                          for (std::size_t j = i + 1; j < damage.size(); ++j) {
+                              checks.expect(!damage[i].overlaps(damage[j]),
+                                            std::format("rectangles {} and {} are disjoint", i,
+                                                        j));
+                          }
+                      }
+                      checks.expect(damage.size() == 1 &&
+                                        damage.front() == core::Rect{.x = 0, .y = 100,
+                                                                     .width = 50, .height = 10},
+                                    "the three merge into the one rectangle they span");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register retainedSegmentIsComparedByIdentity{
+    "A retained segment is unchanged while it is the same segment under the same clip",
+    "evidence-unit", [] {
+        return speclab::Test("damage-retained-segment")
+            .Given("a frame that replays a baked segment", [] {})
+            .When("it is replayed again, then replayed under a clip", [] {})
+            .Then("the replay damages nothing; the clipped replay damages the segment's area",
+                  [] {
+                      mdux::spec::Checks checks;
+                      constexpr std::array<UiVertex, 3> vertices{
+                          UiVertex{.x = 40.0F, .y = 40.0F}, UiVertex{.x = 80.0F, .y = 40.0F},
+                          UiVertex{.x = 40.0F, .y = 70.0F}};
+                      constexpr std::array<Index, 3> indices{0, 1, 2};
+                      const auto segment = DrawSegment::create(7, vertices, indices);
+                      if (!segment.has_value()) {
+                          throw speclab::core::AssertionFailure("segment must be created",
+                                                                std::source_location::current());
+                      }
+
+                      Frames frames;
+                      const auto replay = [&](const core::Rect& clip) {
+                          frames.list->reset();
+                          frames.list->setClip(clip);
+                          (void)frames.list->addSegment(*segment);
+                          return frames.tracker->update(*frames.list);
+                      };
+                      (void)replay({});
+                      checks.expect(replay({}).empty(), "the same segment again is no damage");
+                      const auto clipped = replay({.x = 0, .y = 0, .width = 60, .height = 240});
+                      checks.expect(covers(clipped,
+                                           {.x = 40, .y = 40, .width = 40, .height = 30}),
+                                    "a new clip on the segment damages what it drew before");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register trackerStorageIsChecked{
+    "A tracker over too little storage is refused at create()", "evidence-unit", [] {
+        return speclab::Test("damage-storage-checked")
+            .Given("history smaller than the command budget, no rectangles, or no viewport", [] {})
+            .When("a tracker is created over each", [] {})
+            .Then("each is refused with its reason",
+                  [] {
+                      mdux::spec::Checks checks;
+                      std::array<CommandSignature, 3> shortHistory{};
+                      std::array<CommandSignature, 4> history{};
+                      std::array<core::Rect, 1> rects{};
+                      const auto tooShort =
+                          DamageTracker::create(shortHistory, rects, budget, viewport);
+                      checks.expect(!tooShort.has_value() &&
+                                        tooShort.error() == DrawError::StorageTooSmall,
+                                    "history below maxCommands is StorageTooSmall");
+                      const auto noRects = DamageTracker::create(history, {}, budget, viewport);
+                      checks.expect(!noRects.has_value() &&
+                                        noRects.error() == DrawError::StorageTooSmall,
+                                    "no damage rectangles is StorageTooSmall");
+                      const auto noViewport = DamageTracker::create(history, rects, budget, {});
+                      checks.expect(!noViewport.has_value() &&
+                                        noViewport.error() == DrawError::EmptyBudget,
+                                    "an empty viewport is EmptyBudget");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+}  // namespace
@@ -271,14 +271,15 @@ const mdux::spec::Register budgetBeyondIndexWidthRejected{
         auto state = std::make_shared<State>();
 
         return speclab::Test("draw-budget-beyond-index-width-rejected")
-            .Given("a budget one past the 16-bit index width",
+            .Given("a budget one past what a command's vertex offset can address",
                    [state] {
-                       // 16-bit indices cap a list at 65536 vertices. Accepting a larger budget
-                       // would produce wrapped indices - geometry pointing at the wrong vertices,
-                       // with no error anywhere.
+                       // 16-bit indices cap a batch at 65536 vertices, and a list past that
+                       // splits into batches. Past the signed 32-bit vertex offset a command
+                       // records, the offset would wrap - geometry pointing at the wrong
+                       // vertices, with no error anywhere.
                        state->error = requireRejected(
                            DrawList::create(state->vertices, state->indices, state->commands,
-                                            DrawBudget{.maxVertices = maxIndexableVertices + 1,
+                                            DrawBudget{.maxVertices = maxListVertices + 1U,
                                                        .maxIndices = 6,
                                                        .maxCommands = 1}),
                            "the oversize budget");
@@ -984,6 +985,679 @@ const mdux::spec::Register byteIdenticalBuffers{
             .Execute();
     }};
 
+// ---------------------------------------------------------------------------
+// Retained segments
+// ---------------------------------------------------------------------------
+
+const mdux::spec::Register segmentBakedFromList{
+    "A segment baked from a list replays as one command that costs no geometry",
+    "evidence-unit", [] {
+        return speclab::Test("draw-segment-replays-by-reference")
+            .Given("a segment baked from two rectangles, and a frame list", [] {})
+            .When("the segment is appended between two rectangles", [] {})
+            .Then("it is one command naming the segment, and the rectangles around it are not "
+                  "merged into it",
+                  [] {
+                      SmallStorage staticStorage;
+                      DrawList baked = requireCreated(staticStorage.list(), "the static list");
+                      requireAdded(baked.addSolidRect(rect, red), "first static rect");
+                      requireAdded(baked.addSolidRect({.x = 100, .y = 5, .width = 8, .height = 9},
+                                                      red),
+                                   "second static rect");
+                      const auto created = DrawSegment::create(3, baked.vertices(), baked.indices());
+                      if (!created.has_value()) {
+                          throw speclab::core::AssertionFailure(
+                              std::format("segment rejected: {}", describe(created.error())),
+                              std::source_location::current());
+                      }
+                      const DrawSegment& segment = *created;
+
+                      Storage<16, 24, 4> frameStorage;
+                      DrawList list = requireCreated(frameStorage.list(), "the frame list");
+                      requireAdded(list.addSolidRect(rect, red), "rect before");
+                      requireAdded(list.addSegment(segment), "addSegment");
+                      requireAdded(list.addSolidRect(rect, red), "rect after");
+
+                      if (list.commands().size() != 3) {
+                          throw speclab::core::AssertionFailure(
+                              std::format("expected 3 commands, got {}", list.commands().size()),
+                              std::source_location::current());
+                      }
+                      mdux::spec::Checks checks;
+                      const DrawCommand& replay = list.commands()[1];
+                      checks.expect(replay.segment == &segment, "the command names the segment");
+                      checks.expect(replay.firstIndex == 0 && replay.indexCount == 12,
+                                    "it spans the segment's own 12 indices");
+                      checks.expect(list.vertices().size() == 8 && list.indices().size() == 12,
+                                    "the segment took nothing from the list's geometry budget");
+                      checks.expect(list.commands()[2].segment == nullptr &&
+                                        list.commands()[2].firstIndex == 6,
+                                    "the rectangle after it starts a command of its own");
+                      checks.expect(segment.id() == 3, "the id is the caller's");
+                      checks.expect(segment.bounds() ==
+                                        core::Rect{.x = 10, .y = 5, .width = 98, .height = 55},
+                                    "the bounds cover both rectangles");
+                      checks.expect(segment.hash() ==
+                                        contentHash(baked.vertices(), baked.indices()),
+                                    "the hash is the content hash, taken once");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register segmentCostsACommand{
+    "A segment needs a free command and nothing else", "evidence-unit", [] {
+        return speclab::Test("draw-segment-command-budget")
+            .Given("a list whose command budget is one, already used", [] {})
+            .When("a segment is appended", [] {})
+            .Then("it is refused with CommandBudgetExceeded and nothing is recorded",
+                  [] {
+                      constexpr std::array<UiVertex, 3> vertices{};
+                      constexpr std::array<Index, 3> indices{0, 1, 2};
+                      const auto segment = DrawSegment::create(0, vertices, indices);
+                      Storage<4, 6, 1> storage;
+                      DrawList list = requireCreated(storage.list(), "the list");
+                      requireAdded(list.addSolidRect(rect, red), "the only command");
+
+                      mdux::spec::Checks checks;
+                      checks.expect(segment.has_value(), "a single triangle is a valid segment");
+                      if (segment.has_value()) {
+                          const auto refused = list.addSegment(*segment);
+                          checks.expect(!refused.has_value() &&
+                                            refused.error() == DrawError::CommandBudgetExceeded,
+                                        "refused for the command, not for geometry");
+                      }
+                      checks.expect(list.commands().size() == 1, "nothing was recorded");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register invalidSegmentRefused{
+    "A segment the renderer could not trust is refused when it is baked", "evidence-unit", [] {
+        return speclab::Test("draw-segment-invalid")
+            .Given("no indices, a partial triangle, and an index past the vertices", [] {})
+            .When("a segment is created from each", [] {})
+            .Then("each is InvalidSegment",
+                  [] {
+                      constexpr std::array<UiVertex, 3> vertices{};
+                      constexpr std::array<Index, 4> partial{0, 1, 2, 0};
+                      constexpr std::array<Index, 3> pastEnd{0, 1, 3};
+                      mdux::spec::Checks checks;
+                      for (const std::span<const Index> indices :
+                           {std::span<const Index>{}, std::span<const Index>{partial},
+                            std::span<const Index>{pastEnd}}) {
+                          const auto segment = DrawSegment::create(0, vertices, indices);
+                          checks.expect(!segment.has_value() &&
+                                            segment.error() == DrawError::InvalidSegment,
+                                        std::format("{} indices are refused", indices.size()));
+                      }
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+// ---------------------------------------------------------------------------
+// Batched rectangles
+// ---------------------------------------------------------------------------
+
+const mdux::spec::Register batchMatchesSingleAdds{
+    "A batch records exactly what one add per rectangle would", "evidence-unit", [] {
+        return speclab::Test("draw-batch-matches-single")
+            .Given("three rectangles, added once as batches and once one at a time", [] {})
+            .When("both lists are compared", [] {})
+            .Then("vertices, indices and commands are byte-identical",
+                  [] {
+                      constexpr std::array<core::Rect, 3> bars{
+                          core::Rect{.x = 0, .y = 10, .width = 4, .height = 30},
+                          core::Rect{.x = 5, .y = 20, .width = 4, .height = 20},
+                          core::Rect{.x = 10, .y = 5, .width = 4, .height = 35}};
+                      constexpr std::array<core::ColorRgba8, 3> colors{
+                          red, core::ColorRgba8{.r = 0, .g = 255, .b = 0, .a = 255},
+                          core::ColorRgba8{.r = 0, .g = 0, .b = 255, .a = 128}};
+                      constexpr std::array<core::Rect, 3> glyphs{
+                          core::Rect{.x = 0, .y = 0, .width = 4, .height = 30},
+                          core::Rect{.x = 4, .y = 0, .width = 4, .height = 20},
+                          core::Rect{.x = 8, .y = 0, .width = 4, .height = 35}};
+                      const std::array<core::ColorRgba8, 1> ink{red};
+
+                      Storage<24, 36, 2> batchedStorage;
+                      Storage<24, 36, 2> singleStorage;
+                      DrawList batched = requireCreated(batchedStorage.list(), "batched list");
+                      DrawList single = requireCreated(singleStorage.list(), "single list");
+
+                      requireAdded(batched.addSolidRects(bars, colors), "solid batch");
+                      requireAdded(batched.addRects(bars, glyphs, ink, DrawMode::CoverageR8),
+                                   "glyph batch");
+                      for (std::size_t i = 0; i < bars.size(); ++i) {
+                          requireAdded(single.addSolidRect(bars[i], colors[i]), "solid rect");
+                      }
+                      for (std::size_t i = 0; i < bars.size(); ++i) {
+                          requireAdded(single.addRect(bars[i], red, DrawMode::CoverageR8,
+                                                      glyphs[i]),
+                                       "glyph rect");
+                      }
+
+                      mdux::spec::Checks checks;
+                      checks.expect(std::ranges::equal(batched.vertices(), single.vertices()),
+                                    "the vertices are the same");
+                      checks.expect(std::ranges::equal(batched.indices(), single.indices()),
+                                    "the indices are the same");
+                      checks.expect(std::ranges::equal(batched.commands(), single.commands()),
+                                    "both batches extend one command, as single adds do");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register batchIsAllOrNothing{
+    "A refused batch leaves the list exactly as it was", "evidence-unit", [] {
+        return speclab::Test("draw-batch-all-or-nothing")
+            .Given("a list with room for three more rectangles", [] {})
+            .When("batches that are too large, degenerate, or mismatched are added", [] {})
+            .Then("each is refused whole, and a batch that exactly fits is recorded whole",
+                  [] {
+                      SmallStorage storage;
+                      DrawList list = requireCreated(storage.list(), "small list");
+                      requireAdded(list.addSolidRect(rect, red), "first rectangle");
+
+                      constexpr std::array<core::Rect, 4> four{rect, rect, rect, rect};
+                      constexpr std::array<core::Rect, 3> lastDegenerate{
+                          rect, rect, core::Rect{.x = 0, .y = 0, .width = 5, .height = 0}};
+                      const std::array<core::ColorRgba8, 1> one{red};
+                      const std::array<core::ColorRgba8, 2> two{red, red};
+
+                      mdux::spec::Checks checks;
+                      checks.expect(requireRejectedAdd(list.addSolidRects(four, one), "four") ==
+                                        DrawError::VertexBudgetExceeded,
+                                    "four rectangles do not fit in the room for three");
+                      checks.expect(requireRejectedAdd(list.addSolidRects(lastDegenerate, one),
+                                                       "degenerate") ==
+                                        DrawError::DegenerateRect,
+                                    "one degenerate rectangle refuses the batch");
+                      checks.expect(requireRejectedAdd(list.addSolidRects(lastDegenerate, two),
+                                                       "mismatched colours") ==
+                                        DrawError::BatchSizeMismatch,
+                                    "two colours for three rectangles is neither rule");
+                      checks.expect(requireRejectedAdd(list.addRects(lastDegenerate, four, one,
+                                                                     DrawMode::SampledRgba),
+                                                       "mismatched uvs") ==
+                                        DrawError::BatchSizeMismatch,
+                                    "uvs must be one per rectangle");
+                      checks.expect(list.vertices().size() == 4 && list.indices().size() == 6 &&
+                                        list.commands().size() == 1,
+                                    "nothing from a refused batch was recorded");
+
+                      requireAdded(list.addSolidRects({}, one), "empty batch");
+                      checks.expect(list.vertices().size() == 4,
+                                    "an empty batch records nothing");
+
+                      requireAdded(list.addSolidRects(std::span{four}.first(3), one),
+                                   "batch that fits");
+                      checks.expect(list.vertices().size() == 16 && list.indices().size() == 24,
+                                    "a batch that exactly fills the budget is recorded");
+                      checks.expect(list.indices()[23] == 15,
+                                    "the batch's indices continue from the list's vertices");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+// ---------------------------------------------------------------------------
+// Compaction
+// ---------------------------------------------------------------------------
+
+constexpr core::Rect leftPanel{.x = 0, .y = 0, .width = 100, .height = 100};
+constexpr core::Rect rightPanel{.x = 100, .y = 0, .width = 100, .height = 100};
+
+const mdux::spec::Register compactMergesPanels{
+    "Compaction regroups two panels drawn alternately into one command each", "evidence-unit",
+    [] {
+        return speclab::Test("draw-compact-merges-panels")
+            .Given("two side-by-side panels, each drawn twice, alternately", [] {})
+            .When("the list is compacted", [] {})
+            .Then("there is one command per panel, in first-drawn order, and each panel's "
+                  "indices keep their order",
+                  [] {
+                      Storage<16, 24, 4> storage;
+                      DrawList list = requireCreated(storage.list(), "the list");
+                      for (const core::Px y : {10, 40}) {
+                          list.setClip(leftPanel);
+                          requireAdded(list.addSolidRect({.x = 10, .y = y, .width = 20,
+                                                          .height = 20},
+                                                         red),
+                                       "left rect");
+                          list.setClip(rightPanel);
+                          requireAdded(list.addSolidRect({.x = 110, .y = y, .width = 20,
+                                                          .height = 20},
+                                                         red),
+                                       "right rect");
+                      }
+                      std::array<UiVertex, 16> vertices{};
+                      std::array<Index, 24> indices{};
+                      std::ranges::copy(list.vertices(), vertices.begin());
+                      std::ranges::copy(list.indices(), indices.begin());
+
+                      mdux::spec::Checks checks;
+                      checks.expect(list.commands().size() == 4, "recorded as four commands");
+                      checks.expect(list.compact() == 2, "compaction removes two");
+                      checks.expect(std::ranges::equal(
+                                        list.commands(),
+                                        std::array{DrawCommand{.firstIndex = 0, .indexCount = 12,
+                                                               .clip = leftPanel},
+                                                   DrawCommand{.firstIndex = 12,
+                                                               .indexCount = 12,
+                                                               .clip = rightPanel}}),
+                                    "the left panel's command, then the right panel's");
+                      checks.expect(std::ranges::equal(list.vertices(), vertices),
+                                    "no vertex moved");
+                      const auto span = std::span<const Index>{indices};
+                      checks.expect(
+                          std::ranges::equal(list.indices().subspan(0, 6), span.subspan(0, 6)) &&
+                              std::ranges::equal(list.indices().subspan(6, 6),
+                                                 span.subspan(12, 6)) &&
+                              std::ranges::equal(list.indices().subspan(12, 6),
+                                                 span.subspan(6, 6)) &&
+                              std::ranges::equal(list.indices().subspan(18, 6),
+                                                 span.subspan(18, 6)),
+                          "each panel's triangles are the ones it recorded, in recorded order");
+                      checks.expect(list.compact() == 0, "a compacted list is already compact");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register compactKeepsOverlaps{
+    "Compaction never reorders commands whose painted areas overlap", "evidence-unit", [] {
+        return speclab::Test("draw-compact-keeps-painter-order")
+            .Given("a rect, an overlapping rect under another clip, and a third rect under the "
+                   "first clip that overlaps the second",
+                   [] {})
+            .When("the list is compacted", [] {})
+            .Then("nothing moves; once the second clip cuts the overlap away, the third merges",
+                  [] {
+                      const auto build = [](DrawList& list, const core::Rect& middleClip) {
+                          list.setClip(leftPanel);
+                          requireAdded(list.addSolidRect({.x = 10, .y = 10, .width = 20,
+                                                          .height = 20},
+                                                         red),
+                                       "first rect");
+                          list.setClip(middleClip);
+                          requireAdded(list.addSolidRect({.x = 15, .y = 15, .width = 20,
+                                                          .height = 20},
+                                                         red),
+                                       "overlapping rect");
+                          list.setClip(leftPanel);
+                          requireAdded(list.addSolidRect({.x = 30, .y = 30, .width = 10,
+                                                          .height = 10},
+                                                         red),
+                                       "third rect");
+                      };
+
+                      Storage<12, 18, 3> overlapping;
+                      DrawList kept = requireCreated(overlapping.list(), "overlapping list");
+                      build(kept, core::Rect{});
+                      std::array<Index, 18> before{};
+                      std::ranges::copy(kept.indices(), before.begin());
+
+                      Storage<12, 18, 3> clipped;
+                      DrawList merged = requireCreated(clipped.list(), "clipped list");
+                      build(merged, core::Rect{.x = 0, .y = 0, .width = 25, .height = 25});
+
+                      mdux::spec::Checks checks;
+                      checks.expect(kept.compact() == 0 && kept.commands().size() == 3,
+                                    "all three commands stay");
+                      checks.expect(std::ranges::equal(kept.indices(), before),
+                                    "and no index moved");
+                      checks.expect(merged.compact() == 1 && merged.commands().size() == 2,
+                                    "clipped to (0,0)-(25,25), the middle rect cannot reach the "
+                                    "third, which joins the first");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register compactJumpsSegments{
+    "Compaction moves a command past a segment it does not overlap, never into one",
+    "evidence-unit", [] {
+        return speclab::Test("draw-compact-segments")
+            .Given("a left-panel rect, a segment in the right panel, and a left-panel rect", [] {})
+            .When("the list is compacted", [] {})
+            .Then("the rects share one command and the segment command is untouched",
+                  [] {
+                      SmallStorage bakedStorage;
+                      DrawList baked = requireCreated(bakedStorage.list(), "the static list");
+                      requireAdded(baked.addSolidRect({.x = 110, .y = 10, .width = 20,
+                                                       .height = 20},
+                                                      red),
+                                   "static rect");
+                      const auto segment = DrawSegment::create(0, baked.vertices(),
+                                                               baked.indices());
+                      if (!segment.has_value()) {
+                          throw speclab::core::AssertionFailure(
+                              std::format("segment rejected: {}", describe(segment.error())),
+                              std::source_location::current());
+                      }
+
+                      Storage<8, 12, 3> storage;
+                      DrawList list = requireCreated(storage.list(), "the frame list");
+                      list.setClip(leftPanel);
+                      requireAdded(list.addSolidRect(rect, red), "rect before");
+                      list.setClip(rightPanel);
+                      requireAdded(list.addSegment(*segment), "the segment");
+                      list.setClip(leftPanel);
+                      requireAdded(list.addSolidRect({.x = 10, .y = 70, .width = 5, .height = 5},
+                                                     red),
+                                   "rect after");
+
+                      mdux::spec::Checks checks;
+                      checks.expect(list.compact() == 1, "one command removed");
+                      checks.expect(list.commands().size() == 2 &&
+                                        list.commands()[0] ==
+                                            DrawCommand{.firstIndex = 0,
+                                                        .indexCount = 12,
+                                                        .clip = leftPanel} &&
+                                        list.commands()[1] ==
+                                            DrawCommand{.firstIndex = 0,
+                                                        .indexCount = 6,
+                                                        .clip = rightPanel,
+                                                        .segment = &*segment},
+                                    "the rects, then the segment as it was recorded");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+// ---------------------------------------------------------------------------
+// Shards
+// ---------------------------------------------------------------------------
+
+constexpr std::array<DrawBudget, 3> panelBudgets{
+    DrawBudget{.maxVertices = 8, .maxIndices = 12, .maxCommands = 2},
+    DrawBudget{.maxVertices = 4, .maxIndices = 6, .maxCommands = 1},
+    DrawBudget{.maxVertices = 8, .maxIndices = 12, .maxCommands = 2}};
+
+/// Three panels, the second and third starting under the same clip.
+void buildPanel(DrawList& list, std::size_t panel) {
+    constexpr core::Rect waveforms{.x = 0, .y = 0, .width = 100, .height = 50};
+    constexpr core::Rect numerics{.x = 100, .y = 0, .width = 50, .height = 50};
+    constexpr core::Rect alarms{.x = 0, .y = 50, .width = 150, .height = 20};
+    switch (panel) {
+    case 0:
+        list.setClip(waveforms);
+        requireAdded(list.addSolidRect({.x = 0, .y = 0, .width = 100, .height = 50}, red), "bg");
+        requireAdded(list.addSolidRect({.x = 0, .y = 20, .width = 100, .height = 2}, red), "bar");
+        break;
+    case 1:
+        list.setClip(numerics);
+        requireAdded(list.addSolidRect({.x = 110, .y = 10, .width = 30, .height = 30}, red),
+                     "digit");
+        break;
+    default:
+        list.setClip(numerics);
+        requireAdded(list.addSolidRect({.x = 110, .y = 40, .width = 30, .height = 5}, red),
+                     "unit");
+        list.setClip(alarms);
+        requireAdded(list.addSolidRect({.x = 0, .y = 50, .width = 150, .height = 20}, red),
+                     "banner");
+        break;
+    }
+}
+
+const mdux::spec::Register shardsMergeLikeSerial{
+    "Shards built on separate threads merge into exactly the serial frame", "evidence-unit",
+    [] {
+        return speclab::Test("draw-shard-merge-matches-serial")
+            .Given("three panels, built once in order on one list and once as concurrent shards",
+                   [] {})
+            .When("the shards are merged in panel order", [] {})
+            .Then("vertices, indices and commands are byte-identical to the serial build",
+                  [] {
+                      Storage<20, 30, 5> serialStorage;
+                      DrawList serial = requireCreated(serialStorage.list(), "serial list");
+                      for (std::size_t panel = 0; panel < panelBudgets.size(); ++panel) {
+                          buildPanel(serial, panel);
+                      }
+
+                      Storage<20, 30, 5> frameStorage;
+                      DrawList frame = requireCreated(frameStorage.list(), "frame list");
+                      std::array shards{requireCreated(frame.shard(panelBudgets, 0), "shard 0"),
+                                        requireCreated(frame.shard(panelBudgets, 1), "shard 1"),
+                                        requireCreated(frame.shard(panelBudgets, 2), "shard 2")};
+                      {
+                          // Started last panel first, so finishing order is not panel order.
+                          std::array<std::jthread, 3> builders;
+                          for (std::size_t panel = shards.size(); panel-- > 0;) {
+                              builders[panel] = std::jthread{
+                                  [&shards, panel] { buildPanel(shards[panel], panel); }};
+                          }
+                      }
+                      requireAdded(frame.merge(shards), "merge");
+
+                      mdux::spec::Checks checks;
+                      checks.expect(std::ranges::equal(frame.vertices(), serial.vertices()),
+                                    "the vertices are the serial ones");
+                      checks.expect(std::ranges::equal(frame.indices(), serial.indices()),
+                                    "the indices are rebased onto the merged vertices");
+                      checks.expect(std::ranges::equal(frame.commands(), serial.commands()),
+                                    "the third panel's first rect extends the second's command");
+                      checks.expect(frame.commands().size() == 3,
+                                    "four clip runs, three commands");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register shardMismatchRefused{
+    "A merge of lists that are not this list's shards, in order, is refused whole",
+    "evidence-unit", [] {
+        return speclab::Test("draw-shard-merge-refused")
+            .Given("shards out of order, a foreign list, oversized budgets and a full list", [] {})
+            .When("each is carved or merged", [] {})
+            .Then("each is refused and the list stays empty",
+                  [] {
+                      Storage<20, 30, 5> frameStorage;
+                      DrawList frame = requireCreated(frameStorage.list(), "frame list");
+                      std::array swapped{requireCreated(frame.shard(panelBudgets, 1), "shard 1"),
+                                         requireCreated(frame.shard(panelBudgets, 0), "shard 0")};
+                      buildPanel(swapped[0], 1);
+                      buildPanel(swapped[1], 0);
+                      SmallStorage foreignStorage;
+                      std::array foreign{requireCreated(foreignStorage.list(), "foreign list")};
+                      constexpr std::array<DrawBudget, 2> tooLarge{
+                          DrawBudget{.maxVertices = 16, .maxIndices = 24, .maxCommands = 2},
+                          DrawBudget{.maxVertices = 8, .maxIndices = 12, .maxCommands = 2}};
+
+                      mdux::spec::Checks checks;
+                      checks.expect(requireRejectedAdd(frame.merge(swapped), "swapped") ==
+                                        DrawError::ShardMismatch,
+                                    "shards out of order are refused");
+                      checks.expect(requireRejectedAdd(frame.merge(foreign), "foreign") ==
+                                        DrawError::ShardMismatch,
+                                    "a list over other storage is refused");
+                      checks.expect(frame.empty(), "nothing was merged");
+                      checks.expect(requireRejected(frame.shard(tooLarge, 1), "too large") ==
+                                        DrawError::StorageTooSmall,
+                                    "shards summing past the budget are refused");
+                      checks.expect(requireRejected(frame.shard(panelBudgets, 3), "no shard 3") ==
+                                        DrawError::ShardMismatch,
+                                    "a shard past the last budget is refused");
+
+                      requireAdded(frame.merge(std::span{swapped}.last(1)), "shard 0 alone");
+                      checks.expect(requireRejectedAdd(frame.merge(std::span{swapped}.last(1)),
+                                                       "again") == DrawError::ShardMismatch,
+                                    "a list that is no longer empty takes no more shards");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+// ---------------------------------------------------------------------------
+// Batches past the 16-bit index width
+// ---------------------------------------------------------------------------
+
+const mdux::spec::Register batchSplitPastIndexWidth{
+    "A list budgeted past 65536 vertices splits into batches rather than wrapping",
+    "evidence-unit", [] {
+        return speclab::Test("draw-batch-split-past-index-width")
+            .Given("a list budgeted for 16386 rectangles, one more than a batch holds", [] {})
+            .When("16385 rectangles are added in one call and then one more alone", [] {})
+            .Then("a second command starts at vertex 65536, its indices counting from there",
+                  [] {
+                      constexpr std::size_t rects = 16386;
+                      constexpr DrawBudget budget{
+                          .maxVertices = static_cast<std::uint32_t>(rects * 4),
+                          .maxIndices = static_cast<std::uint32_t>(rects * 6),
+                          .maxCommands = 2};
+                      // Too large for the stack; a test may allocate, the list still does not.
+                      std::vector<UiVertex> vertices(budget.maxVertices);
+                      std::vector<Index> indices(budget.maxIndices);
+                      std::array<DrawCommand, 2> commands{};
+                      DrawList list = requireCreated(
+                          DrawList::create(vertices, indices, commands, budget), "large list");
+                      const std::vector<core::Rect> batch(rects - 1, rect);
+                      const std::array<core::ColorRgba8, 1> one{red};
+
+                      requireAdded(list.addSolidRects(batch, one), "the batch");
+                      mdux::spec::Checks checks;
+                      checks.expect(list.commands().size() == 2,
+                                    "the batch that crosses 65536 vertices takes two commands");
+                      if (list.commands().size() == 2) {
+                          const DrawCommand& first = list.commands()[0];
+                          const DrawCommand& second = list.commands()[1];
+                          checks.expect(first.vertexOffset == 0 &&
+                                            first.indexCount == 16384 * 6,
+                                        "the first holds exactly one full batch");
+                          checks.expect(second.vertexOffset == maxIndexableVertices &&
+                                            second.firstIndex == 16384 * 6 &&
+                                            second.indexCount == 6,
+                                        "the second starts at vertex 65536");
+                          checks.expect(list.indices()[second.firstIndex] == 0 &&
+                                            list.indices()[second.firstIndex + 5] == 3,
+                                        "and its indices count from its own batch");
+                      }
+                      checks.expect(list.indices()[16384 * 6 - 1] == 65535,
+                                    "the last index of a full batch is 65535, not wrapped");
+
+                      requireAdded(list.addSolidRect(rect, red), "one more");
+                      checks.expect(list.commands().size() == 2 &&
+                                        list.commands()[1].indexCount == 12 &&
+                                        list.indices().back() == 7,
+                                    "a rectangle in the same batch extends its command");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+// ---------------------------------------------------------------------------
+// Frame hash and diff
+// ---------------------------------------------------------------------------
+
+constexpr std::array<core::Rect, 3> diffClips{
+    core::Rect{.x = 0, .y = 0, .width = 50, .height = 50},
+    core::Rect{.x = 50, .y = 0, .width = 50, .height = 50},
+    core::Rect{.x = 100, .y = 0, .width = 50, .height = 50}};
+
+/// One rect under each clip, the middle one in `middle`.
+void buildDiffFrame(DrawList& list, core::ColorRgba8 middle) {
+    for (std::size_t i = 0; i < diffClips.size(); ++i) {
+        list.setClip(diffClips[i]);
+        requireAdded(list.addSolidRect({.x = diffClips[i].x + 5, .y = 5, .width = 10,
+                                        .height = 10},
+                                       i == 1 ? middle : red),
+                     "panel rect");
+    }
+}
+
+const mdux::spec::Register hashTracksContent{
+    "The frame hash follows the buffers' content, not their storage or history",
+    "evidence-unit", [] {
+        return speclab::Test("draw-hash-tracks-content")
+            .Given("two lists built alike in separate storage, and one with a colour changed",
+                   [] {})
+            .When("their hashes are compared", [] {})
+            .Then("alike lists hash equal, the changed one differs, and a recomputed hash "
+                  "matches the running one",
+                  [] {
+                      constexpr core::ColorRgba8 green{.r = 0, .g = 255, .b = 0, .a = 255};
+                      Storage<16, 24, 4> firstStorage;
+                      Storage<16, 24, 4> secondStorage;
+                      Storage<16, 24, 4> changedStorage;
+                      DrawList first = requireCreated(firstStorage.list(), "first");
+                      DrawList second = requireCreated(secondStorage.list(), "second");
+                      DrawList changed = requireCreated(changedStorage.list(), "changed");
+                      const std::uint64_t empty = first.hash();
+                      buildDiffFrame(first, red);
+                      buildDiffFrame(second, red);
+                      buildDiffFrame(changed, green);
+
+                      mdux::spec::Checks checks;
+                      checks.expect(first.hash() == second.hash(),
+                                    "byte-identical buffers hash equal");
+                      checks.expect(first.hash() != changed.hash(),
+                                    "one changed colour changes the hash");
+                      checks.expect(first.hash() != empty, "content changes the hash");
+
+                      // merge() recomputes from the buffers; the serial list never did.
+                      Storage<16, 24, 4> shardedStorage;
+                      DrawList sharded = requireCreated(shardedStorage.list(), "sharded");
+                      constexpr std::array<DrawBudget, 1> whole{
+                          DrawBudget{.maxVertices = 16, .maxIndices = 24, .maxCommands = 4}};
+                      std::array shards{requireCreated(sharded.shard(whole, 0), "shard")};
+                      buildDiffFrame(shards[0], red);
+                      requireAdded(sharded.merge(shards), "merge");
+                      checks.expect(sharded.hash() == first.hash(),
+                                    "a recomputed hash equals the running one");
+
+                      first.reset();
+                      checks.expect(first.hash() == empty, "reset restores the empty hash");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register diffFindsChangedRange{
+    "diff() reports the commands two frames do not share", "evidence-unit", [] {
+        return speclab::Test("draw-diff-changed-range")
+            .Given("a three-panel frame, the same with its middle panel recoloured, and the same "
+                   "with a fourth command",
+                   [] {})
+            .When("each is diffed against the first", [] {})
+            .Then("the middle command, nothing, and the appended command are reported",
+                  [] {
+                      constexpr core::ColorRgba8 green{.r = 0, .g = 255, .b = 0, .a = 255};
+                      Storage<16, 24, 4> baseStorage;
+                      Storage<16, 24, 4> sameStorage;
+                      Storage<16, 24, 4> changedStorage;
+                      Storage<16, 24, 4> longerStorage;
+                      DrawList base = requireCreated(baseStorage.list(), "base");
+                      DrawList same = requireCreated(sameStorage.list(), "same");
+                      DrawList changed = requireCreated(changedStorage.list(), "changed");
+                      DrawList longer = requireCreated(longerStorage.list(), "longer");
+                      buildDiffFrame(base, red);
+                      buildDiffFrame(same, red);
+                      buildDiffFrame(changed, green);
+                      buildDiffFrame(longer, red);
+                      longer.setClip({});
+                      requireAdded(longer.addSolidRect(rect, red), "fourth command");
+
+                      mdux::spec::Checks checks;
+                      checks.expect(same.diff(base).identical(),
+                                    "separate storage, same content: identical");
+                      checks.expect(changed.diff(base) ==
+                                        DrawDiff{.first = 1, .count = 1, .otherCount = 1},
+                                    "only the middle command differs");
+                      checks.expect(longer.diff(base) ==
+                                        DrawDiff{.first = 3, .count = 1, .otherCount = 0},
+                                    "the appended command is this list's alone");
+                      checks.expect(base.diff(longer) ==
+                                        DrawDiff{.first = 3, .count = 0, .otherCount = 1},
+                                    "and the other list's, seen from the other side");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
 const mdux::spec::Register drawErrorDescriptions{
     "Every DrawError has its own description", "evidence-unit", [] {
         return speclab::Test("draw-error-descriptions")
@@ -991,7 +1665,7 @@ const mdux::spec::Register drawErrorDescriptions{
             .When("each is described", [] {})
             .Then("each has a unique, non-empty description",
                   [] {
-                      constexpr std::array<DrawError, 7> all{
+                      constexpr std::array<DrawError, 11> all{
                           DrawError::EmptyBudget,
                           DrawError::BudgetExceedsIndexWidth,
                           DrawError::StorageTooSmall,
@@ -999,6 +1673,10 @@ const mdux::spec::Register drawErrorDescriptions{
                           DrawError::IndexBudgetExceeded,
                           DrawError::CommandBudgetExceeded,
                           DrawError::DegenerateRect,
+                          DrawError::InvalidSegment,
+                          DrawError::BatchSizeMismatch,
+                          DrawError::InvalidPolyline,
+                          DrawError::ShardMismatch,
                       };
                       std::vector<std::string_view> seen;
                       mdux::spec::Checks checks;
@@ -0,0 +1,222 @@
+/**
+ * @file OcclusionTests.cpp
+ * @brief BDD scenarios for mdux.draw occlusion culling.
+ *
+ * @compliance ADR-004 Trust zones in C++ (governed zone)
+ *
+ * Culling is only worth having if it is invisible, so most of these scenarios are about what it
+ * must leave alone: a rectangle drawn after its would-be occluder, an occluder that is
+ * translucent or textured, one whose clip does not reach, and a retained segment. The pixel-level
+ * claim is made against the GPU in `tests/render/PixelTests.cpp`.
+ */
+
+import std;
+import speclab;
+import mdux.core.result;
+import mdux.core.units;
+import mdux.draw;
+
+#include "../framework/SpecLabBridge.hpp"
+
+namespace {
+
+using namespace mdux::draw;
+namespace core = mdux::core;
+
+constexpr core::Extent2D viewport{.width = 100, .height = 100};
+constexpr core::Px tileSize = 16;
+constexpr core::ColorRgba8 red{.r = 255, .g = 0, .b = 0, .a = 255};
+constexpr core::ColorRgba8 blue{.r = 0, .g = 0, .b = 255, .a = 255};
+constexpr core::Rect panel{.x = 0, .y = 0, .width = 60, .height = 60};
+constexpr core::Rect hidden{.x = 10, .y = 10, .width = 20, .height = 20};
+
+/// A list and a grid over storage held by value, so nothing allocates.
+struct Scene {
+    std::array<UiVertex, 32> vertices{};
+    std::array<Index, 48> indices{};
+    std::array<DrawCommand, 4> commands{};
+    std::array<core::Rect, 49> tiles{};
+    std::optional<DrawList> list;
+    std::optional<OcclusionGrid> grid;
+
+    Scene() {
+        auto created = DrawList::create(vertices, indices, commands,
+                                        {.maxVertices = 32, .maxIndices = 48, .maxCommands = 4});
+        auto gridCreated = OcclusionGrid::create(tiles, viewport, tileSize);
+        if (!created.has_value() || !gridCreated.has_value()) {
+            throw speclab::core::AssertionFailure("the list and grid must be created",
+                                                  std::source_location::current());
+        }
+        list = std::move(*created);
+        grid = std::move(*gridCreated);
+    }
+
+    std::uint32_t cull() { return list->cullOccluded(*grid); }
+};
+
+void requireAdded(const core::ResultVoid<DrawError>& result, std::string_view what) {
+    if (!result.has_value()) {
+        throw speclab::core::AssertionFailure(
+            std::format("{} was refused: {}", what, describe(result.error())),
+            std::source_location::current());
+    }
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// Culling
+// ---------------------------------------------------------------------------
+
+const mdux::spec::Register hiddenRectDropped{
+    "A rectangle an opaque panel later covers is dropped", "evidence-unit", [] {
+        return speclab::Test("occlusion-hidden-rect-dropped")
+            .Given("a small rectangle, then an opaque panel over it", [] {})
+            .When("the list is culled", [] {})
+            .Then("the rectangle's two triangles are gone and the panel is untouched",
+                  [] {
+                      Scene scene;
+                      requireAdded(scene.list->addSolidRect(hidden, red), "hidden rect");
+                      requireAdded(scene.list->addSolidRect(panel, blue), "panel");
+
+                      mdux::spec::Checks checks;
+                      checks.expect(scene.cull() == 2, "two triangles dropped");
+                      checks.expect(std::ranges::equal(scene.list->indices(),
+                                                       std::array<Index, 6>{4, 5, 6, 4, 6, 7}),
+                                    "only the panel's indices remain, moved to the front");
+                      checks.expect(scene.list->commands().size() == 1 &&
+                                        scene.list->commands()[0].firstIndex == 0 &&
+                                        scene.list->commands()[0].indexCount == 6,
+                                    "its command shrank to the panel");
+                      checks.expect(scene.list->vertices().size() == 8,
+                                    "no vertex moved, so the remaining indices still name them");
+                      checks.expect(scene.cull() == 0, "culling twice drops nothing more");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register onlyLaterOpaqueSolidOccludes{
+    "Only a later, opaque, untextured rectangle that covers completely hides anything",
+    "evidence-unit", [] {
+        return speclab::Test("occlusion-needs-later-opaque-solid")
+            .Given("a panel that is drawn first, translucent, textured, or one pixel short", [] {})
+            .When("each list is culled", [] {})
+            .Then("nothing is dropped from any of them",
+                  [] {
+                      mdux::spec::Checks checks;
+                      {
+                          Scene scene;
+                          requireAdded(scene.list->addSolidRect(panel, blue), "panel first");
+                          requireAdded(scene.list->addSolidRect(hidden, red), "rect after");
+                          checks.expect(scene.cull() == 0, "what is drawn after stays on top");
+                      }
+                      {
+                          Scene scene;
+                          requireAdded(scene.list->addSolidRect(hidden, red), "rect");
+                          requireAdded(scene.list->addSolidRect(
+                                           panel, core::ColorRgba8{.r = 0, .g = 0, .b = 255,
+                                                                   .a = 254}),
+                                       "translucent panel");
+                          checks.expect(scene.cull() == 0, "alpha 254 lets the rect through");
+                      }
+                      {
+                          Scene scene;
+                          requireAdded(scene.list->addSolidRect(hidden, red), "rect");
+                          requireAdded(scene.list->addRect(panel, blue, DrawMode::SampledRgba,
+                                                           core::Rect{.x = 0, .y = 0,
+                                                                      .width = 1, .height = 1}),
+                                       "textured panel");
+                          checks.expect(scene.cull() == 0, "a sampled texel may be transparent");
+                      }
+                      {
+                          Scene scene;
+                          requireAdded(scene.list->addSolidRect(hidden, red), "rect");
+                          requireAdded(scene.list->addSolidRect(
+                                           {.x = 11, .y = 10, .width = 49, .height = 50}, blue),
+                                       "short panel");
+                          checks.expect(scene.cull() == 0, "one uncovered column is enough");
+                      }
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register cullingRespectsClips{
+    "Culling reads both commands' clips, and leaves segments alone", "evidence-unit", [] {
+        return speclab::Test("occlusion-respects-clips")
+            .Given("a panel clipped short of a rect, a rect clipped to nothing, and a segment", [] {})
+            .When("the list is culled", [] {})
+            .Then("the clipped-away rect and its command go; the others and the segment stay",
+                  [] {
+                      constexpr std::array<UiVertex, 3> triangle{
+                          UiVertex{.x = 10, .y = 10}, UiVertex{.x = 30, .y = 10},
+                          UiVertex{.x = 10, .y = 30}};
+                      constexpr std::array<Index, 3> corners{0, 1, 2};
+                      const auto segment = DrawSegment::create(0, triangle, corners);
+                      if (!segment.has_value()) {
+                          throw speclab::core::AssertionFailure("the segment must be valid",
+                                                                std::source_location::current());
+                      }
+
+                      Scene scene;
+                      requireAdded(scene.list->addSolidRect(hidden, red), "rect");
+                      requireAdded(scene.list->addSegment(*segment), "segment under the panel");
+                      scene.list->setClip({.x = 70, .y = 70, .width = 10, .height = 10});
+                      requireAdded(scene.list->addSolidRect(hidden, red), "clipped-away rect");
+                      scene.list->setClip({.x = 0, .y = 0, .width = 20, .height = 60});
+                      requireAdded(scene.list->addSolidRect(panel, blue), "clipped panel");
+
+                      mdux::spec::Checks checks;
+                      checks.expect(scene.cull() == 2, "only the clipped-away rect is dropped");
+                      const auto commands = scene.list->commands();
+                      checks.expect(commands.size() == 3, "its emptied command is removed");
+                      if (commands.size() == 3) {
+                          checks.expect(commands[0].indexCount == 6 &&
+                                            commands[0].segment == nullptr,
+                                        "the rect the clipped panel only half covers stays");
+                          checks.expect(commands[1].segment == &*segment &&
+                                            commands[1].indexCount == 3,
+                                        "the segment is never culled");
+                          checks.expect(commands[2].firstIndex == 6 &&
+                                            commands[2].indexCount == 6,
+                                        "the panel's indices moved up behind the rect's");
+                      }
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register gridStorageChecked{
+    "A grid is refused storage too small for its tiles, and a viewport with no area",
+    "evidence-unit", [] {
+        return speclab::Test("occlusion-grid-storage-checked")
+            .Given("a 100x100 viewport at 16-pixel tiles", [] {})
+            .When("grids are created over too little storage and over empty viewports", [] {})
+            .Then("each is refused with the matching error",
+                  [] {
+                      std::array<core::Rect, 49> tiles{};
+                      mdux::spec::Checks checks;
+                      checks.expect(occlusionTileCount(viewport, tileSize) == 49,
+                                    "7 columns by 7 rows");
+                      checks.expect(occlusionTileCount(viewport, 0) == 0,
+                                    "a zero tile size needs nothing, and is refused");
+
+                      const auto small =
+                          OcclusionGrid::create(std::span{tiles}.first(48), viewport, tileSize);
+                      checks.expect(!small.has_value() &&
+                                        small.error() == DrawError::StorageTooSmall,
+                                    "48 tiles is one short");
+                      const auto empty = OcclusionGrid::create(
+                          tiles, core::Extent2D{.width = 0, .height = 100}, tileSize);
+                      checks.expect(!empty.has_value() &&
+                                        empty.error() == DrawError::EmptyBudget,
+                                    "a zero-width viewport is refused");
+                      const auto created = OcclusionGrid::create(tiles, viewport, tileSize);
+                      checks.expect(created.has_value() && created->tileSize() == tileSize &&
+                                        created->viewport() == viewport,
+                                    "exactly enough storage is accepted");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
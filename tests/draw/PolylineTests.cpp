@@ -0,0 +1,287 @@
+/**
+ * @file PolylineTests.cpp
+ * @brief BDD scenarios for mdux.draw polylines and min/max trace decimation.
+ *
+ * @compliance ADR-004 Trust zones in C++ (governed zone)
+ *
+ * The budget check is only as good as the cost it is given, so the first scenarios hold the
+ * tessellator to `polylineCost()` exactly - on a straight run, a miter, a spike sharp enough to
+ * bevel, and a reversal - and to `maxPolylineCost()` as a bound. The decimation scenarios are
+ * about the one property a monitor trace cannot lose: a one-sample peak is still drawn.
+ */
+
+import std;
+import speclab;
+import mdux.core.result;
+import mdux.core.units;
+import mdux.draw;
+
+#include "../framework/SpecLabBridge.hpp"
+
+namespace {
+
+using namespace mdux::draw;
+namespace core = mdux::core;
+
+constexpr core::ColorRgba8 trace{.r = 0, .g = 255, .b = 0, .a = 255};
+
+/// A list over storage held by value, so nothing allocates.
+struct Canvas {
+    std::array<UiVertex, 256> vertices{};
+    std::array<Index, 512> indices{};
+    std::array<DrawCommand, 2> commands{};
+    std::optional<DrawList> list;
+
+    explicit Canvas(DrawBudget budget = {.maxVertices = 256, .maxIndices = 512, .maxCommands = 2}) {
+        auto created = DrawList::create(vertices, indices, commands, budget);
+        if (!created.has_value()) {
+            throw speclab::core::AssertionFailure("the list must be created",
+                                                  std::source_location::current());
+        }
+        list = std::move(*created);
+    }
+};
+
+[[nodiscard]] bool near(float a, float b) noexcept {
+    return std::abs(a - b) < 1e-4F;
+}
+
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// Tessellation
+// ---------------------------------------------------------------------------
+
+const mdux::spec::Register straightSegmentGeometry{
+    "A two-point polyline is one quad of the requested width", "evidence-unit", [] {
+        return speclab::Test("polyline-straight-segment")
+            .Given("a horizontal segment two pixels wide", [] {})
+            .When("it is recorded", [] {})
+            .Then("its four vertices sit one pixel either side, in addRect's triangle order",
+                  [] {
+                      mdux::spec::Checks checks;
+                      Canvas canvas;
+                      constexpr std::array<Point2F, 2> line{Point2F{.x = 10.0F, .y = 20.0F},
+                                                            Point2F{.x = 50.0F, .y = 20.0F}};
+                      checks.expect(canvas.list->addPolyline(line, {.width = 2.0F}, trace)
+                                        .has_value(),
+                                    "the segment is recorded");
+                      const auto vertices = canvas.list->vertices();
+                      checks.expect(vertices.size() == 4, "one quad");
+                      if (vertices.size() == 4) {
+                          checks.expect(near(vertices[0].x, 10.0F) && near(vertices[0].y, 21.0F) &&
+                                            near(vertices[1].y, 19.0F) &&
+                                            near(vertices[2].x, 50.0F) &&
+                                            near(vertices[3].y, 19.0F),
+                                        "each end is offset by half the width");
+                          checks.expect(vertices[0].mode ==
+                                                static_cast<std::uint32_t>(DrawMode::Solid) &&
+                                            vertices[0].color == packColor(trace),
+                                        "a polyline is solid, in its colour");
+                      }
+                      checks.expect(std::ranges::equal(canvas.list->indices(),
+                                                       std::array<Index, 6>{0, 1, 3, 0, 3, 2}),
+                                    "the quad is two triangles");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register miterJoinGeometry{
+    "A right-angle join is one shared miter pair", "evidence-unit", [] {
+        return speclab::Test("polyline-miter-join")
+            .Given("an L two pixels wide, with the default miter limit", [] {})
+            .When("it is recorded", [] {})
+            .Then("the corner pair is the miter, and no bevel is charged",
+                  [] {
+                      mdux::spec::Checks checks;
+                      Canvas canvas;
+                      constexpr std::array<Point2F, 3> corner{Point2F{.x = 0.0F, .y = 0.0F},
+                                                              Point2F{.x = 10.0F, .y = 0.0F},
+                                                              Point2F{.x = 10.0F, .y = 10.0F}};
+                      const auto cost = polylineCost(corner, {.width = 2.0F});
+                      checks.expect(cost.has_value() &&
+                                        *cost == PrimitiveCost{.vertices = 6, .indices = 12},
+                                    "three pairs and two quads");
+                      checks.expect(canvas.list->addPolyline(corner, {.width = 2.0F}, trace)
+                                        .has_value(),
+                                    "the L is recorded");
+                      const auto vertices = canvas.list->vertices();
+                      if (vertices.size() == 6) {
+                          // sqrt(2) from the corner along the bisector: the outer edges meet.
+                          checks.expect(near(vertices[2].x, 9.0F) && near(vertices[2].y, 1.0F) &&
+                                            near(vertices[3].x, 11.0F) &&
+                                            near(vertices[3].y, -1.0F),
+                                        "the corner pair is the miter");
+                      }
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register costIsExact{
+    "addPolyline() charges exactly polylineCost(), within maxPolylineCost()", "evidence-unit", [] {
+        return speclab::Test("polyline-cost-is-exact")
+            .Given("a trace with a spike, a reversal, and a repeated sample, in both join styles",
+                   [] {})
+            .When("each is costed and recorded into an empty list", [] {})
+            .Then("the list grew by the cost, every index is in range, and the bound holds",
+                  [] {
+                      mdux::spec::Checks checks;
+                      constexpr std::array<Point2F, 8> qrs{
+                          Point2F{.x = 0.0F, .y = 50.0F},  Point2F{.x = 10.0F, .y = 50.0F},
+                          Point2F{.x = 10.0F, .y = 50.0F}, Point2F{.x = 12.0F, .y = 5.0F},
+                          Point2F{.x = 14.0F, .y = 70.0F}, Point2F{.x = 16.0F, .y = 50.0F},
+                          Point2F{.x = 40.0F, .y = 50.0F}, Point2F{.x = 30.0F, .y = 50.0F}};
+                      for (const JoinStyle join : {JoinStyle::Miter, JoinStyle::Bevel}) {
+                          const PolylineStyle style{.width = 1.5F, .join = join};
+                          const auto cost = polylineCost(qrs, style);
+                          checks.expect(cost.has_value(), "the trace has a cost");
+                          if (!cost.has_value()) {
+                              continue;
+                          }
+                          Canvas canvas;
+                          checks.expect(canvas.list->addPolyline(qrs, style, trace).has_value(),
+                                        "the trace is recorded");
+                          checks.expect(canvas.list->vertices().size() == cost->vertices &&
+                                            canvas.list->indices().size() == cost->indices,
+                                        "the list grew by exactly the cost");
+                          checks.expect(std::ranges::all_of(canvas.list->indices(),
+                                                            [&](Index index) {
+                                                                return index <
+                                                                       cost->vertices;
+                                                            }),
+                                        "every index names a written vertex");
+                          const PrimitiveCost bound = maxPolylineCost(qrs.size());
+                          checks.expect(cost->vertices <= bound.vertices &&
+                                            cost->indices <= bound.indices,
+                                        "the worst case bounds it");
+                      }
+                      // The spike's two sharp turns and the reversal bevel under the default
+                      // limit; the straight run and the shallow turns do not.
+                      const auto mitered = polylineCost(qrs, {.width = 1.5F});
+                      checks.expect(mitered.has_value() &&
+                                        *mitered == PrimitiveCost{.vertices = 20, .indices = 54},
+                                    "seven distinct points, three bevels");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register refusedPolylineLeavesNoTrace{
+    "An invalid or oversized polyline records nothing", "evidence-unit", [] {
+        return speclab::Test("polyline-all-or-nothing")
+            .Given("a list with room for one quad", [] {})
+            .When("invalid polylines and one too long for the budget are added", [] {})
+            .Then("each is refused with its own error and the list stays empty",
+                  [] {
+                      mdux::spec::Checks checks;
+                      Canvas canvas{{.maxVertices = 4, .maxIndices = 6, .maxCommands = 1}};
+                      DrawList& list = *canvas.list;
+                      constexpr std::array<Point2F, 2> repeated{Point2F{.x = 1.0F, .y = 1.0F},
+                                                                Point2F{.x = 1.0F, .y = 1.0F}};
+                      constexpr std::array<Point2F, 3> three{Point2F{.x = 0.0F, .y = 0.0F},
+                                                             Point2F{.x = 5.0F, .y = 0.0F},
+                                                             Point2F{.x = 9.0F, .y = 0.0F}};
+                      const std::array<Point2F, 2> notFinite{
+                          Point2F{.x = 0.0F, .y = 0.0F},
+                          Point2F{.x = std::numeric_limits<float>::quiet_NaN(), .y = 0.0F}};
+
+                      checks.expect(list.addPolyline(repeated, {}, trace).error() ==
+                                        DrawError::InvalidPolyline,
+                                    "one distinct point is not a line");
+                      checks.expect(list.addPolyline(notFinite, {}, trace).error() ==
+                                        DrawError::InvalidPolyline,
+                                    "a NaN sample is refused, not drawn somewhere");
+                      checks.expect(list.addPolyline(three, {.width = 0.0F}, trace).error() ==
+                                        DrawError::InvalidPolyline,
+                                    "a line needs a width");
+                      checks.expect(list.addPolyline(three, {.miterLimit = 0.5F}, trace).error() ==
+                                        DrawError::InvalidPolyline,
+                                    "a miter limit under 1 is refused, not every join bevelled");
+                      checks.expect(list.addPolyline(three, {.miterLimit = -4.0F}, trace).error() ==
+                                        DrawError::InvalidPolyline,
+                                    "a negative miter limit is refused");
+                      checks.expect(list.addPolyline(three, {}, trace).error() ==
+                                        DrawError::VertexBudgetExceeded,
+                                    "three points need six vertices");
+                      checks.expect(list.empty() && list.vertices().empty(),
+                                    "nothing was recorded");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+// ---------------------------------------------------------------------------
+// Traces
+// ---------------------------------------------------------------------------
+
+const mdux::spec::Register decimationKeepsPeaks{
+    "Min/max decimation keeps a one-sample peak", "evidence-unit", [] {
+        return speclab::Test("trace-decimation-keeps-peaks")
+            .Given("1000 flat samples with one high and one low spike, across 100 columns",
+                   [] {})
+            .When("they are laid out as trace points", [] {})
+            .Then("at most two points per column, and both spikes reach their rows",
+                  [] {
+                      mdux::spec::Checks checks;
+                      std::array<float, 1000> samples{};
+                      samples[517] = 1.0F;
+                      samples[700] = -1.0F;
+                      const core::Rect strip{.x = 0, .y = 0, .width = 100, .height = 41};
+                      std::array<Point2F, 200> storage{};
+                      checks.expect(maxTracePoints(samples.size(), strip.width) == 200,
+                                    "two points per column");
+
+                      const auto points = tracePoints(samples, strip, -1.0F, 1.0F, storage);
+                      checks.expect(points.has_value(), "the trace is laid out");
+                      if (points.has_value()) {
+                          checks.expect(points->size() == 102,
+                                        "flat columns are one point, spiked ones two");
+                          const auto atRow = [&](float row) {
+                              return std::ranges::any_of(*points, [&](const Point2F& point) {
+                                  return near(point.y, row);
+                              });
+                          };
+                          checks.expect(atRow(0.5F) && atRow(40.5F),
+                                        "the peak and the trough reach the top and bottom");
+                          checks.expect(polylineCost(*points, {}).has_value(),
+                                        "the points draw as a polyline");
+                      }
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register sparseTraceIsNotDecimated{
+    "Fewer samples than columns are laid out one point each", "evidence-unit", [] {
+        return speclab::Test("trace-sparse-samples")
+            .Given("five samples across a 41-pixel strip, and storage one point short", [] {})
+            .When("they are laid out", [] {})
+            .Then("they span the strip edge to edge, and short storage is refused",
+                  [] {
+                      mdux::spec::Checks checks;
+                      constexpr std::array<float, 5> samples{0.0F, 1.0F, 0.5F, 0.0F, 1.0F};
+                      const core::Rect strip{.x = 10, .y = 0, .width = 41, .height = 11};
+                      std::array<Point2F, 5> storage{};
+                      const auto points = tracePoints(samples, strip, 0.0F, 1.0F, storage);
+                      checks.expect(points.has_value() && points->size() == 5,
+                                    "one point per sample");
+                      if (points.has_value() && points->size() == 5) {
+                          checks.expect(near(points->front().x, 10.5F) &&
+                                            near(points->back().x, 50.5F) &&
+                                            near((*points)[1].y, 0.5F) &&
+                                            near((*points)[3].y, 10.5F),
+                                        "edge columns and edge rows are pixel centres");
+                      }
+                      checks.expect(tracePoints(samples, strip, 0.0F, 1.0F,
+                                                std::span{storage}.first(4))
+                                            .error() == DrawError::StorageTooSmall,
+                                    "four points cannot hold five samples");
+                      checks.expect(tracePoints(samples, strip, 1.0F, 1.0F, storage).error() ==
+                                        DrawError::InvalidPolyline,
+                                    "an empty value range is refused");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
@@ -59,6 +59,30 @@ void expectRejected(std::string_view text, ErrorCode expected, std::string_view
                       "' but got '" + std::string{describe(result.error().code)} + "'");
 }
 
+/// Asserts that both scanners reach the same outcome on `text`: the same value, or the same
+/// error code at the same offset. An offset that moved would still be a rejection, but it would
+/// point a reviewer at the wrong byte - so agreement means agreement on both.
+void expectScannersAgree(std::string_view text, std::string_view what) {
+    const auto wide = parse(text, Scanner::Wide);
+    const auto reference = parse(text, Scanner::Reference);
+    if (wide.has_value() != reference.has_value()) {
+        CHECK_MESSAGE(false, std::string{what} + ": one scanner accepted and the other rejected");
+        return;
+    }
+    if (wide.has_value()) {
+        CHECK_MESSAGE(written(*wide) == written(*reference),
+                      std::string{what} + ": scanners decoded different values");
+        return;
+    }
+    CHECK_MESSAGE(wide.error().code == reference.error().code &&
+                      wide.error().offset == reference.error().offset,
+                  std::string{what} + ": wide reported '" +
+                      std::string{describe(wide.error().code)} + "' at " +
+                      std::to_string(wide.error().offset) + ", reference '" +
+                      std::string{describe(reference.error().code)} + "' at " +
+                      std::to_string(reference.error().offset));
+}
+
 [[nodiscard]] std::uint32_t bitsOf(float value) {
     return std::bit_cast<std::uint32_t>(value);
 }
@@ -366,6 +390,211 @@ TEST_CASE("The reader rejects nesting past the depth limit", "evidence-unit") {
     CHECK(parse(acceptable).has_value());
 }
 
+// ---------------------------------------------------------------------------
+// Scanner agreement
+// ---------------------------------------------------------------------------
+//
+// The wide scanner tests eight bytes at a time, so its failure modes live at word boundaries:
+// a special byte in the last lane, a multi-byte sequence straddling two words, a tail shorter
+// than a word. Each case below is therefore repeated at every alignment across more than one
+// word, rather than at whichever offset a hand-written literal happens to put it.
+
+TEST_CASE("Invalid UTF-8 is reported at the same offset at every alignment", "evidence-unit") {
+    for (std::size_t prefix = 0; prefix < 24; ++prefix) {
+        const std::string text = "\"" + std::string(prefix, 'a') + "\xc3(\"";
+        const auto result = parse(text);
+        REQUIRE(!result.has_value());
+        CHECK(result.error().code == ErrorCode::InvalidUtf8);
+        CHECK(result.error().offset == prefix + 1);
+        expectScannersAgree(text, "invalid UTF-8 after " + std::to_string(prefix) + " bytes");
+    }
+}
+
+TEST_CASE("String specials are found at every alignment", "evidence-unit") {
+    for (std::size_t prefix = 0; prefix < 24; ++prefix) {
+        const std::string run(prefix, 'x');
+
+        const auto escaped = parse("\"" + run + "\\n" + run + "\"");
+        REQUIRE(escaped.has_value());
+        CHECK(*escaped->asString() == run + "\n" + run);
+
+        const std::string control = "\"" + run + "\x01\"";
+        const auto rejected = parse(control);
+        REQUIRE(!rejected.has_value());
+        CHECK(rejected.error().code == ErrorCode::UnescapedControlCharacter);
+        CHECK(rejected.error().offset == prefix + 1);
+        expectScannersAgree(control, "control character after " + std::to_string(prefix));
+
+        expectScannersAgree("\"" + run, "unterminated after " + std::to_string(prefix));
+        expectScannersAgree("\"" + run + "\\", "escape at end after " + std::to_string(prefix));
+    }
+}
+
+TEST_CASE("Multi-byte sequences straddling a word boundary decode identically", "evidence-unit") {
+    // Two, three and four bytes, so every split point of every length crosses a boundary.
+    constexpr std::array<std::string_view, 3> sequences{"\xc3\xa9", "\xe2\x82\xac",
+                                                        "\xf0\x9f\x98\x80"};
+    for (const std::string_view sequence : sequences) {
+        for (std::size_t prefix = 0; prefix < 16; ++prefix) {
+            const std::string body = std::string(prefix, 'k') + std::string{sequence} + "tail";
+            const auto result = parse("\"" + body + "\"");
+            REQUIRE(result.has_value());
+            CHECK(*result->asString() == body);
+            expectScannersAgree("\"" + body + "\"", "sequence after " + std::to_string(prefix));
+        }
+    }
+}
+
+TEST_CASE("Both scanners agree on every single-byte mutation of a canonical artifact",
+          "evidence-unit") {
+    // Exhaustive rather than random: every byte of a report-shaped document replaced by each
+    // byte the scanners treat specially, plus every truncation. A seeded generator would cover
+    // less and reproduce no better; this corpus is small enough to walk completely.
+    const Value artifact = objectOf(
+        {{"schemaVersion", Value::unsignedInteger(1)},
+         {"tool", Value::string("mdux-mlbake")},
+         {"note", Value::string("caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80 tab\there")},
+         {"sha256", Value::string(std::string(64, 'f'))},
+         {"scale", Value::float32(0.5F)},
+         {"offsets", Value::array({Value::integer(-3), Value::unsignedInteger(4096)})}});
+    const std::string canonical = written(artifact);
+    expectScannersAgree(canonical, "unmodified artifact");
+
+    constexpr std::array<char, 12> replacements{'\x00', '\x1f', '"',    '\\',   '\x80', '\xc3',
+                                                '\xe2', '\xf0', '\xff', '{',    ',',    ' '};
+    for (std::size_t i = 0; i < canonical.size(); ++i) {
+        for (const char replacement : replacements) {
+            std::string mutated = canonical;
+            mutated[i] = replacement;
+            expectScannersAgree(mutated, "byte " + std::to_string(i) + " replaced");
+        }
+        expectScannersAgree(std::string_view{canonical}.substr(0, i),
+                            "truncated to " + std::to_string(i) + " bytes");
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Lazy access
+// ---------------------------------------------------------------------------
+
+TEST_CASE("parseLazy rejects exactly what parse rejects, at the same offset", "evidence-unit") {
+    // The same exhaustive mutation walk the scanner test uses, plus the strictness cases that
+    // live deep in the grammar - a duplicate key two levels down must not slip through because
+    // nothing navigated to it.
+    const Value artifact = objectOf(
+        {{"id", Value::string("ecg-demo")},
+         {"layers", Value::array({objectOf({{"kind", Value::string("dense")},
+                                            {"inLength", Value::unsignedInteger(8)}})})},
+         {"goldens", Value::array({objectOf({{"inputBits", Value::array({Value::integer(-1),
+                                                                       Value::float32(1.0F)})}})})}});
+    const std::string canonical = written(artifact);
+
+    std::vector<std::string> corpus{
+        canonical,
+        R"({"a": {"b": {"c": 1, "c": 2}}})",
+        R"({"a": [1, 2,]})",
+        R"({"a": 1.5})",
+        R"({"a": "\q"})",
+        R"({"a": [[[]]]} x)",
+        std::string(kMaxDepth + 2, '[') + std::string(kMaxDepth + 2, ']'),
+    };
+    constexpr std::array<char, 8> replacements{'\x00', '"', '\\', '\xc3', '{', ']', ',', ':'};
+    for (std::size_t i = 0; i < canonical.size(); ++i) {
+        for (const char replacement : replacements) {
+            std::string mutated = canonical;
+            mutated[i] = replacement;
+            corpus.push_back(std::move(mutated));
+        }
+        corpus.push_back(canonical.substr(0, i));
+    }
+
+    for (const std::string& text : corpus) {
+        const auto eager = parse(text);
+        const auto lazy = parseLazy(text);
+        REQUIRE(eager.has_value() == lazy.has_value());
+        if (!eager.has_value()) {
+            CHECK(eager.error().code == lazy.error().code);
+            CHECK(eager.error().offset == lazy.error().offset);
+        }
+    }
+}
+
+TEST_CASE("A lazy value materialises to the same subtree parse builds", "evidence-unit") {
+    const Value artifact = objectOf(
+        {{"schemaVersion", Value::unsignedInteger(1)},
+         {"offset", Value::integer(-7)},
+         {"layers", Value::array({objectOf({{"kind", Value::string("conv1d")}}),
+                                  objectOf({{"kind", Value::string("dense")}})})},
+         {"scale", Value::float32(0.25F)}});
+    const std::string text = written(artifact);
+    const auto root = parseLazy(text);
+    REQUIRE(root.has_value());
+    CHECK(root->kind() == Value::Kind::Object);
+
+    const auto version = root->find("schemaVersion");
+    REQUIRE(version.has_value());
+    CHECK(version->kind() == Value::Kind::UInt);
+    CHECK(version->text() == "1");
+    CHECK(*version->materialise()->asUInt() == 1);
+
+    const auto offset = root->require("offset");
+    REQUIRE(offset.has_value());
+    CHECK(offset->kind() == Value::Kind::Int);
+    CHECK(*offset->materialise()->asInt() == -7);
+
+    const auto layers = root->find("layers");
+    REQUIRE(layers.has_value());
+    static_assert(std::ranges::forward_range<LazyElements>);
+    const LazyElements entries = layers->elements();
+    REQUIRE(std::ranges::distance(entries) == 2);
+    const auto second = (*std::ranges::next(entries.begin())).find("kind");
+    REQUIRE(second.has_value());
+    CHECK(*second->materialise()->asString() == "dense");
+
+    const auto scale = root->find("scale");
+    REQUIRE(scale.has_value());
+    CHECK(std::bit_cast<std::uint32_t>(*scale->materialise()->asFloat32()) == bitsOf(0.25F));
+
+    const auto whole = root->materialise();
+    REQUIRE(whole.has_value());
+    CHECK(written(*whole) == text);
+}
+
+TEST_CASE("Lazy lookup handles escaped keys, absent members and the wrong kind", "evidence-unit") {
+    const std::string text = R"(  {"plain": [], "esc\u0061ped": true, "s": "a\"b,}"}  )";
+    const auto root = parseLazy(text);
+    REQUIRE(root.has_value());
+    CHECK(root->text().front() == '{');
+    CHECK(root->text().back() == '}');
+
+    const auto escaped = root->find("escaped");
+    REQUIRE(escaped.has_value());
+    CHECK(escaped->kind() == Value::Kind::Bool);
+
+    // A quote and delimiters inside a string must not end the member walk early.
+    const auto tricky = root->find("s");
+    REQUIRE(tricky.has_value());
+    CHECK(*tricky->materialise()->asString() == "a\"b,}");
+
+    CHECK(!root->find("absent").has_value());
+    CHECK(root->require("absent").error().code == ErrorCode::MissingMember);
+    CHECK(root->find("plain")->elements().empty());
+    CHECK(root->elements().empty());
+
+    // Nor may a nested array or a bracket inside a string end the element walk early.
+    const std::string nested = R"([ 1 , [2, 3] ,"]" ])";
+    const auto array = parseLazy(nested);
+    REQUIRE(array.has_value());
+    std::vector<std::string_view> walked;
+    for (const LazyValue& element : array->elements()) {
+        walked.push_back(element.text());
+    }
+    const std::vector<std::string_view> expected{"1", "[2, 3]", R"("]")"};
+    CHECK(walked == expected);
+    CHECK(!tricky->find("anything").has_value());
+    CHECK(tricky->require("anything").error().code == ErrorCode::WrongKind);
+}
+
 // ---------------------------------------------------------------------------
 // Accessors
 // ---------------------------------------------------------------------------
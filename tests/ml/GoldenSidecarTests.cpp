@@ -0,0 +1,247 @@
+/**
+ * @file GoldenSidecarTests.cpp
+ * @brief `[goldens] storage = "sidecar"` - the same goldens, addressed in `goldens.bin`.
+ *
+ * @compliance ADR-007 Evidence pipeline doctrine
+ * @compliance ADR-008 Zero-SOUP ML inference
+ *
+ * The sidecar is a storage change and nothing else, so the property worth asserting is identity:
+ * baking the demonstrator recipe with sidecar storage and loading the result yields exactly the
+ * goldens the committed inline package carries, bit for bit. The second scenario is the one that
+ * keeps the sidecar a control rather than a convenience - a sidecar that does not match the digest
+ * its package records is refused by name, not read. The third keeps the written output a function
+ * of the recipe alone: going back to inline goldens removes the sidecar an earlier bake left.
+ */
+
+// __cpp_lib_start_lifetime_as, which decides whether goldens are read in place.
+#include <version>
+
+import std;
+import speclab;
+import mdux.core.result;
+import mdux.ml.schema;
+import mdux.tools.cli;
+import mdux.tools.ml.mlbake;
+import mdux.tools.ml.packageload;
+
+#include "../framework/SpecLabBridge.hpp"
+#include "../tools/TempDir.hpp"
+
+namespace {
+
+using namespace mdux::tools::ml;
+namespace ml = mdux::ml;
+namespace cli = mdux::tools::cli;
+
+constexpr std::string_view recipePath = "recipes/model/ecg-demo.toml";
+
+[[nodiscard]] std::optional<std::string> readText(const std::filesystem::path& path) {
+    std::ifstream file{path, std::ios::binary};
+    if (!file) {
+        return std::nullopt;
+    }
+    return std::string{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+[[nodiscard]] std::vector<std::byte> toBytes(std::string_view text) {
+    std::vector<std::byte> bytes(text.size());
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        bytes[i] = static_cast<std::byte>(static_cast<unsigned char>(text[i]));
+    }
+    return bytes;
+}
+
+/// The demonstrator recipe with `storage` for its goldens, baked in memory.
+[[nodiscard]] std::optional<BakeOutputs> bake(GoldenStorage storage, std::string& why) {
+    const std::filesystem::path root{MDUX_REPO_ROOT};
+    auto text = readText(root / recipePath);
+    if (!text.has_value()) {
+        why = std::format("cannot read {}", recipePath);
+        return std::nullopt;
+    }
+
+    // Set on the parsed recipe rather than spliced into the text: what is under test is the
+    // storage, not the TOML reader, and this keeps the scenario independent of the recipe's layout.
+    std::vector<cli::Diagnostic> diagnostics;
+    auto recipe = parseRecipe(*text, recipePath, diagnostics);
+    if (!recipe.has_value()) {
+        why = std::format("{} did not parse", recipePath);
+        return std::nullopt;
+    }
+    recipe->goldenStorage = storage;
+
+    const std::vector<std::byte> recipeBytes = toBytes(*text);
+    auto outputs = run(*recipe, recipePath, recipeBytes, root, diagnostics);
+    if (!outputs.has_value()) {
+        why = diagnostics.empty() ? std::string{"the bake failed"} : diagnostics.front().message;
+        return std::nullopt;
+    }
+    return outputs;
+}
+
+/// Bit-for-bit equality of two goldens lists.
+[[nodiscard]] bool sameGoldens(std::span<const ml::GoldenVector> a,
+                               std::span<const ml::GoldenVector> b) noexcept {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (!std::ranges::equal(a[i].inputBits, b[i].inputBits) ||
+            !std::ranges::equal(a[i].expectedOutputBits, b[i].expectedOutputBits)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Scenarios
+// ---------------------------------------------------------------------------
+
+const mdux::spec::Register sidecarCarriesTheSameGoldens{
+    "A sidecar bake carries exactly the committed goldens", "evidence-unit", [] {
+        return speclab::Test("ml-golden-sidecar-identity")
+            .Given("the demonstrator recipe baked with sidecar golden storage", [] {})
+            .When("its package is loaded with goldens.bin beside it", [] {})
+            .Then("the goldens equal the committed inline package's, bit for bit",
+                  [] {
+                      mdux::spec::Checks checks;
+                      std::string why;
+                      auto outputs = bake(GoldenStorage::Sidecar, why);
+                      checks.expect(outputs.has_value(), why);
+                      auto committedText = readText(std::filesystem::path{MDUX_REPO_ROOT} /
+                                                    "generated/model/ecg-demo/package.json");
+                      checks.expect(committedText.has_value(), "the committed package reads");
+                      if (!outputs.has_value() || !committedText.has_value()) {
+                          checks.raise();
+                          return;
+                      }
+
+                      checks.expect(outputs->goldensName == "goldens.bin", "the sidecar is named");
+                      checks.expect(!outputs->goldens.empty(), "the sidecar has bytes");
+
+                      auto sidecar = loadPackage(outputs->packageJson, "package.json",
+                                                 outputs->goldens);
+                      auto inlined = loadPackage(*committedText, "package.json");
+                      checks.expect(sidecar.has_value(),
+                                    sidecar.has_value() ? "loaded" : sidecar.error().message);
+                      checks.expect(inlined.has_value(),
+                                    inlined.has_value() ? "loaded" : inlined.error().message);
+                      if (!sidecar.has_value() || !inlined.has_value()) {
+                          checks.raise();
+                          return;
+                      }
+
+                      checks.expect(sameGoldens((*sidecar)->view().goldens,
+                                                (*inlined)->view().goldens),
+                                    "every golden matches the inline form");
+
+                      // A heap buffer is 4-aligned, so on a little-endian host the goldens are
+                      // read where they lie in goldens.bin rather than copied out of it.
+#if defined(__cpp_lib_start_lifetime_as)
+                      if constexpr (std::endian::native == std::endian::little) {
+                          const auto at = reinterpret_cast<std::uintptr_t>(
+                              (*sidecar)->view().goldens.front().inputBits.data());
+                          const auto begin =
+                              reinterpret_cast<std::uintptr_t>(outputs->goldens.data());
+                          checks.expect(at >= begin && at < begin + outputs->goldens.size(),
+                                        "the goldens point into goldens.bin");
+                      }
+#endif
+
+                      // A blob that is not 4-aligned cannot be read in place; it is decoded
+                      // instead, to the same goldens.
+                      std::vector<std::byte> shifted(outputs->goldens.size() + 1);
+                      std::ranges::copy(outputs->goldens, shifted.begin() + 1);
+                      auto decoded = loadPackage(outputs->packageJson, "package.json",
+                                                 std::span{shifted}.subspan(1));
+                      checks.expect(decoded.has_value() &&
+                                        sameGoldens((*decoded)->view().goldens,
+                                                    (*inlined)->view().goldens),
+                                    "a misaligned sidecar decodes to the same goldens");
+
+                      // The point of the option: the numbers left the JSON.
+                      checks.expect(outputs->packageJson.size() * 2 < committedText->size(),
+                                    std::format("package.json shrank ({} vs {} bytes)",
+                                                outputs->packageJson.size(),
+                                                committedText->size()));
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register tamperedSidecarIsRefused{
+    "A sidecar that does not match its digest is refused", "evidence-unit", [] {
+        return speclab::Test("ml-golden-sidecar-digest-is-load-bearing")
+            .Given("a sidecar bake with one byte of goldens.bin changed", [] {})
+            .When("the package is loaded against it", [] {})
+            .Then("loading fails on goldenSidecarMismatch rather than reading the ranges",
+                  [] {
+                      mdux::spec::Checks checks;
+                      std::string why;
+                      auto outputs = bake(GoldenStorage::Sidecar, why);
+                      checks.expect(outputs.has_value() && !outputs->goldens.empty(), why);
+                      if (!outputs.has_value() || outputs->goldens.empty()) {
+                          checks.raise();
+                          return;
+                      }
+
+                      std::vector<std::byte> tampered = outputs->goldens;
+                      tampered[tampered.size() / 2] ^= std::byte{0x01};
+                      auto loaded = loadPackage(outputs->packageJson, "package.json", tampered);
+                      checks.expect(!loaded.has_value() &&
+                                        loaded.error().code ==
+                                            "mdux.ml.package.goldenSidecarMismatch",
+                                    "a flipped bit is refused by name");
+
+                      // A package that names a sidecar but is given none is refused too, rather
+                      // than loaded with no goldens and a self-test that vacuously passes.
+                      auto missing = loadPackage(outputs->packageJson, "package.json");
+                      checks.expect(!missing.has_value(), "a missing sidecar is refused");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register inlineBakeRemovesTheSidecar{
+    "Going back to inline goldens removes the old sidecar", "evidence-unit", [] {
+        return speclab::Test("ml-golden-sidecar-inline-rebake")
+            .Given("an output directory written by a sidecar bake", [] {})
+            .When("the recipe is baked with inline goldens into the same directory", [] {})
+            .Then("goldens.bin is gone, and verify() flags one put back",
+                  [] {
+                      mdux::spec::Checks checks;
+                      std::string why;
+                      auto sidecar = bake(GoldenStorage::Sidecar, why);
+                      checks.expect(sidecar.has_value(), why);
+                      auto inlined = bake(GoldenStorage::Json, why);
+                      checks.expect(inlined.has_value(), why);
+                      if (!sidecar.has_value() || !inlined.has_value()) {
+                          checks.raise();
+                          return;
+                      }
+
+                      const mdux::test::TempDir dir{"mdux-golden-sidecar"};
+                      const std::filesystem::path stale = dir.path() / "goldens.bin";
+                      std::vector<cli::Diagnostic> diagnostics;
+                      checks.expect(write(*sidecar, dir.path(), diagnostics) &&
+                                        std::filesystem::exists(stale),
+                                    "the sidecar bake writes goldens.bin");
+                      checks.expect(write(*inlined, dir.path(), diagnostics),
+                                    "the inline bake writes");
+                      checks.expect(!std::filesystem::exists(stale),
+                                    "the inline bake removed goldens.bin");
+                      checks.expect(verify(*inlined, dir.path() / "package.json",
+                                           dir.path() / "report.json", diagnostics),
+                                    "the inline output verifies against itself");
+
+                      mdux::test::writeFile(stale, sidecar->goldens);
+                      checks.expect(!verify(*inlined, dir.path() / "package.json",
+                                            dir.path() / "report.json", diagnostics),
+                                    "a goldens.bin beside an inline package is a mismatch");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+}  // namespace
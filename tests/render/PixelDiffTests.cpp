@@ -0,0 +1,66 @@
+/**
+ * @brief `diffImages()` over a frame of `OffscreenTarget::maxPixels`, with no device.
+ *
+ * The comparator's correctness is tested in PixelTests beside the frames it judges. This file
+ * holds the one thing about it that needs no frame at all, its behaviour at the largest surface
+ * the offscreen target allows, so it runs in render_tests wherever that builds rather than being
+ * skipped with the rest of offscreen_tests on a machine with no Vulkan device.
+ *
+ * ## The timing is reported, not asserted
+ *
+ * The header claims the comparison vectorises. Here that claim gets a number, printed next to the
+ * test's name: under 10 ms at -O2 or -O3 with GCC, and 25-35 ms with the vectoriser off. A shared
+ * CI runner can take longer than either for reasons that have nothing to do with this loop, so a
+ * threshold here would fail builds that are fine. Read the number when changing the inner loops.
+ */
+#include <cstdint>
+
+import std;
+import mdux.core.units;
+import mdux.render.offscreen;
+import mdux.test;
+
+#include "../framework/MduXTest.hpp"
+#include "PixelExpectation.hpp"
+
+namespace {
+
+namespace core = mdux::core;
+
+constexpr core::ColorRgba8 background{.r = 0, .g = 0, .b = 0, .a = 255};
+constexpr core::ColorRgba8 red{.r = 255, .g = 0, .b = 0, .a = 255};
+
+}  // namespace
+
+TEST_CASE("diffImages() finds scattered differences in a maxPixels frame", "pixel") {
+    constexpr core::Extent2D large{.width = 2048, .height = 2048};
+    static_assert(std::uint64_t{2048} * 2048 == mdux::render::OffscreenTarget::maxPixels);
+    mdux::test::ExpectedImage expected{large, background};
+    expected.paint(core::Rect{.x = 100, .y = 100, .width = 1800, .height = 1200}, red);
+    const std::vector<core::ColorRgba8> reference = expected.render();
+
+    // Scattered over the whole frame: one pixel in 4099 beyond the tolerance in green, and as
+    // many within it in blue.
+    std::vector<core::ColorRgba8> actual = reference;
+    for (std::size_t i = 0; i + 2049 < actual.size(); i += 4099) {
+        actual[i].g = static_cast<std::uint8_t>(actual[i].g + 3);
+        actual[i + 2049].b = static_cast<std::uint8_t>(actual[i + 2049].b + 2);
+    }
+    const mdux::test::ChannelTolerance two{.r = 2, .g = 2, .b = 2, .a = 0};
+
+    mdux::test::ImageDiff found;
+    auto fastest = std::chrono::steady_clock::duration::max();
+    for (int run = 0; run < 5; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        found = mdux::test::diffImages(large, reference, actual, two);
+        fastest = std::min(fastest, std::chrono::steady_clock::now() - start);
+    }
+
+    CHECK(found.differing == 1023);
+    constexpr core::Rect scattered{.x = 0, .y = 0, .width = 2047, .height = 2046};
+    CHECK(found.bounds == scattered);
+    CHECK(static_cast<std::size_t>(std::ranges::count(found.mask, std::uint8_t{1})) == 1023);
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(fastest);
+    std::println("  (diffImages() over 2048x2048: {} us, fastest of five)", elapsed.count());
+}
@@ -197,6 +197,75 @@ TEST_CASE("Later rectangles paint over earlier ones", "pixel") {
     CHECK(expected.at(20, 20) == background);
 }
 
+TEST_CASE("render() paints the frame at() describes, clipped to the extent", "pixel") {
+    // render() is the fast path every comparison now takes, so it is held to the slow one.
+    ExpectedImage expected{surface, background};
+    expected.paint(core::Rect{.x = -4, .y = -2, .width = 12, .height = 8}, red);
+    expected.paint(core::Rect{.x = 40, .y = 24, .width = 16, .height = 16}, blue);
+    expected.paint(core::Rect{.x = 6, .y = 4, .width = 0, .height = 5}, blue);
+
+    CHECK(expected.render() == renderExpected(expected));
+}
+
+TEST_CASE("A tolerance admits each channel's difference up to it, and no further", "pixel") {
+    ExpectedImage expected{surface, background};
+    expected.paint(core::Rect{.x = 2, .y = 2, .width = 4, .height = 4}, red);
+    const std::vector<core::ColorRgba8> reference = expected.render();
+
+    std::vector<core::ColorRgba8> actual = reference;
+    actual[indexOf(3, 3)] = core::ColorRgba8{.r = 253, .g = 2, .b = 0, .a = 255};
+
+    const mdux::test::ChannelTolerance two{.r = 2, .g = 2, .b = 2, .a = 0};
+    CHECK(compare(surface, reference, actual, two).matched());
+    const mdux::test::ChannelTolerance tight{.r = 1, .g = 2, .b = 2, .a = 0};
+    CHECK(compare(surface, reference, actual, tight).differing == 1);
+
+    // Alpha is a channel like the others: a zero alpha tolerance still sees it.
+    actual[indexOf(3, 3)] = core::ColorRgba8{.r = 255, .g = 0, .b = 0, .a = 254};
+    CHECK(compare(surface, reference, actual, two).differing == 1);
+}
+
+TEST_CASE("The diff mask and bounding box hold exactly the differing pixels", "pixel") {
+    ExpectedImage expected{surface, background};
+    const std::vector<core::ColorRgba8> reference = expected.render();
+    std::vector<core::ColorRgba8> actual = reference;
+    actual[indexOf(3, 5)] = blue;
+    actual[indexOf(20, 9)] = red;
+
+    const auto found = mdux::test::diffImages(surface, reference, actual);
+    CHECK(found.differing == 2);
+    constexpr core::Rect around{.x = 3, .y = 5, .width = 18, .height = 5};
+    CHECK(found.bounds == around);
+    REQUIRE(found.mask.size() == surfacePixels);
+    CHECK(std::ranges::count(found.mask, std::uint8_t{1}) == 2);
+    CHECK(found.mask[indexOf(3, 5)] == 1);
+    CHECK(found.mask[indexOf(20, 9)] == 1);
+
+    const auto diff = compare(surface, reference, actual);
+    CHECK(diff.bounds == found.bounds);
+    CHECK(diff.message.find("within 18x5 at (3, 5)") != std::string::npos);
+    CHECK(diff.message.find("(3, 5): expected #000000ff, actual #0000ffff") != std::string::npos);
+
+    CHECK(mdux::test::diffImages(surface, reference, reference).bounds == core::Rect{});
+}
+
+TEST_CASE("A whole 2048x2048 frame is compared, every pixel", "pixel") {
+    // The largest readback OffscreenTarget allows; one pixel in the far corner still fails it.
+    constexpr core::Extent2D large{.width = 2048, .height = 2048};
+    ExpectedImage expected{large, background};
+    expected.paint(core::Rect{.x = 100, .y = 100, .width = 1800, .height = 1200}, red);
+    const std::vector<core::ColorRgba8> reference = expected.render();
+
+    std::vector<core::ColorRgba8> actual = reference;
+    CHECK(compare(large, reference, actual).matched());
+
+    actual.back() = blue;
+    const auto diff = compare(large, reference, actual);
+    CHECK(diff.differing == 1);
+    constexpr core::Rect corner{.x = 2047, .y = 2047, .width = 1, .height = 1};
+    CHECK(diff.bounds == corner);
+}
+
 // ---------------------------------------------------------------------------
 // The pixel test proper
 // ---------------------------------------------------------------------------
@@ -367,3 +436,60 @@ TEST_CASE("The vertex colour reaches the pixel unmodified", "pixel") {
     const auto diff = compare(expected, *pixels);
     CHECK_MESSAGE(diff.matched(), diff.message);
 }
+
+TEST_CASE("Occlusion culling changes no pixel of the frame", "pixel") {
+    // The claim cullOccluded() makes, checked where it matters: the culled list against the same
+    // expectation the full list is held to. The half-covered rectangle is the one that would
+    // show a pass dropping too much.
+    const auto& gpu = sharedDevice();
+    auto target = OffscreenTarget::create(gpu.device(), gpu.physicalDevice(), surface,
+                                          gpu.queueFamilyIndex());
+    REQUIRE(target.has_value());
+
+    VulkanRenderContext context;
+    context.device = gpu.device();
+    context.physicalDevice = gpu.physicalDevice();
+    context.renderPass = target->renderPass();
+    context.queue = gpu.queue();
+    context.queueFamilyIndex = gpu.queueFamilyIndex();
+    context.viewport = surface;
+
+    auto renderer = UiRenderer::create(context, mdux::shader::generated::mdux_ui::package(),
+                                       Frame::budget());
+    REQUIRE(renderer.has_value());
+
+    Frame frame;
+    auto list = draw::DrawList::create(frame.vertices, frame.indices, frame.commands,
+                                       Frame::budget());
+    REQUIRE(list.has_value());
+
+    constexpr core::Rect covered{.x = 6, .y = 6, .width = 8, .height = 8};
+    constexpr core::Rect halfCovered{.x = 20, .y = 10, .width = 16, .height = 8};
+    constexpr core::Rect panel{.x = 4, .y = 4, .width = 24, .height = 20};
+    constexpr core::ColorRgba8 green{.r = 0, .g = 255, .b = 0, .a = 255};
+    REQUIRE(list->addSolidRect(covered, red).has_value());
+    REQUIRE(list->addSolidRect(halfCovered, green).has_value());
+    REQUIRE(list->addSolidRect(panel, blue).has_value());
+
+    ExpectedImage expected{surface, background};
+    expected.paint(covered, red);
+    expected.paint(halfCovered, green);
+    expected.paint(panel, blue);
+
+    RecordContext recording{.renderer = &*renderer, .list = &*list};
+    auto full = target->renderAndRead(gpu.queue(), background, recordFrame, &recording);
+    REQUIRE(full.has_value());
+
+    std::array<core::Rect, 6> tiles{};  // 3 x 2 tiles of 16 over 48 x 32
+    auto grid = draw::OcclusionGrid::create(tiles, surface, 16);
+    REQUIRE(grid.has_value());
+    CHECK(list->cullOccluded(*grid) == 2);
+
+    auto culled = target->renderAndRead(gpu.queue(), background, recordFrame, &recording);
+    REQUIRE(culled.has_value());
+
+    const auto fullDiff = compare(expected, *full);
+    CHECK_MESSAGE(fullDiff.matched(), fullDiff.message);
+    const auto culledDiff = compare(expected, *culled);
+    CHECK_MESSAGE(culledDiff.matched(), culledDiff.message);
+}
@@ -191,13 +191,61 @@ TEST_CASE("A budget with no room for one primitive is rejected", "evidence-unit"
     CHECK(creationError(context, package, noCommands) == RenderError::EmptyBudget);
 }
 
-TEST_CASE("A budget beyond the index width is rejected", "evidence-unit") {
+TEST_CASE("A budget beyond what a vertex offset can address is rejected", "evidence-unit") {
     // The same ceiling mdux.draw enforces, checked again here because a renderer built from a
-    // budget DrawList would refuse could never record a full frame.
+    // budget DrawList would refuse could never record a full frame. Past 65536 vertices is
+    // not past it: the list splits into batches, and each command carries its vertex offset.
     constexpr draw::DrawBudget tooLarge{
-        .maxVertices = draw::maxIndexableVertices + 1, .maxIndices = 96, .maxCommands = 4};
+        .maxVertices = draw::maxListVertices + 1U, .maxIndices = 96, .maxCommands = 4};
     CHECK(creationError(plausibleContext(), packageWith(bothStages), tooLarge) ==
           RenderError::BudgetExceedsIndexWidth);
+
+    // Within the list's ceiling, but not once the resident range is in front of it.
+    constexpr draw::DrawBudget atCeiling{
+        .maxVertices = draw::maxListVertices, .maxIndices = 96, .maxCommands = 4};
+    constexpr draw::SegmentBudget segments{.maxSegments = 1, .maxVertices = 3, .maxIndices = 3};
+    auto renderer =
+        UiRenderer::create(plausibleContext(), packageWith(bothStages), atCeiling, segments);
+    CHECK(!renderer.has_value() && renderer.error() == RenderError::BudgetExceedsIndexWidth);
+}
+
+TEST_CASE("Frames in flight are checked against the budget they multiply", "evidence-unit") {
+    // No frame region at all is as empty as a budget with no room for a primitive.
+    auto none =
+        UiRenderer::create(plausibleContext(), packageWith(bothStages), workableBudget, {}, 0);
+    CHECK(!none.has_value() && none.error() == RenderError::EmptyBudget);
+
+    // Each region fits alone, but the last one's vertex offset would not: the ring is the budget
+    // times the frame count, and that is what the offset must reach.
+    constexpr draw::DrawBudget half{
+        .maxVertices = draw::maxListVertices / 2 + 1, .maxIndices = 96, .maxCommands = 4};
+    auto twice = UiRenderer::create(plausibleContext(), packageWith(bothStages), half, {}, 2);
+    CHECK(!twice.has_value() && twice.error() == RenderError::BudgetExceedsIndexWidth);
+
+    // The same for the first index, which is 32 bits wide whatever the vertex count.
+    constexpr draw::DrawBudget manyIndices{
+        .maxVertices = 64, .maxIndices = 1U << 30, .maxCommands = 4};
+    auto fourTimes =
+        UiRenderer::create(plausibleContext(), packageWith(bothStages), manyIndices, {}, 4);
+    CHECK(!fourTimes.has_value() && fourTimes.error() == RenderError::BudgetExceedsIndexWidth);
+}
+
+TEST_CASE("An atlas with no area is rejected", "evidence-unit") {
+    constexpr AtlasBudget flat{.extent = {.width = 256, .height = 0}, .stagingBytes = 4096};
+    auto renderer = UiRenderer::create(plausibleContext(), packageWith(bothStages), workableBudget,
+                                       {}, 1, GeometryMemory::Automatic, flat);
+    CHECK(!renderer.has_value() && renderer.error() == RenderError::EmptyBudget);
+}
+
+TEST_CASE("A segment budget that allows segments but reserves no room is rejected",
+          "evidence-unit") {
+    // Caught at create() rather than as SegmentBudgetExceeded on the first retain(), where it
+    // would look like a screen that outgrew its budget instead of a budget that was never set.
+    constexpr draw::SegmentBudget noRoom{.maxSegments = 2, .maxVertices = 0, .maxIndices = 0};
+    auto renderer =
+        UiRenderer::create(plausibleContext(), packageWith(bothStages), workableBudget, noRoom);
+    CHECK(!renderer.has_value());
+    CHECK(!renderer.has_value() && renderer.error() == RenderError::EmptyBudget);
 }
 
 TEST_CASE("A package missing a stage is reported by which stage", "evidence-unit") {
@@ -255,7 +303,7 @@ TEST_CASE("UiPushConstants matches the block the shader package declares", "evid
 }
 
 TEST_CASE("Every RenderError has its own description", "evidence-unit") {
-    constexpr std::array<RenderError, 27> all{
+    constexpr std::array<RenderError, 51> all{
         RenderError::NullDevice,
         RenderError::NullPhysicalDevice,
         RenderError::NullRenderPass,
@@ -283,6 +331,30 @@ TEST_CASE("Every RenderError has its own description", "evidence-unit") {
         RenderError::AtlasUploadFailed,
         RenderError::NullCommandBuffer,
         RenderError::FrameExceedsBudget,
+        RenderError::SegmentIdOutOfRange,
+        RenderError::SegmentAlreadyRetained,
+        RenderError::SegmentBudgetExceeded,
+        RenderError::SegmentNotRetained,
+        RenderError::FrameSlotOutOfRange,
+        RenderError::FrameNotStaged,
+        RenderError::AtlasRegionOutOfBounds,
+        RenderError::AtlasTexelsMismatch,
+        RenderError::AtlasStagingExhausted,
+        RenderError::PipelineCacheNotProvided,
+        RenderError::PipelineCacheStorageTooSmall,
+        RenderError::PipelineCacheReadFailed,
+        RenderError::TimestampsUnsupported,
+        RenderError::QueryPoolCreationFailed,
+        RenderError::TimestampsNotEnabled,
+        RenderError::TimestampsNotReset,
+        RenderError::TimestampsNotAvailable,
+        RenderError::LayerIdOutOfRange,
+        RenderError::LayerNotStatic,
+        RenderError::LayerNotRecorded,
+        RenderError::LayerRecordingFailed,
+        RenderError::ViewCountOutOfRange,
+        RenderError::NullDrawList,
+        RenderError::InvalidViewArea,
     };
     std::vector<std::string_view> seen;
     for (const RenderError error : all) {
@@ -401,3 +473,29 @@ TEST_CASE("A push constant range record() could not fill is refused", "evidence-
     CHECK(creationError(plausibleContext(), staged, workableBudget) ==
           RenderError::UnsupportedPushConstantContract);
 }
+
+// ---------------------------------------------------------------------------
+// Pipeline cache persistence
+// ---------------------------------------------------------------------------
+
+TEST_CASE("A pipeline cache key follows the SPIR-V it was built from", "evidence-unit") {
+    constexpr std::array<std::byte, 4> rebaked{std::byte{1}, std::byte{0}, std::byte{0},
+                                               std::byte{0}};
+    const shader::PackageView package = packageWith(bothStages);
+    shader::PackageView changed = package;
+    changed.spirv = rebaked;
+
+    CHECK(pipelineCacheKey(package) == pipelineCacheKey(packageWith(bothStages)));
+    CHECK(pipelineCacheKey(package) != pipelineCacheKey(changed));
+}
+
+TEST_CASE("Bytes that are not a saved cache for this package offer the driver nothing",
+          "evidence-unit") {
+    const shader::PackageView package = packageWith(bothStages);
+    CHECK(pipelineCacheInitialData({}, package).empty());
+
+    std::array<std::byte, pipelineCacheHeaderBytes + 16> garbage{};
+    garbage.fill(std::byte{0x5A});
+    CHECK(pipelineCacheInitialData(garbage, package).empty());
+}
+
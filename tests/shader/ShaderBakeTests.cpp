@@ -20,6 +20,7 @@ import mdux.evidence.digest;
 import mdux.evidence.report;
 import mdux.shader.schema;
 import mdux.tools.cli;
+import mdux.tools.io;
 import mdux.tools.shaderbake;
 import speclab;
 
@@ -71,7 +72,7 @@ void writeText(const std::filesystem::path& path, std::string_view text) {
 }
 
 [[nodiscard]] std::vector<std::byte> readBytes(const std::filesystem::path& path) {
-    auto bytes = readFile(path);
+    auto bytes = mdux::tools::io::readFile(path);
     return bytes.value_or(std::vector<std::byte>{});
 }
 
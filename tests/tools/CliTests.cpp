@@ -117,6 +117,39 @@ const mdux::spec::Register verifyTakesRecipeAndCommittedFiles{
             .Execute();
     }};
 
+const mdux::spec::Register strictIsAVerifyOption{
+    "--strict selects full regeneration for verify and is refused for bake", "evidence-unit", [] {
+        struct State {
+            Invocation plain;
+            Invocation strict;
+            std::string bakeError;
+        };
+        auto state = std::make_shared<State>();
+
+        return speclab::Test("cli-strict-is-a-verify-option")
+            .Given("verify with and without --strict, and bake with it",
+                   [state] {
+                       state->plain = parsedOk({"verify", "r.toml", "p.json", "r.json"});
+                       state->strict =
+                           parsedOk({"verify", "--strict", "r.toml", "p.json", "r.json"});
+                       state->bakeError = usageErrorOf({"bake", "r.toml", "out", "--strict"});
+                   })
+            .When("each is parsed", [] {})
+            .Then("verify defaults to non-strict, accepts the flag anywhere, and bake refuses it",
+                  [state] {
+                      mdux::spec::Checks checks;
+                      checks.expect(!state->plain.verify.strict, "strict is off by default");
+                      checks.expect(state->strict.verify.strict, "--strict turns it on");
+                      checks.expect(state->strict.verify.recipe == "r.toml",
+                                    "the flag is not taken as a positional");
+                      checks.expect(state->bakeError.find("--strict applies to verify only") !=
+                                        std::string::npos,
+                                    "bake names the misplaced flag");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
 const mdux::spec::Register formatAcceptedEverywhere{
     "--format is accepted before, between and after positionals", "evidence-unit", [] {
         struct State {
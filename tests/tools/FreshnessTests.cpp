@@ -0,0 +1,228 @@
+/**
+ * @file FreshnessTests.cpp
+ * @brief BDD scenarios for mdux.tools.freshness, the report-driven shortcut behind `verify`.
+ *
+ * @compliance ADR-007 Evidence pipeline doctrine
+ *
+ * The shortcut is only safe if every record it skips regenerating for is actually compared, so
+ * the scenarios below change one file at a time - recipe, input, output, report - and require
+ * each change to be noticed and named. A check that passed a stale artifact would be worse than
+ * no shortcut at all, because `verify` would then report OK for something CI is about to reject.
+ *
+ * Everything is written under a temporary directory, never the source tree.
+ */
+
+import std;
+import speclab;
+import mdux.evidence.digest;
+import mdux.evidence.json;
+import mdux.evidence.report;
+import mdux.tools.cli;
+import mdux.tools.freshness;
+
+#include "../framework/SpecLabBridge.hpp"
+#include "TempDir.hpp"
+
+namespace {
+
+namespace cli = mdux::tools::cli;
+namespace evidence = mdux::evidence;
+namespace json = mdux::evidence::json;
+using mdux::tools::freshness::check;
+using mdux::tools::freshness::verifyShortcut;
+
+using mdux::test::TempDir;
+
+constexpr std::string_view kTool = "mdux-testbake";
+
+void writeText(const std::filesystem::path& path, std::string_view text) {
+    mdux::test::writeFile(path, std::as_bytes(std::span{text}));
+}
+
+[[nodiscard]] evidence::FileRecord record(std::string path, std::string_view contents) {
+    return evidence::FileRecord{.path = std::move(path),
+                                .sha256 = evidence::sha256(std::as_bytes(std::span{contents}))};
+}
+
+/// A baked-looking artifact: one recipe, one input, two outputs and the report naming them all.
+struct Fixture {
+    TempDir root{"mdux-freshness-test"};
+    cli::VerifyArguments arguments{.recipe = "recipes/demo.toml",
+                                   .packagePath = "",
+                                   .reportPath = ""};
+
+    Fixture() : Fixture(MDUX_TOOL_VERSION) {}
+
+    explicit Fixture(std::string_view toolVersion) {
+        constexpr std::string_view recipe = "id = \"demo\"\n";
+        constexpr std::string_view input = "source bytes";
+        constexpr std::string_view package = "{\"id\": \"demo\"}\n";
+        constexpr std::string_view blob = "blob bytes";
+
+        writeText(root.path() / "recipes/demo.toml", recipe);
+        writeText(root.path() / "assets/demo.bin", input);
+        writeText(root.path() / "generated/demo/package.json", package);
+        writeText(root.path() / "generated/demo/blob.bin", blob);
+
+        evidence::BakeReport report{
+            .tool = std::string{kTool},
+            .toolVersion = std::string{toolVersion},
+            .recipe = record("recipes/demo.toml", recipe),
+            .inputs = {record("assets/demo.bin", input)},
+            .options = json::Value::emptyObject(),
+            .outputs = {record("package.json", package), record("blob.bin", blob)},
+        };
+        auto text = report.write();
+        if (text.has_value()) {
+            writeText(root.path() / "generated/demo/report.json", *text);
+        }
+
+        arguments.packagePath = (root.path() / "generated/demo/package.json").string();
+        arguments.reportPath = (root.path() / "generated/demo/report.json").string();
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Scenarios
+// ---------------------------------------------------------------------------
+
+const mdux::spec::Register unchangedArtifactSkipsRegeneration{
+    "An artifact whose every recorded file matches is vouched for", "evidence-unit", [] {
+        return speclab::Test("freshness-unchanged")
+            .Given("a report whose recipe, input and outputs all match the files on disk", [] {})
+            .When("freshness is checked", [] {})
+            .Then("it is unchanged, having hashed every recorded file once",
+                  [] {
+                      mdux::spec::Checks checks;
+                      Fixture fixture;
+                      const auto result = check(kTool, fixture.arguments, fixture.root.path());
+                      checks.expect(result.unchanged, result.reason);
+                      checks.expect(result.filesHashed == 4, "recipe, input and two outputs");
+
+                      // A "./" on the command line is the same recipe, not a different one.
+                      fixture.arguments.recipe = "./recipes/demo.toml";
+                      checks.expect(check(kTool, fixture.arguments, fixture.root.path()).unchanged,
+                                    "a redundant ./ does not defeat the shortcut");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register everyRecordIsLoadBearing{
+    "A change to any recorded file falls through to full regeneration", "evidence-unit", [] {
+        return speclab::Test("freshness-every-record-is-load-bearing")
+            .Given("one fresh fixture per file, with that one file edited", [] {})
+            .When("freshness is checked", [] {})
+            .Then("each edit is noticed and the reason names the file",
+                  [] {
+                      mdux::spec::Checks checks;
+                      for (const std::string_view file :
+                           {"recipes/demo.toml", "assets/demo.bin", "generated/demo/package.json",
+                            "generated/demo/blob.bin"}) {
+                          Fixture fixture;
+                          writeText(fixture.root.path() / file, "edited");
+                          const auto result =
+                              check(kTool, fixture.arguments, fixture.root.path());
+                          const std::string name =
+                              std::filesystem::path{file}.filename().generic_string();
+                          checks.expect(!result.unchanged && result.reason.contains(name),
+                                        std::format("editing {} is noticed: {}", file,
+                                                    result.reason));
+                      }
+
+                      // A missing output is as stale as a changed one.
+                      Fixture fixture;
+                      std::filesystem::remove(fixture.root.path() / "generated/demo/blob.bin");
+                      const auto missing = check(kTool, fixture.arguments, fixture.root.path());
+                      checks.expect(!missing.unchanged && missing.reason.contains("cannot be read"),
+                                    "a deleted output is noticed");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register reportIdentityIsChecked{
+    "A report from another tool, version or recipe is not trusted", "evidence-unit", [] {
+        return speclab::Test("freshness-report-identity")
+            .Given("reports that match their files but not the invocation", [] {})
+            .When("freshness is checked", [] {})
+            .Then("each is refused with its reason, and a malformed report too",
+                  [] {
+                      mdux::spec::Checks checks;
+
+                      Fixture otherVersion{"0.0.0-elsewhere"};
+                      const auto version =
+                          check(kTool, otherVersion.arguments, otherVersion.root.path());
+                      checks.expect(!version.unchanged &&
+                                        version.reason.contains("0.0.0-elsewhere"),
+                                    "a different toolVersion is refused");
+
+                      Fixture otherTool;
+                      checks.expect(!check("mdux-otherbake", otherTool.arguments,
+                                           otherTool.root.path())
+                                         .unchanged,
+                                    "a different tool is refused");
+
+                      Fixture otherRecipe;
+                      writeText(otherRecipe.root.path() / "recipes/other.toml", "id = \"demo\"\n");
+                      otherRecipe.arguments.recipe = "recipes/other.toml";
+                      checks.expect(!check(kTool, otherRecipe.arguments, otherRecipe.root.path())
+                                         .unchanged,
+                                    "a report for a different recipe is refused");
+
+                      Fixture otherPackage;
+                      otherPackage.arguments.packagePath =
+                          (otherPackage.root.path() / "generated/demo/other.json").string();
+                      const auto package =
+                          check(kTool, otherPackage.arguments, otherPackage.root.path());
+                      checks.expect(!package.unchanged &&
+                                        package.reason.contains("does not record other.json"),
+                                    "a package the report does not name is refused");
+
+                      Fixture malformed;
+                      writeText(malformed.arguments.reportPath, "{\"tool\": ");
+                      checks.expect(!check(kTool, malformed.arguments, malformed.root.path())
+                                         .unchanged,
+                                    "a malformed report is refused");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register onlyVerifyTakesTheShortcut{
+    "Only a verify without --strict asks the report", "evidence-unit", [] {
+        return speclab::Test("freshness-verify-shortcut")
+            .Given("a bake, a strict verify and a verify against a malformed report", [] {})
+            .When("each baker's main asks verifyShortcut()", [] {})
+            .Then("none ends early, and only the verify is told why it regenerates",
+                  [] {
+                      mdux::spec::Checks checks;
+                      Fixture fixture;
+                      writeText(fixture.arguments.reportPath, "{\"tool\": ");
+                      cli::Invocation invocation{.mode = cli::Mode::Bake,
+                                                 .verify = fixture.arguments};
+
+                      std::vector<cli::Diagnostic> diagnostics;
+                      checks.expect(!verifyShortcut(kTool, invocation, diagnostics).has_value() &&
+                                        diagnostics.empty(),
+                                    "a bake never asks the report");
+
+                      invocation.mode = cli::Mode::Verify;
+                      invocation.verify.strict = true;
+                      checks.expect(!verifyShortcut(kTool, invocation, diagnostics).has_value() &&
+                                        diagnostics.empty(),
+                                    "--strict never asks the report");
+
+                      invocation.verify.strict = false;
+                      checks.expect(!verifyShortcut(kTool, invocation, diagnostics).has_value(),
+                                    "a stale report falls through to the full path");
+                      checks.expect(diagnostics.size() == 1 &&
+                                        diagnostics.front().code ==
+                                            "mdux.tools.verify.regenerating",
+                                    "with a note saying why");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+}  // namespace
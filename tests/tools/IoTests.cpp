@@ -0,0 +1,106 @@
+/**
+ * @file IoTests.cpp
+ * @brief BDD scenarios for mdux.tools.io, the shared input reader every baker uses.
+ *
+ * @compliance ADR-007 Evidence pipeline doctrine
+ *
+ * The property that matters is the one a reader cannot see from a bake's output: whichever way an
+ * input was read, the bytes and the digest are the same. A mapping that returned a stale page, or
+ * a fallback that dropped a trailing chunk, would change an artifact on one machine only, which is
+ * the failure byte-verified evidence is least equipped to explain.
+ */
+
+import std;
+import speclab;
+import mdux.evidence.digest;
+import mdux.tools.io;
+
+#include "../framework/SpecLabBridge.hpp"
+#include "TempDir.hpp"
+
+namespace {
+
+namespace evidence = mdux::evidence;
+namespace io = mdux::tools::io;
+
+/// Deterministic, non-repeating contents spanning several fallback chunks and a partial one.
+[[nodiscard]] std::vector<std::byte> patterned(std::size_t size) {
+    std::vector<std::byte> bytes(size);
+    std::uint32_t state = 0x2545f491u;
+    for (std::byte& byte : bytes) {
+        state = state * 1664525u + 1013904223u;
+        byte = static_cast<std::byte>(state >> 24);
+    }
+    return bytes;
+}
+
+// ---------------------------------------------------------------------------
+// Scenarios
+// ---------------------------------------------------------------------------
+
+const mdux::spec::Register inputBytesAndDigestMatchTheFile{
+    "An opened input holds exactly the file's bytes and their digest", "evidence-unit", [] {
+        return speclab::Test("io-input-matches-file")
+            .Given("files of several sizes, including empty and not a multiple of any chunk",
+                   [] {})
+            .When("each is opened, moved, and its digest requested twice", [] {})
+            .Then("bytes and digest equal the file's own, however it was read",
+                  [] {
+                      mdux::spec::Checks checks;
+                      for (const std::size_t size :
+                           {std::size_t{0}, std::size_t{1}, std::size_t{4096},
+                            std::size_t{(1u << 16) * 3 + 17}}) {
+                          const std::vector<std::byte> expected = patterned(size);
+                          const mdux::test::TempDir temp{"mdux-io-test"};
+                          const auto path = temp.path() / "input.bin";
+                          mdux::test::writeFile(path, expected);
+
+                          auto opened = io::InputFile::open(path);
+                          checks.expect(opened.has_value(), std::format("{} bytes open", size));
+                          if (!opened.has_value()) {
+                              continue;
+                          }
+                          // Moving must carry the mapping or buffer, not copy or drop it.
+                          const io::InputFile file = std::move(*opened);
+
+                          checks.expect(std::ranges::equal(file.bytes(), expected),
+                                        std::format("{} bytes read back identically", size));
+                          checks.expect(file.sha256() == evidence::sha256(expected),
+                                        std::format("{} bytes hash identically", size));
+                          checks.expect(&file.sha256() == &file.sha256(),
+                                        "the digest is computed once and cached");
+                          // Zero bytes cannot be mapped anywhere; the fallback has to cover it.
+                          if (size == 0) {
+                              checks.expect(!file.mapped(), "an empty file is not mapped");
+                          }
+
+                          const auto copy = io::readFile(path);
+                          checks.expect(copy.has_value() && *copy == expected,
+                                        std::format("readFile copies {} bytes", size));
+                      }
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+const mdux::spec::Register missingInputIsAnError{
+    "A missing input is reported, not read as empty", "evidence-unit", [] {
+        return speclab::Test("io-missing-input")
+            .Given("a path that does not exist", [] {})
+            .When("it is opened", [] {})
+            .Then("open fails with Unopenable and readFile returns nothing",
+                  [] {
+                      mdux::spec::Checks checks;
+                      const std::filesystem::path missing =
+                          std::filesystem::temp_directory_path() / "mdux-io-test-does-not-exist";
+                      const auto opened = io::InputFile::open(missing);
+                      checks.expect(!opened.has_value() &&
+                                        opened.error() == io::IoError::Unopenable,
+                                    "open reports Unopenable");
+                      checks.expect(!io::readFile(missing).has_value(), "readFile is empty");
+                      checks.raise();
+                  })
+            .Execute();
+    }};
+
+}  // namespace
@@ -0,0 +1,44 @@
+/**
+ * @brief A scratch directory under the system temporary directory, removed on destruction.
+ *
+ * Test scaffolding shared by the host-tools suites, in the same spirit as HeadlessDevice.hpp:
+ * **include it after `import std;`**. Everything a tools test writes goes here, never into the
+ * source tree. Each directory's name carries a timestamp and a counter, because the suites run in
+ * parallel under CTest and two tests writing the same path would pass or fail by scheduling.
+ */
+#pragma once
+
+namespace mdux::test {
+
+/// Writes `contents` to `path`, creating its directories and replacing any file already there.
+inline void writeFile(const std::filesystem::path& path, std::span<const std::byte> contents) {
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    file.write(reinterpret_cast<const char*>(contents.data()),
+               static_cast<std::streamsize>(contents.size()));
+}
+
+class TempDir {
+public:
+    /// `prefix` names the suite in the directory's name, for whoever finds one left behind.
+    explicit TempDir(std::string_view prefix) {
+        const auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+        path_ = std::filesystem::temp_directory_path() /
+                std::format("{}-{}-{}", prefix, stamp, counter_++);
+        std::filesystem::create_directories(path_);
+    }
+    ~TempDir() {
+        std::error_code code;
+        std::filesystem::remove_all(path_, code);
+    }
+    TempDir(const TempDir&) = delete;
+    TempDir& operator=(const TempDir&) = delete;
+
+    [[nodiscard]] const std::filesystem::path& path() const noexcept { return path_; }
+
+private:
+    std::filesystem::path path_;
+    static inline int counter_ = 0;
+};
+
+}  // namespace mdux::test
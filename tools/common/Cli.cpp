@@ -71,11 +71,15 @@ std::string usage(std::string_view toolName) {
            "\n"
            "options:\n"
            "  --format=json|text   diagnostic output format (default: text)\n"
+           "  --strict             verify only: always regenerate, never trust report.json\n"
            "  --help               print this message\n"
            "\n"
            "bake writes the artifact into <output-dir>. verify produces the same artifact and\n"
            "compares it against the given committed files, writing nothing. A normal build only\n"
-           "ever runs verify; see ADR-007.\n";
+           "ever runs verify; see ADR-007.\n"
+           "\n"
+           "Without --strict, verify first checks the recipe, inputs and outputs against the\n"
+           "digests report.json records, and skips regeneration when every one still matches.\n";
 }
 
 Invocation parse(std::string_view toolName, std::span<const std::string_view> arguments) {
@@ -83,6 +87,7 @@ Invocation parse(std::string_view toolName, std::span<const std::string_view> ar
 
     // Separate options from positionals in one pass, so --format may appear anywhere.
     std::vector<std::string_view> positional;
+    bool strict = false;
     for (const std::string_view argument : arguments) {
         if (argument == "--help" || argument == "-h") {
             throw UsageError{usage(toolName)};
@@ -105,6 +110,10 @@ Invocation parse(std::string_view toolName, std::span<const std::string_view> ar
             throw UsageError{"--format takes its value with '=', as --format=json\n\n" +
                              usage(toolName)};
         }
+        if (argument == "--strict") {
+            strict = true;
+            continue;
+        }
         if (argument.starts_with("-") && argument != "-") {
             throw UsageError{"unrecognized option '" + std::string{argument} + "'\n\n" +
                              usage(toolName)};
@@ -120,6 +129,11 @@ Invocation parse(std::string_view toolName, std::span<const std::string_view> ar
     const std::span<const std::string_view> rest{positional.begin() + 1, positional.end()};
 
     if (subcommand == "bake") {
+        if (strict) {
+            // Rejected rather than ignored: a bake always regenerates, so accepting the flag
+            // would suggest a non-strict bake exists.
+            throw UsageError{"--strict applies to verify only\n\n" + usage(toolName)};
+        }
         if (rest.size() != 2) {
             throw UsageError{"bake takes exactly 2 arguments (<recipe> <output-dir>), got " +
                              std::to_string(rest.size()) + "\n\n" + usage(toolName)};
@@ -139,7 +153,8 @@ Invocation parse(std::string_view toolName, std::span<const std::string_view> ar
         invocation.mode = Mode::Verify;
         invocation.verify = VerifyArguments{.recipe = std::string{rest[0]},
                                             .packagePath = std::string{rest[1]},
-                                            .reportPath = std::string{rest[2]}};
+                                            .reportPath = std::string{rest[2]},
+                                            .strict = strict};
         return invocation;
     }
 
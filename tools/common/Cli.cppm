@@ -11,7 +11,7 @@
  * ```
  * mdux-<kind>bake bake   <recipe> <output-dir>
  * mdux-<kind>bake verify <recipe> <package.json> <report.json>
- *                        [--format=json|text]
+ *                        [--format=json|text] [--strict]
  * ```
  *
  * `bake` and `verify` must run the *same* code path with different output handling. If verify
@@ -19,6 +19,10 @@
  * baker against a different baker proves nothing. Baker authors: produce the artifact in memory
  * once, then either write it (bake) or compare it (verify).
  *
+ * `verify` without `--strict` may skip that run altogether when `report.json` still vouches for
+ * every file it records (mdux.tools.freshness). Skipping is the only alternative - there is never
+ * a second, cheaper way of producing the artifact.
+ *
  * ## The diagnostic envelope
  *
  * `--format=json` emits `{file, line, column, code, severity, message, fixHint}` per finding -
@@ -89,6 +93,9 @@ struct VerifyArguments {
     std::string recipe;
     std::string packagePath;
     std::string reportPath;
+    /// `--strict`: always regenerate and compare every byte, never take the report-driven
+    /// shortcut mdux.tools.freshness offers. What CI wants; see that module for what it trusts.
+    bool strict{false};
 };
 
 /// A parsed command line. Exactly one of `bake`/`verify` is meaningful, per `mode`.
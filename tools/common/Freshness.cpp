@@ -0,0 +1,144 @@
+/**
+ * @file Freshness.cpp
+ * @brief Implementation of the report-driven freshness check behind incremental `verify`.
+ *
+ * @compliance ADR-004 Trust zones in C++ (host-tools zone)
+ * @compliance ADR-007 Evidence pipeline doctrine
+ */
+module;
+
+module mdux.tools.freshness;
+
+import std;
+import mdux.evidence.digest;
+import mdux.evidence.report;
+import mdux.tools.cli;
+import mdux.tools.io;
+
+namespace mdux::tools::freshness {
+
+namespace {
+
+namespace evidence = mdux::evidence;
+
+/// Compares one record against the file it names, recording the reason when they differ.
+[[nodiscard]] bool matches(const evidence::FileRecord& record,
+                           const std::filesystem::path& resolved, Freshness& freshness) {
+    const auto file = io::InputFile::open(resolved);
+    if (!file.has_value()) {
+        freshness.reason = std::format("{} cannot be read", record.path);
+        return false;
+    }
+    ++freshness.filesHashed;
+    if (file->sha256() != record.sha256) {
+        freshness.reason =
+            std::format("{} has changed since report.json was written", record.path);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+Freshness check(std::string_view toolName, const cli::VerifyArguments& arguments,
+                const std::filesystem::path& root) {
+    Freshness freshness;
+
+    const auto reportFile = io::InputFile::open(arguments.reportPath);
+    if (!reportFile.has_value()) {
+        freshness.reason = "report.json cannot be read";
+        return freshness;
+    }
+    const auto report = evidence::BakeReport::parse(reportFile->text());
+    if (!report.has_value()) {
+        freshness.reason =
+            std::format("report.json does not parse: {}", evidence::describe(report.error()));
+        return freshness;
+    }
+
+    if (report->tool != toolName) {
+        freshness.reason = std::format("report.json was written by {}", report->tool);
+        return freshness;
+    }
+    if (report->toolVersion != MDUX_TOOL_VERSION) {
+        freshness.reason = std::format("report.json was written by {} {}, this is {}",
+                                       report->tool, report->toolVersion, MDUX_TOOL_VERSION);
+        return freshness;
+    }
+
+    // The report records the recipe repository-relative; the command line may spell it with a
+    // redundant "./" or similar, which must not read as a different recipe.
+    const std::string recipe =
+        std::filesystem::path{arguments.recipe}.lexically_normal().generic_string();
+    if (recipe != report->recipe.path) {
+        freshness.reason = std::format("report.json records recipe {}", report->recipe.path);
+        return freshness;
+    }
+    if (!matches(report->recipe, root / report->recipe.path, freshness)) {
+        return freshness;
+    }
+
+    for (const evidence::FileRecord& input : report->inputs) {
+        if (!matches(input, root / input.path, freshness)) {
+            return freshness;
+        }
+    }
+
+    // The package itself has to be one of the recorded outputs, or the report describes some
+    // other artifact and its digests say nothing about the file verify was asked about.
+    const std::filesystem::path packagePath{arguments.packagePath};
+    const std::string packageName = packagePath.filename().generic_string();
+    if (std::ranges::none_of(report->outputs, [&](const evidence::FileRecord& output) {
+            return output.path == packageName;
+        })) {
+        freshness.reason = std::format("report.json does not record {}", packageName);
+        return freshness;
+    }
+
+    const std::filesystem::path outputDir = packagePath.parent_path();
+    for (const evidence::FileRecord& output : report->outputs) {
+        if (!matches(output, outputDir / output.path, freshness)) {
+            return freshness;
+        }
+    }
+
+    freshness.unchanged = true;
+    return freshness;
+}
+
+cli::Diagnostic staleNote(const Freshness& freshness, const cli::VerifyArguments& arguments) {
+    return cli::Diagnostic{
+        .file = arguments.reportPath,
+        .code = "mdux.tools.verify.regenerating",
+        .severity = cli::Severity::Note,
+        .message = std::format("regenerating in full: {}", freshness.reason),
+        .fixHint = "Not a failure. The report-driven shortcut only applies when the recipe, every "
+                   "input and every output still match report.json."};
+}
+
+std::optional<int> verifyShortcut(std::string_view toolName, const cli::Invocation& invocation,
+                                  std::vector<cli::Diagnostic>& diagnostics) {
+    if (invocation.mode != cli::Mode::Verify || invocation.verify.strict) {
+        return std::nullopt;
+    }
+    const Freshness current =
+        check(toolName, invocation.verify, std::filesystem::current_path());
+    if (!current.unchanged) {
+        diagnostics.push_back(staleNote(current, invocation.verify));
+        return std::nullopt;
+    }
+
+    const std::string rendered = cli::render(diagnostics, invocation.format, toolName);
+    if (!rendered.empty()) {
+        std::print(std::cout, "{}", rendered);
+    }
+    if (invocation.format == cli::Format::Text) {
+        std::println(std::cout,
+                     "{}: OK (verified against report.json: {} files unchanged, nothing "
+                     "regenerated; --strict re-bakes)",
+                     toolName, current.filesHashed);
+    }
+    return cli::exitStatus(diagnostics);
+}
+
+}  // namespace mdux::tools::freshness
@@ -0,0 +1,76 @@
+/**
+ * @file Freshness.cppm
+ * @brief The incremental half of `verify`: vouching for committed outputs from `report.json`.
+ *
+ * @compliance ADR-004 Trust zones in C++ (host-tools zone)
+ * @compliance ADR-005 Error handling and exceptions policy (host tools may throw)
+ * @compliance ADR-007 Evidence pipeline doctrine
+ *
+ * A full `verify` re-runs the bake in memory and compares every byte. For a large artifact that
+ * is minutes, and in a developer's edit-verify loop the answer is almost always "nothing this
+ * artifact depends on changed". `report.json` already records enough to establish that without
+ * baking: the tool and `toolVersion` that wrote it, a digest of the recipe, a digest of every
+ * input, and a digest of every output. If all of those still match the files on disk, a re-bake
+ * by the same tool version would reproduce the same report, and the committed outputs are the
+ * ones it describes.
+ *
+ * ## What the shortcut trusts, stated plainly
+ *
+ * It trusts that the report was written by a bake of the recorded `toolVersion`, that the report
+ * itself was not edited by hand, and that the tool's behaviour does not change without that
+ * version changing. Code changes that alter output without a version bump are exactly what it
+ * cannot see. That is why `--strict` keeps the full regeneration path, and why CI never relies on
+ * this: the `evidence.*` tests bake into the build tree and byte-compare, which is the check
+ * ADR-007 actually rests on.
+ *
+ * Any mismatch - an unreadable or malformed report, a different tool or version, a changed recipe,
+ * input or output, a package that is not among the report's outputs - falls through to the full
+ * path rather than failing, so the shortcut can only ever make a verify faster, never make one
+ * pass that the full path would fail for a reason the report records.
+ */
+module;
+
+export module mdux.tools.freshness;
+
+import std;
+import mdux.tools.cli;
+
+export namespace mdux::tools::freshness {
+
+/// The outcome of checking a committed report against the files it names.
+struct Freshness {
+    bool unchanged{false};  ///< every record matched, so regeneration can be skipped
+    std::string reason;     ///< when not unchanged: the first record that did not match
+    std::size_t filesHashed{0};
+};
+
+/**
+ * @brief Checks `arguments.reportPath` against the recipe, inputs and outputs it records.
+ *
+ * @param toolName the running tool's name, which the report's `tool` must equal
+ * @param root     the directory recipe and input paths resolve against - the repo root
+ *
+ * Output paths resolve beside `arguments.packagePath`, where `bake` wrote them. The recorded
+ * `toolVersion` must equal the one this tool was built with. Files are hashed in report order and
+ * the check stops at the first mismatch, so a changed recipe costs one small hash.
+ */
+[[nodiscard]] Freshness check(std::string_view toolName, const cli::VerifyArguments& arguments,
+                              const std::filesystem::path& root);
+
+/// The note a baker appends when it falls through to full regeneration, naming why.
+[[nodiscard]] cli::Diagnostic staleNote(const Freshness& freshness,
+                                        const cli::VerifyArguments& arguments);
+
+/**
+ * @brief The shortcut as every baker's `main` takes it, so the three cannot drift apart.
+ *
+ * Applies only to `verify` without `--strict`, checked against the current directory. When every
+ * record matches, renders `diagnostics` and the OK summary exactly as the full path would and
+ * returns the exit status, so `main` returns it without baking. Otherwise appends the
+ * `staleNote()` when one applies and returns nullopt, and `main` carries on as before.
+ */
+[[nodiscard]] std::optional<int> verifyShortcut(std::string_view toolName,
+                                                const cli::Invocation& invocation,
+                                                std::vector<cli::Diagnostic>& diagnostics);
+
+}  // namespace mdux::tools::freshness
@@ -0,0 +1,204 @@
+/**
+ * @file Io.cpp
+ * @brief Implementation of mdux.tools.io: read-only mappings with a buffered fallback.
+ *
+ * @compliance ADR-004 Trust zones in C++ (host-tools zone)
+ * @compliance ADR-007 Evidence pipeline doctrine
+ */
+module;
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+module mdux.tools.io;
+
+import std;
+import mdux.core.result;
+import mdux.evidence.digest;
+
+namespace mdux::tools::io {
+
+namespace {
+
+namespace evidence = mdux::evidence;
+using mdux::core::err;
+
+/// A successful mapping: the view and its length. Null data means "not mappable, read instead".
+struct Mapping {
+    const std::byte* data{nullptr};
+    std::size_t size{0};
+};
+
+#if defined(_WIN32)
+
+[[nodiscard]] Mapping mapReadOnly(const std::filesystem::path& path) noexcept {
+    const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return {};
+    }
+    LARGE_INTEGER length{};
+    Mapping mapping;
+    // A zero-length file cannot be mapped on Windows; the buffered path handles it trivially.
+    if (GetFileSizeEx(file, &length) != 0 && length.QuadPart > 0 &&
+        static_cast<unsigned long long>(length.QuadPart) <=
+            static_cast<unsigned long long>(std::numeric_limits<std::size_t>::max())) {
+        const HANDLE section = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (section != nullptr) {
+            if (const void* view = MapViewOfFile(section, FILE_MAP_READ, 0, 0, 0)) {
+                mapping = {static_cast<const std::byte*>(view),
+                           static_cast<std::size_t>(length.QuadPart)};
+            }
+            // The view keeps the section alive; neither handle is needed once it exists.
+            CloseHandle(section);
+        }
+    }
+    CloseHandle(file);
+    return mapping;
+}
+
+void unmap(const std::byte* data, std::size_t) noexcept {
+    UnmapViewOfFile(data);
+}
+
+#else
+
+[[nodiscard]] Mapping mapReadOnly(const std::filesystem::path& path) noexcept {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return {};
+    }
+    struct stat info{};
+    Mapping mapping;
+    // Regular files only: mmap of a FIFO or device either fails or does not mean "the file's
+    // bytes", and a zero length is an EINVAL the buffered path does not have.
+    if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        const auto length = static_cast<std::size_t>(info.st_size);
+        void* view = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view != MAP_FAILED) {
+            // Inputs are read front to back, once; say so, so the kernel reads ahead.
+            (void)::madvise(view, length, MADV_SEQUENTIAL);
+            mapping = {static_cast<const std::byte*>(view), length};
+        }
+    }
+    // The mapping holds its own reference to the file.
+    ::close(fd);
+    return mapping;
+}
+
+void unmap(const std::byte* data, std::size_t size) noexcept {
+    ::munmap(const_cast<std::byte*>(data), size);
+}
+
+#endif
+
+}  // namespace
+
+std::string_view describe(IoError error) noexcept {
+    switch (error) {
+    case IoError::Unopenable: return "cannot be opened";
+    case IoError::ReadFailed: return "could not be read to the end";
+    }
+    return "cannot be read";
+}
+
+InputFile::~InputFile() {
+    release();
+}
+
+InputFile::InputFile(InputFile&& other) noexcept
+    : data_{std::exchange(other.data_, nullptr)},
+      size_{std::exchange(other.size_, 0)},
+      mapped_{std::exchange(other.mapped_, false)},
+      buffer_{std::move(other.buffer_)},
+      digest_{std::exchange(other.digest_, std::nullopt)} {}
+
+InputFile& InputFile::operator=(InputFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        mapped_ = std::exchange(other.mapped_, false);
+        buffer_ = std::move(other.buffer_);
+        digest_ = std::exchange(other.digest_, std::nullopt);
+    }
+    return *this;
+}
+
+void InputFile::release() noexcept {
+    if (mapped_) {
+        unmap(data_, size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    buffer_.clear();
+    digest_.reset();
+}
+
+mdux::core::Result<InputFile, IoError> InputFile::open(const std::filesystem::path& path) {
+    InputFile file;
+
+    if (const Mapping mapping = mapReadOnly(path); mapping.data != nullptr) {
+        file.data_ = mapping.data;
+        file.size_ = mapping.size;
+        file.mapped_ = true;
+        return file;
+    }
+
+    // The fallback. Reads in chunks and hashes each one as it lands, so the digest a baker will
+    // almost certainly ask for is already paid for by the only pass over the bytes.
+    std::ifstream stream{path, std::ios::binary};
+    if (!stream) {
+        return err(IoError::Unopenable);
+    }
+    evidence::Sha256 hasher;
+    std::array<char, 65536> chunk{};
+    while (stream.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) ||
+           stream.gcount() > 0) {
+        const auto got = static_cast<std::size_t>(stream.gcount());
+        const auto bytes = std::as_bytes(std::span{chunk.data(), got});
+        file.buffer_.insert(file.buffer_.end(), bytes.begin(), bytes.end());
+        hasher.update(bytes);
+        if (stream.eof()) {
+            break;
+        }
+    }
+    if (stream.bad()) {
+        return err(IoError::ReadFailed);
+    }
+    file.data_ = file.buffer_.data();
+    file.size_ = file.buffer_.size();
+    file.digest_ = hasher.finish();
+    return file;
+}
+
+const evidence::Digest& InputFile::sha256() const noexcept {
+    if (!digest_.has_value()) {
+        digest_ = evidence::sha256(bytes());
+    }
+    return *digest_;
+}
+
+std::optional<std::vector<std::byte>> readFile(const std::filesystem::path& path) {
+    auto file = InputFile::open(path);
+    if (!file.has_value()) {
+        return std::nullopt;
+    }
+    const std::span<const std::byte> bytes = file->bytes();
+    return std::vector<std::byte>{bytes.begin(), bytes.end()};
+}
+
+}  // namespace mdux::tools::io
@@ -0,0 +1,101 @@
+/**
+ * @file Io.cppm
+ * @brief Read-only input files for every baker: mapped where possible, hashed at most once.
+ *
+ * @compliance ADR-004 Trust zones in C++ (host-tools zone: never linked into MduXCore or MduX)
+ * @compliance ADR-005 Error handling and exceptions policy (host tools may throw)
+ * @compliance ADR-007 Evidence pipeline doctrine
+ *
+ * Each baker used to carry its own `readFile()`: an `std::ifstream` loop copying the file into a
+ * `std::vector<std::byte>`, after which the bake hashed the copy for `report.json` - and, in
+ * mdux-shaderbake's case, hashed it a second time for the package's per-module digest. For a
+ * recipe that is nothing. For a multi-hundred-megabyte checkpoint it is two full copies in memory
+ * and two or three passes over them before any real work starts.
+ *
+ * `InputFile` replaces all of them. It maps the file read-only and hands out a span over the
+ * mapping, so the bytes are read once, by whoever touches them first, straight from the page
+ * cache. Where a file cannot be mapped - an empty file, a pipe, a filesystem that refuses - it
+ * falls back to one buffered read, and in that case hashes each chunk as it arrives, so the
+ * digest costs no second pass. Either way `sha256()` computes at most once and caches, so a
+ * baker asking for the same input's digest twice does not hash it twice.
+ *
+ * ## What a mapping does not change
+ *
+ * The bytes a baker sees are identical whichever path produced them; only the cost differs. That
+ * matters because ADR-007's byte-identity guarantee must not depend on which machine could map
+ * what. `mapped()` is exposed for tests and diagnostics, never for a decision that affects output.
+ *
+ * A mapped input is a view of a file someone else could modify during the bake. The bakers run on
+ * a developer's checkout or a CI workspace, where that is not a threat model worth a copy; a
+ * concurrent edit during a bake yields a report whose digests disagree with the file, which the
+ * next verify reports.
+ */
+module;
+
+export module mdux.tools.io;
+
+import std;
+import mdux.core.result;
+import mdux.evidence.digest;
+
+export namespace mdux::tools::io {
+
+enum class IoError : std::uint8_t {
+    Unopenable,  ///< missing, a directory, or not permitted
+    ReadFailed,  ///< opened, then failed part-way through
+};
+
+[[nodiscard]] std::string_view describe(IoError error) noexcept;
+
+/**
+ * @brief One input file's bytes, read-only, for the lifetime of this object.
+ *
+ * Move-only: the span it hands out points into a mapping or buffer this object owns.
+ */
+class InputFile {
+public:
+    InputFile() noexcept = default;  ///< an empty file
+    ~InputFile();
+    InputFile(const InputFile&) = delete;
+    InputFile& operator=(const InputFile&) = delete;
+    InputFile(InputFile&& other) noexcept;
+    InputFile& operator=(InputFile&& other) noexcept;
+
+    /// Maps `path`, or reads it through a buffer when mapping is not possible.
+    [[nodiscard]] static mdux::core::Result<InputFile, IoError> open(
+        const std::filesystem::path& path);
+
+    [[nodiscard]] std::span<const std::byte> bytes() const noexcept { return {data_, size_}; }
+
+    /// The bytes as text, for recipes. No encoding is checked here; the parser does that.
+    [[nodiscard]] std::string_view text() const noexcept {
+        return {reinterpret_cast<const char*>(data_), size_};
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+    /// True when the bytes are a mapping rather than a buffered copy. Never affects output.
+    [[nodiscard]] bool mapped() const noexcept { return mapped_; }
+
+    /// SHA-256 of the bytes. Computed on first request (already, for a buffered read) and cached.
+    [[nodiscard]] const mdux::evidence::Digest& sha256() const noexcept;
+
+private:
+    void release() noexcept;
+
+    const std::byte* data_{nullptr};
+    std::size_t size_{0};
+    bool mapped_{false};
+    std::vector<std::byte> buffer_;  ///< the fallback copy; empty when mapped
+    mutable std::optional<mdux::evidence::Digest> digest_;
+};
+
+/**
+ * @brief Reads `path` into an owned buffer, for a caller that needs to keep or modify the bytes.
+ *
+ * Prefer InputFile; this is the copy it avoids, kept for tests and for the few outputs a tool
+ * rereads to compare.
+ */
+[[nodiscard]] std::optional<std::vector<std::byte>> readFile(const std::filesystem::path& path);
+
+}  // namespace mdux::tools::io
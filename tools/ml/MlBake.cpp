@@ -16,6 +16,7 @@ import mdux.evidence.json;
 import mdux.evidence.report;
 import mdux.ml.schema;
 import mdux.tools.cli;
+import mdux.tools.io;
 import mdux.tools.toml;
 import mdux.tools.ml.safetensors;
 import mdux.tools.ml.archvalidate;
@@ -31,6 +32,7 @@ namespace ml = mdux::ml;
 namespace {
 
 constexpr std::string_view weightsFileName = "weights.bin";
+constexpr std::string_view goldensFileName = "goldens.bin";
 
 constexpr std::string_view recipeUnreadable = "mdux.ml.bake.recipeUnreadable";
 constexpr std::string_view recipeInvalid = "mdux.ml.bake.recipeInvalid";
@@ -143,6 +145,31 @@ void report(std::vector<cli::Diagnostic>& diagnostics, std::string file, std::si
     return object;
 }
 
+/// Appends `bits` to the golden sidecar as little-endian words and returns the byte range they
+/// occupy. Little-endian by explicit shifts, as the digest code does, so the sidecar's bytes are
+/// the format's rather than the baking host's.
+[[nodiscard]] json::Value appendBits(std::vector<std::byte>& sidecar,
+                                     std::span<const std::uint32_t> bits) {
+    json::Value range = json::Value::emptyObject();
+    (void)range.set("byteOffset", json::Value::unsignedInteger(sidecar.size()));
+    (void)range.set("byteLength", json::Value::unsignedInteger(bits.size() * 4));
+    for (const std::uint32_t word : bits) {
+        for (std::size_t shift = 0; shift < 32; shift += 8) {
+            sidecar.push_back(static_cast<std::byte>((word >> shift) & 0xffu));
+        }
+    }
+    return range;
+}
+
+/// A golden whose bit patterns live in the sidecar: two byte ranges in place of two arrays.
+[[nodiscard]] json::Value goldenToSidecar(const GeneratedGolden& golden,
+                                          std::vector<std::byte>& sidecar) {
+    json::Value object = json::Value::emptyObject();
+    (void)object.set("inputBits", appendBits(sidecar, golden.inputBits));
+    (void)object.set("expectedOutputBits", appendBits(sidecar, golden.expectedOutputBits));
+    return object;
+}
+
 [[nodiscard]] std::string hexOf(const evidence::Digest& digest) {
     const auto hex = evidence::toHex(digest);
     return std::string{hex.data(), hex.size()};
@@ -200,6 +227,14 @@ void report(std::vector<cli::Diagnostic>& diagnostics, std::string file, std::si
 
 }  // namespace
 
+std::string_view goldenStorageWire(GoldenStorage storage) noexcept {
+    switch (storage) {
+    case GoldenStorage::Json:    return "json";
+    case GoldenStorage::Sidecar: return "sidecar";
+    }
+    return "json";
+}
+
 json::Value Recipe::toOptions(std::uint32_t resolvedScratch) const {
     // Fully resolved, defaults expanded - see the Recipe comment and ADR-007.
     json::Value options = json::Value::emptyObject();
@@ -211,23 +246,11 @@ json::Value Recipe::toOptions(std::uint32_t resolvedScratch) const {
     (void)options.set("goldenSeed", json::Value::unsignedInteger(goldenSeed));
     // The algorithm is recorded, not just the seed: a seed alone does not determine the sequence.
     (void)options.set("goldenPrng", json::Value::string(std::string{goldenPrngAlgorithm}));
+    (void)options.set("goldenStorage",
+                      json::Value::string(std::string{goldenStorageWire(goldenStorage)}));
     return options;
 }
 
-std::optional<std::vector<std::byte>> readFile(const std::filesystem::path& path) {
-    std::ifstream file{path, std::ios::binary};
-    if (!file) {
-        return std::nullopt;
-    }
-    std::vector<char> contents{std::istreambuf_iterator<char>{file},
-                               std::istreambuf_iterator<char>{}};
-    std::vector<std::byte> bytes(contents.size());
-    for (std::size_t i = 0; i < contents.size(); ++i) {
-        bytes[i] = static_cast<std::byte>(static_cast<unsigned char>(contents[i]));
-    }
-    return bytes;
-}
-
 std::optional<Recipe> parseRecipe(std::string_view text, std::string_view recipePath,
                                   std::vector<cli::Diagnostic>& diagnostics) {
     toml::Document document{};
@@ -273,6 +296,18 @@ std::optional<Recipe> parseRecipe(std::string_view text, std::string_view recipe
                                goldenPrngAlgorithm));
             return std::nullopt;
         }
+        if (goldens->contains("storage")) {
+            const std::string storage = goldens->require("storage").asString();
+            if (storage == goldenStorageWire(GoldenStorage::Sidecar)) {
+                recipe.goldenStorage = GoldenStorage::Sidecar;
+            } else if (storage != goldenStorageWire(GoldenStorage::Json)) {
+                report(diagnostics, std::string{recipePath}, goldens->require("storage").line(),
+                       recipeInvalid,
+                       std::format("unknown golden storage '{}'", storage),
+                       "use \"json\" (the default) or \"sidecar\"");
+                return std::nullopt;
+            }
+        }
 
         const toml::Table* layers = document.table("layers");
         if (layers == nullptr) {
@@ -349,14 +384,17 @@ std::optional<BakeOutputs> run(const Recipe& recipe, std::string_view recipePath
                                const std::filesystem::path& root,
                                std::vector<cli::Diagnostic>& diagnostics) {
     const std::filesystem::path weightsPath = root / recipe.weightsSource;
-    auto weightsBytes = readFile(weightsPath);
-    if (!weightsBytes.has_value()) {
+    // Mapped, not copied: a checkpoint is by far the largest thing a bake reads, and the
+    // safetensors reader and the repacker only ever need a span over it.
+    auto weightsFile = io::InputFile::open(weightsPath);
+    if (!weightsFile.has_value()) {
         report(diagnostics, recipe.weightsSource, 0, weightsUnreadable,
                "cannot read the weights file named by the recipe");
         return std::nullopt;
     }
 
-    auto parsedWeights = parseSafetensors(*weightsBytes, recipe.weightsSource);
+    const std::span<const std::byte> weightsBytes = weightsFile->bytes();
+    auto parsedWeights = parseSafetensors(weightsBytes, recipe.weightsSource);
     if (!parsedWeights.has_value()) {
         diagnostics.push_back(parsedWeights.error());
         return std::nullopt;
@@ -369,7 +407,7 @@ std::optional<BakeOutputs> run(const Recipe& recipe, std::string_view recipePath
     spec.maxScratchFloats = recipe.maxScratchFloats;
     spec.layers = recipe.layers;
 
-    auto resolved = resolveArchitecture(spec, *parsedWeights, *weightsBytes, recipePath);
+    auto resolved = resolveArchitecture(spec, *parsedWeights, weightsBytes, recipePath);
     if (!resolved.has_value()) {
         for (const cli::Diagnostic& diagnostic : resolved.error()) {
             diagnostics.push_back(diagnostic);
@@ -440,13 +478,27 @@ std::optional<BakeOutputs> run(const Recipe& recipe, std::string_view recipePath
     }
     (void)packageJson.set("layers", json::Value::array(std::move(layerValues)));
 
+    const bool goldensInSidecar = recipe.goldenStorage == GoldenStorage::Sidecar;
+    std::vector<std::byte> goldenSidecar;
     std::vector<json::Value> goldenValues;
     goldenValues.reserve(goldens->size());
     for (const GeneratedGolden& golden : *goldens) {
-        goldenValues.push_back(goldenToJson(golden));
+        goldenValues.push_back(goldensInSidecar ? goldenToSidecar(golden, goldenSidecar)
+                                                : goldenToJson(golden));
     }
     (void)packageJson.set("goldens", json::Value::array(std::move(goldenValues)));
 
+    if (goldensInSidecar) {
+        // Recorded exactly as the weights record is, so a reader verifies both sidecars the
+        // same way: length first, then digest, before any range inside is trusted.
+        json::Value sidecarRecord = json::Value::emptyObject();
+        (void)sidecarRecord.set("path", json::Value::string(std::string{goldensFileName}));
+        (void)sidecarRecord.set("byteLength", json::Value::unsignedInteger(goldenSidecar.size()));
+        (void)sidecarRecord.set("sha256",
+                                json::Value::string(hexOf(evidence::sha256(goldenSidecar))));
+        (void)packageJson.set("goldenSidecar", std::move(sidecarRecord));
+    }
+
     auto packageText = json::write(packageJson);
     if (!packageText.has_value()) {
         report(diagnostics, std::string{recipePath}, 0, packageInvalid,
@@ -459,6 +511,10 @@ std::optional<BakeOutputs> run(const Recipe& recipe, std::string_view recipePath
     outputs.packageJson = std::move(*packageText);
     outputs.weights = std::move(resolved->weights);
     outputs.weightsName = std::string{weightsFileName};
+    if (goldensInSidecar) {
+        outputs.goldens = std::move(goldenSidecar);
+        outputs.goldensName = std::string{goldensFileName};
+    }
     outputs.packageId = recipe.id;
     outputs.layerCount = resolved->layers.size();
     outputs.goldenCount = goldens->size();
@@ -467,11 +523,15 @@ std::optional<BakeOutputs> run(const Recipe& recipe, std::string_view recipePath
     bakeReport.tool = std::string{bakeToolName};
     bakeReport.toolVersion = MDUX_TOOL_VERSION;
     bakeReport.recipe = fileRecord(std::string{recipePath}, recipeBytes);
-    bakeReport.inputs = {fileRecord(recipe.weightsSource, *weightsBytes)};
+    bakeReport.inputs = {
+        evidence::FileRecord{.path = recipe.weightsSource, .sha256 = weightsFile->sha256()}};
     bakeReport.options = recipe.toOptions(resolved->maxScratchFloats);
     // report.json is deliberately absent from its own outputs: a file cannot carry its own digest.
     bakeReport.outputs = {fileRecord("package.json", asBytes(outputs.packageJson)),
                           fileRecord(outputs.weightsName, outputs.weights)};
+    if (goldensInSidecar) {
+        bakeReport.outputs.push_back(fileRecord(outputs.goldensName, outputs.goldens));
+    }
 
     auto reportText = bakeReport.write();
     if (!reportText.has_value()) {
@@ -508,7 +568,7 @@ namespace {
 [[nodiscard]] bool compareArtifact(std::string_view label, std::span<const std::byte> produced,
                                    const std::filesystem::path& committedPath,
                                    std::vector<cli::Diagnostic>& diagnostics) {
-    auto committed = readFile(committedPath);
+    auto committed = io::InputFile::open(committedPath);
     if (!committed.has_value()) {
         report(diagnostics, reportPath(committedPath), 0, artifactMissing,
                std::format("{} is missing or unreadable", label),
@@ -518,11 +578,11 @@ namespace {
 
     const std::size_t common = std::min(produced.size(), committed->size());
     for (std::size_t i = 0; i < common; ++i) {
-        if (produced[i] != (*committed)[i]) {
+        if (produced[i] != committed->bytes()[i]) {
             report(diagnostics, reportPath(committedPath), 0, artifactDiffers,
                    std::format("{} differs at byte {}: produced 0x{:02x}, committed 0x{:02x}",
                                label, i, std::to_integer<unsigned>(produced[i]),
-                               std::to_integer<unsigned>((*committed)[i])),
+                               std::to_integer<unsigned>(committed->bytes()[i])),
                    "Run `cmake --build <dir> --target mdux-bake-update` and review the diff.");
             return false;
         }
@@ -549,6 +609,18 @@ bool write(const BakeOutputs& outputs, const std::filesystem::path& outputDir,
         return false;
     }
 
+    if (outputs.goldensName.empty()) {
+        // Goldens back inline after a sidecar bake: the old goldens.bin is named by nothing now,
+        // and a directory still holding it is not what a clean bake of this recipe produces.
+        std::filesystem::remove(outputDir / goldensFileName, code);
+        if (code) {
+            report(diagnostics, reportPath(outputDir / goldensFileName), 0, outputUnwritable,
+                   std::format("cannot remove the stale sidecar: {}", code.message()));
+            return false;
+        }
+    } else if (!writeBytes(outputDir / outputs.goldensName, outputs.goldens, diagnostics)) {
+        return false;
+    }
     return writeBytes(outputDir / "package.json", asBytes(outputs.packageJson), diagnostics) &&
            writeBytes(outputDir / outputs.weightsName, outputs.weights, diagnostics) &&
            writeBytes(outputDir / "report.json", asBytes(outputs.reportJson), diagnostics);
@@ -564,6 +636,17 @@ bool verify(const BakeOutputs& outputs, const std::filesystem::path& packagePath
     bool ok = compareArtifact("package.json", asBytes(outputs.packageJson), packagePath,
                               diagnostics);
     ok = compareArtifact(outputs.weightsName, outputs.weights, weightsPath, diagnostics) && ok;
+    if (!outputs.goldensName.empty()) {
+        ok = compareArtifact(outputs.goldensName, outputs.goldens,
+                             packagePath.parent_path() / outputs.goldensName, diagnostics) &&
+             ok;
+    } else if (const auto stale = packagePath.parent_path() / goldensFileName;
+               std::filesystem::exists(stale)) {
+        report(diagnostics, reportPath(stale), 0, artifactDiffers,
+               "goldens.bin is left from a sidecar bake; this package keeps its goldens inline",
+               "Run `cmake --build <dir> --target mdux-bake-update` to remove it.");
+        ok = false;
+    }
     ok = compareArtifact("report.json", asBytes(outputs.reportJson), reportPath_, diagnostics) && ok;
     return ok;
 }
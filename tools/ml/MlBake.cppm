@@ -24,6 +24,8 @@
  * - `package.json` - layers, golden vectors as `u32` bit patterns, `weightsDigest`,
  *   `maxScratchFloats`
  * - `weights.bin` - the packed f32 blob, the sidecar the package's digest covers
+ * - `goldens.bin` - only when the recipe sets `[goldens] storage = "sidecar"`: every golden's bit
+ *   patterns as little-endian `u32`, which `package.json` then addresses by byte range
  * - `report.json` - the shared `BakeReport`: semantic `toolVersion`, resolved options,
  *   repository-relative paths, and no commit SHA (ADR-007, decision 5)
  *
@@ -52,6 +54,28 @@ export namespace mdux::tools::ml {
 /// The name this tool reports itself as, in usage text and in `report.json`'s `tool` field.
 inline constexpr std::string_view bakeToolName = "mdux-mlbake";
 
+/**
+ * @brief Where a package's golden vectors live.
+ *
+ * Inline JSON is the default and what every committed package uses: a golden is a reviewable
+ * list of numbers in the diff. Its cost is size - one line per `u32`, so a model with long inputs
+ * and many goldens is megabytes of JSON that every load has to parse back into vectors.
+ *
+ * The sidecar form stores the same bit patterns as raw little-endian words in `goldens.bin`, one
+ * file beside `weights.bin`, and `package.json` records each vector as a 4-aligned byte range plus
+ * one length and SHA-256 for the whole file - the arrangement `shaders.spv` already has. A
+ * consumer on a little-endian target can point a `GoldenVector` span straight at a mapped or
+ * embedded copy. The digest is what keeps the goldens a fail-closed control rather than a file
+ * anyone could edit.
+ */
+enum class GoldenStorage : std::uint8_t {
+    Json,     ///< `storage = "json"`, the default
+    Sidecar,  ///< `storage = "sidecar"`
+};
+
+/// The recipe and report spelling of a GoldenStorage.
+[[nodiscard]] std::string_view goldenStorageWire(GoldenStorage storage) noexcept;
+
 /// A parsed `recipes/model/<id>.toml`.
 struct Recipe {
     std::string id;
@@ -61,6 +85,7 @@ struct Recipe {
     std::uint32_t maxScratchFloats{0};  ///< 0 means "derive from the layer chain"
     std::size_t goldenCount{0};
     std::uint32_t goldenSeed{0};
+    GoldenStorage goldenStorage{GoldenStorage::Json};
     std::vector<LayerSpec> layers;
 
     /// The fully resolved option set for `report.json`. Defaults are expanded here, not recorded
@@ -75,13 +100,13 @@ struct BakeOutputs {
     std::string reportJson;
     std::vector<std::byte> weights;
     std::string weightsName;  ///< always "weights.bin"; a field so callers do not restate it
+    std::vector<std::byte> goldens;  ///< the golden sidecar; empty when the goldens are inline
+    std::string goldensName;         ///< "goldens.bin", or empty when the goldens are inline
     std::string packageId;
     std::size_t layerCount{0};
     std::size_t goldenCount{0};
 };
 
-[[nodiscard]] std::optional<std::vector<std::byte>> readFile(const std::filesystem::path& path);
-
 /// Parses recipe text. Diagnostics are appended; nullopt means it did not parse.
 [[nodiscard]] std::optional<Recipe> parseRecipe(std::string_view text, std::string_view recipePath,
                                                 std::vector<cli::Diagnostic>& diagnostics);
@@ -101,12 +126,14 @@ struct BakeOutputs {
                                              const std::filesystem::path& root,
                                              std::vector<cli::Diagnostic>& diagnostics);
 
-/// Writes `outputs` into `outputDir`, creating it if needed.
+/// Writes `outputs` into `outputDir`, creating it if needed. A bake with inline goldens removes
+/// a `goldens.bin` an earlier sidecar bake left there.
 [[nodiscard]] bool write(const BakeOutputs& outputs, const std::filesystem::path& outputDir,
                          std::vector<cli::Diagnostic>& diagnostics);
 
 /// Compares `outputs` against the committed files, appending a diagnostic per mismatch. The
-/// sidecar is compared too, resolved beside `packagePath`.
+/// sidecars are compared too, resolved beside `packagePath`, and a `goldens.bin` beside a package
+/// with inline goldens is a mismatch.
 [[nodiscard]] bool verify(const BakeOutputs& outputs, const std::filesystem::path& packagePath,
                           const std::filesystem::path& reportPath,
                           std::vector<cli::Diagnostic>& diagnostics);
@@ -17,17 +17,21 @@
  */
 import std;
 import mdux.tools.cli;
+import mdux.tools.freshness;
+import mdux.tools.io;
 import mdux.tools.ml.mlbake;
 
 namespace {
 
 namespace cli = mdux::tools::cli;
+namespace freshness = mdux::tools::freshness;
+namespace io = mdux::tools::io;
 namespace bake = mdux::tools::ml;
 
 [[nodiscard]] std::optional<bake::BakeOutputs> produce(const std::string& recipePath,
                                                        std::vector<cli::Diagnostic>& diagnostics) {
-    auto recipeBytes = bake::readFile(recipePath);
-    if (!recipeBytes.has_value()) {
+    auto recipeFile = io::InputFile::open(recipePath);
+    if (!recipeFile.has_value()) {
         diagnostics.push_back(
             cli::Diagnostic{.file = recipePath,
                             .code = "mdux.ml.bake.recipeUnreadable",
@@ -38,14 +42,12 @@ namespace bake = mdux::tools::ml;
         return std::nullopt;
     }
 
-    const std::string_view text{reinterpret_cast<const char*>(recipeBytes->data()),
-                                recipeBytes->size()};
-    auto recipe = bake::parseRecipe(text, recipePath, diagnostics);
+    auto recipe = bake::parseRecipe(recipeFile->text(), recipePath, diagnostics);
     if (!recipe.has_value()) {
         return std::nullopt;
     }
 
-    return bake::run(*recipe, recipePath, *recipeBytes, std::filesystem::current_path(),
+    return bake::run(*recipe, recipePath, recipeFile->bytes(), std::filesystem::current_path(),
                      diagnostics);
 }
 
@@ -65,6 +67,12 @@ int main(int argc, char** argv) {
     const std::string& recipePath =
         invocation.mode == cli::Mode::Bake ? invocation.bake.recipe : invocation.verify.recipe;
 
+    // A verify that report.json vouches for ends here; see freshness::verifyShortcut().
+    if (const auto status =
+            freshness::verifyShortcut(bake::bakeToolName, invocation, diagnostics)) {
+        return *status;
+    }
+
     std::string summary;
     if (auto outputs = produce(recipePath, diagnostics); outputs.has_value()) {
         const bool ok = invocation.mode == cli::Mode::Bake
@@ -6,6 +6,9 @@
  */
 module;
 
+// __cpp_lib_start_lifetime_as: feature-test macros do not come through `import std`.
+#include <version>
+
 module mdux.tools.ml.packageload;
 
 import std;
@@ -27,6 +30,7 @@ namespace {
 
 constexpr std::string_view malformed = "mdux.ml.package.malformed";
 constexpr std::string_view invalid = "mdux.ml.package.invalid";
+constexpr std::string_view sidecarMismatch = "mdux.ml.package.goldenSidecarMismatch";
 
 [[nodiscard]] cli::Diagnostic problem(std::string_view fileName, std::string_view code,
                                       std::string message) {
@@ -71,14 +75,32 @@ constexpr std::string_view invalid = "mdux.ml.package.invalid";
     return *value;
 }
 
+/// readUInt() on an undecoded object: decodes the one member and nothing beside it.
+[[nodiscard]] std::optional<std::uint64_t> readUInt(const json::LazyValue& object,
+                                                    std::string_view key) {
+    const std::optional<json::LazyValue> member = object.find(key);
+    if (!member.has_value()) {
+        return std::nullopt;
+    }
+    auto value = member->materialise();
+    if (!value.has_value()) {
+        return std::nullopt;
+    }
+    auto number = value->asUInt();
+    if (!number.has_value()) {
+        return std::nullopt;
+    }
+    return *number;
+}
+
 /// Reads an unsigned member that must fit in `uint32`, or nullopt.
 ///
 /// Separate from readUInt() because a straight cast is the wrong thing for the fields that feed
 /// buffer sizes: a JSON value above 2^32 would wrap, and validate() would then be checking a
 /// different number than the file actually contained - passing on a package that describes
 /// something else entirely.
-[[nodiscard]] std::optional<std::uint32_t> readUInt32(const json::Value& object,
-                                                      std::string_view key) {
+template <typename Object>
+[[nodiscard]] std::optional<std::uint32_t> readUInt32(const Object& object, std::string_view key) {
     const std::optional<std::uint64_t> wide = readUInt(object, key);
     if (!wide.has_value() || *wide > std::numeric_limits<std::uint32_t>::max()) {
         return std::nullopt;
@@ -139,6 +161,90 @@ constexpr std::string_view invalid = "mdux.ml.package.invalid";
     return bits;
 }
 
+/// The byte range one golden vector occupies in the sidecar: 4-aligned, whole words, inside it.
+/// Nullopt for a malformed or out-of-bounds range - the sidecar's length has been checked by
+/// then, so a range past its end is a package that disagrees with itself.
+[[nodiscard]] std::optional<std::span<const std::byte>> readSidecarRange(
+    const json::Value& object, std::string_view key, std::span<const std::byte> sidecar) {
+    const json::Value* range = object.find(key);
+    if (range == nullptr || range->kind() != json::Value::Kind::Object) {
+        return std::nullopt;
+    }
+    const auto offset = readUInt(*range, "byteOffset");
+    const auto length = readUInt(*range, "byteLength");
+    if (!offset.has_value() || !length.has_value() || *offset % 4 != 0 || *length % 4 != 0 ||
+        *offset > sidecar.size() || *length > sidecar.size() - *offset) {
+        return std::nullopt;
+    }
+    return sidecar.subspan(static_cast<std::size_t>(*offset), static_cast<std::size_t>(*length));
+}
+
+/// Whether the sidecar's words can be used where they lie: the library can start uint32_t
+/// lifetimes over the bytes, the host reads little-endian words, and the blob starts 4-aligned,
+/// so every range readSidecarRange() accepts is aligned too.
+[[nodiscard]] bool wordsInPlace(std::span<const std::byte> sidecar) noexcept {
+#if defined(__cpp_lib_start_lifetime_as)
+    return std::endian::native == std::endian::little &&
+           reinterpret_cast<std::uintptr_t>(sidecar.data()) % alignof(std::uint32_t) == 0;
+#else
+    static_cast<void>(sidecar);
+    return false;
+#endif
+}
+
+/// The words of a range, as they lie. Only for a sidecar wordsInPlace() accepted. The blob holds
+/// bytes, not uint32_t objects, and reading it through a cast pointer would be undefined;
+/// start_lifetime_as_array() creates the words over the same bytes without touching them.
+[[nodiscard]] std::span<const std::uint32_t> wordsAt(std::span<const std::byte> bytes) noexcept {
+#if defined(__cpp_lib_start_lifetime_as)
+    const std::size_t count = bytes.size() / 4;
+    return {std::start_lifetime_as_array<std::uint32_t>(bytes.data(), count), count};
+#else
+    static_cast<void>(bytes);
+    return {};  // never reached: wordsInPlace() said no
+#endif
+}
+
+/// The words of a range, decoded by explicit shifts into storage of their own: the fallback for a
+/// big-endian host or a blob that is not 4-aligned.
+[[nodiscard]] std::vector<std::uint32_t> decodeWords(std::span<const std::byte> bytes) {
+    std::vector<std::uint32_t> bits(bytes.size() / 4);
+    for (std::size_t i = 0; i < bits.size(); ++i) {
+        bits[i] = std::to_integer<std::uint32_t>(bytes[i * 4]) |
+                  (std::to_integer<std::uint32_t>(bytes[i * 4 + 1]) << 8) |
+                  (std::to_integer<std::uint32_t>(bytes[i * 4 + 2]) << 16) |
+                  (std::to_integer<std::uint32_t>(bytes[i * 4 + 3]) << 24);
+    }
+    return bits;
+}
+
+/// The members PackageHeader::readFrom() reads, decoded into an object of their own. An absent
+/// member stays absent, so readFrom() reports it exactly as it would against the whole package.
+[[nodiscard]] json::Value headerMembers(const json::LazyValue& root) {
+    json::Value header = json::Value::emptyObject();
+    for (const std::string_view key : {"schemaVersion", "id", "kind"}) {
+        const std::optional<json::LazyValue> member = root.find(key);
+        if (!member.has_value()) {
+            continue;
+        }
+        if (auto value = member->materialise(); value.has_value()) {
+            (void)header.set(std::string{key}, std::move(*value));
+        }
+    }
+    return header;
+}
+
+/// Decodes the member named `key`. A Result rather than an optional because json::Value is not
+/// trivially destructible - see the GCC 15 note in tools/shader/ShaderBake.cppm.
+[[nodiscard]] mdux::core::Result<json::Value, json::Error> materialiseMember(
+    const json::LazyValue& object, std::string_view key) {
+    auto member = object.require(key);
+    if (!member.has_value()) {
+        return err(member.error());
+    }
+    return member->materialise();
+}
+
 }  // namespace
 
 ml::ModelPackage LoadedPackage::view() const noexcept {
@@ -155,18 +261,26 @@ ml::ModelPackage LoadedPackage::view() const noexcept {
 
 mdux::core::Result<std::unique_ptr<LoadedPackage>, cli::Diagnostic> loadPackage(
     std::string_view text, std::string_view fileName) {
-    auto parsed = json::parse(text);
+    return loadPackage(text, fileName, {});
+}
+
+mdux::core::Result<std::unique_ptr<LoadedPackage>, cli::Diagnostic> loadPackage(
+    std::string_view text, std::string_view fileName, std::span<const std::byte> goldenSidecar) {
+    // Validated in full here, decoded piecemeal below: the layer list and the weights record are
+    // small, and each golden is decoded only when the loop reaches it, so the package is never
+    // held as one tree of per-number Values alongside the vectors built from it.
+    auto parsed = json::parseLazy(text);
     if (!parsed.has_value()) {
         return err(problem(fileName, malformed,
                            std::format("package.json is not valid JSON: {}",
                                        json::describe(parsed.error().code))));
     }
-    const json::Value& root = *parsed;
+    const json::LazyValue& root = *parsed;
     if (root.kind() != json::Value::Kind::Object) {
         return err(problem(fileName, malformed, "package.json is not an object"));
     }
 
-    auto header = evidence::PackageHeader::readFrom(root);
+    auto header = evidence::PackageHeader::readFrom(headerMembers(root));
     if (!header.has_value()) {
         return err(problem(fileName, malformed,
                            std::format("package header is malformed: {}",
@@ -195,8 +309,8 @@ mdux::core::Result<std::unique_ptr<LoadedPackage>, cli::Diagnostic> loadPackage(
     loaded->outputLength_ = *outputLength;
     loaded->maxScratchFloats_ = *scratch;
 
-    const json::Value* weights = root.find("weights");
-    if (weights == nullptr || weights->kind() != json::Value::Kind::Object) {
+    const auto weights = materialiseMember(root, "weights");
+    if (!weights.has_value() || weights->kind() != json::Value::Kind::Object) {
         return err(problem(fileName, malformed, "package has no weights record"));
     }
     const auto weightsLength = readUInt(*weights, "byteLength");
@@ -215,8 +329,8 @@ mdux::core::Result<std::unique_ptr<LoadedPackage>, cli::Diagnostic> loadPackage(
     loaded->weightsByteLength_ = *weightsLength;
     loaded->weightsDigest_ = *digest;
 
-    const json::Value* layers = root.find("layers");
-    if (layers == nullptr || layers->kind() != json::Value::Kind::Array) {
+    const auto layers = materialiseMember(root, "layers");
+    if (!layers.has_value() || layers->kind() != json::Value::Kind::Array) {
         return err(problem(fileName, malformed, "package has no layers array"));
     }
     for (const json::Value& entry : layers->elements()) {
@@ -275,14 +389,63 @@ mdux::core::Result<std::unique_ptr<LoadedPackage>, cli::Diagnostic> loadPackage(
                           .bias = *biasRef});
     }
 
-    const json::Value* goldens = root.find("goldens");
-    if (goldens == nullptr || goldens->kind() != json::Value::Kind::Array) {
+    // A package with a goldenSidecar record stores every golden there; one without stores them
+    // inline. Never a mixture, so the record decides how every entry below is read.
+    const bool goldensInSidecar = root.find("goldenSidecar").has_value();
+    if (goldensInSidecar) {
+        const auto record = materialiseMember(root, "goldenSidecar");
+        if (!record.has_value() || record->kind() != json::Value::Kind::Object) {
+            return err(problem(fileName, malformed, "goldenSidecar record is not an object"));
+        }
+        const auto sidecarLength = readUInt(*record, "byteLength");
+        const json::Value* sidecarDigestText = record->find("sha256");
+        if (!sidecarLength.has_value() || sidecarDigestText == nullptr ||
+            !sidecarDigestText->asString().has_value()) {
+            return err(problem(fileName, malformed, "goldenSidecar record is incomplete"));
+        }
+        const auto sidecarDigest = evidence::digestFromHex(*sidecarDigestText->asString());
+        if (!sidecarDigest.has_value()) {
+            return err(problem(fileName, malformed, "goldenSidecar sha256 is not 64 hex digits"));
+        }
+        if (goldenSidecar.size() != *sidecarLength) {
+            return err(problem(fileName, sidecarMismatch,
+                               std::format("golden sidecar is {} bytes, package records {}",
+                                           goldenSidecar.size(), *sidecarLength)));
+        }
+        if (evidence::sha256(goldenSidecar) != *sidecarDigest) {
+            return err(problem(fileName, sidecarMismatch,
+                               "golden sidecar does not match the package's sha256"));
+        }
+    }
+
+    const std::optional<json::LazyValue> goldens = root.find("goldens");
+    if (!goldens.has_value() || goldens->kind() != json::Value::Kind::Array) {
         return err(problem(fileName, malformed, "package has no goldens array"));
     }
-    for (const json::Value& entry : goldens->elements()) {
-        if (entry.kind() != json::Value::Kind::Object) {
+    // Sidecar words the host can read where they lie are not copied: the views point into the
+    // caller's blob, already checked against its digest above, and nothing is decoded at all.
+    const bool inPlace = goldensInSidecar && wordsInPlace(goldenSidecar);
+    for (const json::LazyValue& lazyEntry : goldens->elements()) {
+        auto decoded = lazyEntry.materialise();
+        if (!decoded.has_value() || decoded->kind() != json::Value::Kind::Object) {
             return err(problem(fileName, malformed, "a golden is not an object"));
         }
+        const json::Value& entry = *decoded;
+        if (goldensInSidecar) {
+            const auto input = readSidecarRange(entry, "inputBits", goldenSidecar);
+            const auto output = readSidecarRange(entry, "expectedOutputBits", goldenSidecar);
+            if (!input.has_value() || !output.has_value()) {
+                return err(problem(fileName, malformed, "a golden's bit arrays are malformed"));
+            }
+            if (inPlace) {
+                loaded->goldenViews_.push_back(ml::GoldenVector{
+                    .inputBits = wordsAt(*input), .expectedOutputBits = wordsAt(*output)});
+            } else {
+                loaded->goldenInputs_.push_back(decodeWords(*input));
+                loaded->goldenOutputs_.push_back(decodeWords(*output));
+            }
+            continue;
+        }
         auto inputBits = readBits(entry, "inputBits");
         auto outputBits = readBits(entry, "expectedOutputBits");
         if (!inputBits.has_value() || !outputBits.has_value()) {
@@ -293,7 +456,8 @@ mdux::core::Result<std::unique_ptr<LoadedPackage>, cli::Diagnostic> loadPackage(
     }
 
     // Built only once the vectors are final, so no span points into storage that later grows.
-    loaded->goldenViews_.reserve(loaded->goldenInputs_.size());
+    // Empty when the views already point into the sidecar.
+    loaded->goldenViews_.reserve(loaded->goldenViews_.size() + loaded->goldenInputs_.size());
     for (std::size_t i = 0; i < loaded->goldenInputs_.size(); ++i) {
         loaded->goldenViews_.push_back(
             ml::GoldenVector{.inputBits = loaded->goldenInputs_[i],
@@ -58,7 +58,7 @@ public:
 
 private:
     friend mdux::core::Result<std::unique_ptr<LoadedPackage>, cli::Diagnostic> loadPackage(
-        std::string_view, std::string_view);
+        std::string_view, std::string_view, std::span<const std::byte>);
 
     std::string id_;
     std::uint64_t schemaVersion_{0};
@@ -82,4 +82,22 @@ private:
 [[nodiscard]] mdux::core::Result<std::unique_ptr<LoadedPackage>, cli::Diagnostic> loadPackage(
     std::string_view text, std::string_view fileName);
 
+/**
+ * @brief Parses a package whose goldens may live in a `goldens.bin` sidecar.
+ *
+ * `goldenSidecar` is that file's bytes. Its length and SHA-256 are checked against the package's
+ * `goldenSidecar` record before any range inside it is read, exactly as `weights.bin` is checked
+ * against `weights` - a sidecar that does not match is refused, never partially used. Ignored for
+ * a package with inline goldens; a package that names a sidecar and is given none is refused.
+ *
+ * The returned package borrows `goldenSidecar`: it must outlive the package, on every host. Where
+ * the words can be read where they lie - a little-endian host, a 4-aligned blob (a mapped file
+ * or a heap buffer always is), and a standard library with `std::start_lifetime_as_array` - each
+ * `GoldenVector` span points straight into it and nothing is copied. Elsewhere they are decoded
+ * into the package's own storage, but that is an implementation detail, not a licence to free
+ * the sidecar early.
+ */
+[[nodiscard]] mdux::core::Result<std::unique_ptr<LoadedPackage>, cli::Diagnostic> loadPackage(
+    std::string_view text, std::string_view fileName, std::span<const std::byte> goldenSidecar);
+
 }  // namespace mdux::tools::ml
@@ -17,6 +17,7 @@ import std;
 import mdux.core.result;
 import mdux.evidence.json;
 import mdux.tools.cli;
+import mdux.tools.io;
 
 namespace mdux::tools::ml {
 
@@ -321,13 +322,12 @@ mdux::core::Result<SafetensorsFile, cli::Diagnostic> parseSafetensors(
 
 mdux::core::Result<SafetensorsFile, cli::Diagnostic> readSafetensors(
     const std::filesystem::path& path) {
-    std::ifstream stream{path, std::ios::binary};
-    if (!stream) {
-        throw std::runtime_error{std::format("cannot open '{}'", path.string())};
+    const auto file = io::InputFile::open(path);
+    if (!file.has_value()) {
+        throw std::runtime_error{
+            std::format("cannot read '{}': {}", path.string(), io::describe(file.error()))};
     }
-    std::vector<char> contents{std::istreambuf_iterator<char>{stream},
-                               std::istreambuf_iterator<char>{}};
-    return parseSafetensors(std::as_bytes(std::span{contents}), path.filename().string());
+    return parseSafetensors(file->bytes(), path.filename().string());
 }
 
 }  // namespace mdux::tools::ml
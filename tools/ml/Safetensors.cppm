@@ -100,7 +100,7 @@ struct SafetensorsFile {
     std::span<const std::byte> bytes, std::string_view fileName);
 
 /**
- * @brief Reads `path` and parses it.
+ * @brief Reads `path` through `mdux.tools.io`, mapped where possible, and parses it.
  *
  * Host-tools zone, so this throws `std::runtime_error` if the file cannot be read - a missing file
  * is a usage mistake, not a finding about a model.
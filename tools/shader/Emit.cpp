@@ -12,6 +12,7 @@ import std;
 import mdux.evidence.digest;
 import mdux.shader.schema;
 import mdux.tools.cli;
+import mdux.tools.io;
 
 namespace mdux::tools::shaderemit {
 
@@ -33,31 +34,6 @@ void report(std::vector<cli::Diagnostic>& diagnostics, std::string file, std::st
                                           .fixHint = std::move(fixHint)});
 }
 
-[[nodiscard]] std::optional<std::vector<std::byte>> readFile(const std::filesystem::path& path) {
-    std::ifstream file{path, std::ios::binary | std::ios::ate};
-    if (!file) {
-        return std::nullopt;
-    }
-    // tellg() answers -1 on a stream error rather than throwing, and the `size > 0` guard below
-    // does not help: the vector is sized before it, so a negative size becomes a request for
-    // 2^64-1 bytes and the process dies without naming the file it was reading.
-    const std::streamoff size = file.tellg();
-    if (size < 0) {
-        return std::nullopt;
-    }
-    if (!file.seekg(0)) {
-        return std::nullopt;
-    }
-    std::vector<std::byte> bytes(static_cast<std::size_t>(size));
-    if (size > 0) {
-        file.read(reinterpret_cast<char*>(bytes.data()), size);
-        if (!file) {
-            return std::nullopt;
-        }
-    }
-    return bytes;
-}
-
 [[nodiscard]] std::string escape(std::string_view text) {
     std::string out;
     out.reserve(text.size());
@@ -240,16 +216,14 @@ std::optional<EmitOutputs> render(const std::filesystem::path& packagePath,
                                   std::vector<cli::Diagnostic>& diagnostics) {
     const std::string packageDisplay = packagePath.generic_string();
 
-    auto packageBytes = readFile(packagePath);
-    if (!packageBytes.has_value()) {
+    auto packageFile = io::InputFile::open(packagePath);
+    if (!packageFile.has_value()) {
         report(diagnostics, packageDisplay, packageUnreadable, "cannot read package.json",
                "Run `cmake --build <dir> --target mdux-bake-update` to produce it.");
         return std::nullopt;
     }
 
-    const std::string_view packageText{reinterpret_cast<const char*>(packageBytes->data()),
-                                       packageBytes->size()};
-    auto package = shader::ShaderPackage::parse(packageText);
+    auto package = shader::ShaderPackage::parse(packageFile->text());
     if (!package.has_value()) {
         report(diagnostics, packageDisplay, packageUnparsed,
                std::string{"package.json is not a valid shader package: "} +
@@ -258,7 +232,7 @@ std::optional<EmitOutputs> render(const std::filesystem::path& packagePath,
     }
 
     const std::filesystem::path sidecarPath = packagePath.parent_path() / package->sidecarPath;
-    auto sidecar = readFile(sidecarPath);
+    auto sidecar = io::InputFile::open(sidecarPath);
     if (!sidecar.has_value()) {
         report(diagnostics, sidecarPath.generic_string(), sidecarUnreadable,
                "cannot read the sidecar the package names");
@@ -269,7 +243,7 @@ std::optional<EmitOutputs> render(const std::filesystem::path& packagePath,
     // a sidecar that does not match the digest under review would put unreviewed bytes into the
     // binary while every artifact check stayed green.
     if (sidecar->size() != package->sidecarByteLength ||
-        evidence::sha256(*sidecar) != package->sidecarSha256) {
+        sidecar->sha256() != package->sidecarSha256) {
         report(diagnostics, sidecarPath.generic_string(), sidecarMismatch,
                "the sidecar does not match the digest recorded in package.json",
                "Re-bake with `cmake --build <dir> --target mdux-bake-update`; do not hand-edit "
@@ -281,7 +255,7 @@ std::optional<EmitOutputs> render(const std::filesystem::path& packagePath,
     outputs.stem = identifierFor(package->header.id);
     outputs.moduleName = "mdux.shader.generated." + outputs.stem;
 
-    const std::string body = renderBody(*package, *sidecar, outputs.stem);
+    const std::string body = renderBody(*package, sidecar->bytes(), outputs.stem);
     const std::string head = preamble(package->header.id, packageDisplay);
 
     outputs.moduleSource = head + "\nmodule;\n\nexport module " + outputs.moduleName +
@@ -313,10 +287,8 @@ bool write(const EmitOutputs& outputs, const std::filesystem::path& outputDir,
                                     const std::string& content) {
         // Rewriting an unchanged file would restamp it and force every consumer to recompile on
         // every build, which for a file holding a few thousand bytes of shader is not free.
-        if (auto existing = readFile(path); existing.has_value()) {
-            const std::string_view text{reinterpret_cast<const char*>(existing->data()),
-                                        existing->size()};
-            if (text == content) {
+        if (auto existing = io::InputFile::open(path); existing.has_value()) {
+            if (existing->text() == content) {
                 return true;
             }
         }
@@ -16,6 +16,7 @@ import mdux.evidence.json;
 import mdux.evidence.report;
 import mdux.shader.schema;
 import mdux.tools.cli;
+import mdux.tools.io;
 import mdux.tools.spirv;
 import mdux.tools.toml;
 
@@ -88,28 +89,6 @@ json::Value Recipe::toOptions() const {
     return options;
 }
 
-std::optional<std::vector<std::byte>> readFile(const std::filesystem::path& path) {
-    std::ifstream file{path, std::ios::binary};
-    if (!file) {
-        return std::nullopt;
-    }
-    std::vector<std::byte> bytes;
-    std::array<char, 8192> buffer{};
-    while (file.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) ||
-           file.gcount() > 0) {
-        const auto read = static_cast<std::size_t>(file.gcount());
-        const auto* start = reinterpret_cast<const std::byte*>(buffer.data());
-        bytes.insert(bytes.end(), start, start + read);
-        if (file.eof()) {
-            break;
-        }
-    }
-    if (file.bad()) {
-        return std::nullopt;
-    }
-    return bytes;
-}
-
 std::optional<Recipe> parseRecipe(std::string_view text, std::string_view recipePath,
                                   std::vector<cli::Diagnostic>& diagnostics) {
     toml::Document document{};
@@ -218,15 +197,16 @@ std::optional<BakeOutputs> run(const Recipe& recipe, std::string_view recipePath
 
     for (const RecipeModule& entry : recipe.modules) {
         const std::filesystem::path source = root / entry.source;
-        auto bytes = readFile(source);
-        if (!bytes.has_value()) {
+        auto file = io::InputFile::open(source);
+        if (!file.has_value()) {
             report(diagnostics, entry.source, 0, sourceUnreadable,
                    "cannot read SPIR-V for module '" + entry.id + "'",
                    "Check the path in the recipe's [modules] sources array.");
             return std::nullopt;
         }
 
-        auto reflection = spirv::reflect(*bytes);
+        const std::span<const std::byte> bytes = file->bytes();
+        auto reflection = spirv::reflect(bytes);
         if (!reflection.has_value()) {
             report(diagnostics, entry.source, 0, spirvRejected,
                    "module '" + entry.id + "' was rejected: " +
@@ -236,17 +216,19 @@ std::optional<BakeOutputs> run(const Recipe& recipe, std::string_view recipePath
         }
 
         const std::uint64_t offset = outputs.sidecar.size();
-        outputs.sidecar.insert(outputs.sidecar.end(), bytes->begin(), bytes->end());
+        outputs.sidecar.insert(outputs.sidecar.end(), bytes.begin(), bytes.end());
 
         package.modules.push_back(
             shader::ShaderModule{.id = entry.id,
                                  .stage = reflection->stage,
                                  .entryPoint = reflection->entryPoint,
                                  .byteOffset = offset,
-                                 .byteLength = static_cast<std::uint64_t>(bytes->size()),
-                                 .sha256 = evidence::sha256(*bytes)});
+                                 .byteLength = static_cast<std::uint64_t>(bytes.size()),
+                                 .sha256 = file->sha256()});
 
-        inputs.push_back(fileRecord(entry.source, *bytes));
+        // The same digest as the module's own: the input file is the module, byte for byte, and
+        // InputFile hashes it once however many records name it.
+        inputs.push_back(evidence::FileRecord{.path = entry.source, .sha256 = file->sha256()});
 
         for (const shader::DescriptorBinding& binding : reflection->descriptors) {
             const auto key = std::pair{binding.set, binding.binding};
@@ -360,7 +342,7 @@ namespace {
 [[nodiscard]] bool compareArtifact(std::string_view label, std::span<const std::byte> produced,
                                    const std::filesystem::path& committedPath,
                                    std::vector<cli::Diagnostic>& diagnostics) {
-    auto committed = readFile(committedPath);
+    auto committed = io::InputFile::open(committedPath);
     if (!committed.has_value()) {
         report(diagnostics, reportPath(committedPath), 0, artifactMissing,
                std::string{label} + " is missing or unreadable",
@@ -370,12 +352,12 @@ namespace {
 
     const std::size_t common = std::min(produced.size(), committed->size());
     for (std::size_t i = 0; i < common; ++i) {
-        if (produced[i] != (*committed)[i]) {
+        if (produced[i] != committed->bytes()[i]) {
             report(diagnostics, reportPath(committedPath), 0, artifactDiffers,
                    std::string{label} + " differs at byte " + std::to_string(i) + ": produced 0x" +
                        std::format("{:02x}", std::to_integer<unsigned>(produced[i])) +
                        ", committed 0x" +
-                       std::format("{:02x}", std::to_integer<unsigned>((*committed)[i])),
+                       std::format("{:02x}", std::to_integer<unsigned>(committed->bytes()[i])),
                    "Run `cmake --build <dir> --target mdux-bake-update` and review the diff.");
             return false;
         }
@@ -113,9 +113,6 @@ struct BakeOutputs {
     std::size_t moduleCount{0};
 };
 
-/// Reads a file as bytes. Returns nullopt when it cannot be opened or read.
-[[nodiscard]] std::optional<std::vector<std::byte>> readFile(const std::filesystem::path& path);
-
 /// Parses recipe text. Diagnostics are appended to `diagnostics`; nullopt means it did not parse.
 [[nodiscard]] std::optional<Recipe> parseRecipe(std::string_view text,
                                                 std::string_view recipePath,
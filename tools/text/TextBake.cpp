@@ -17,6 +17,7 @@ import mdux.evidence.json;
 import mdux.evidence.report;
 import mdux.text.schema;
 import mdux.tools.cli;
+import mdux.tools.io;
 import mdux.tools.toml;
 
 namespace mdux::tools::textbake {
@@ -81,28 +82,6 @@ json::Value Recipe::toOptions() const {
     return options;
 }
 
-std::optional<std::vector<std::byte>> readFile(const std::filesystem::path& path) {
-    std::ifstream file{path, std::ios::binary};
-    if (!file) {
-        return std::nullopt;
-    }
-    std::vector<std::byte> bytes;
-    std::array<char, 8192> buffer{};
-    while (file.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) ||
-           file.gcount() > 0) {
-        const auto read = static_cast<std::size_t>(file.gcount());
-        const auto* start = reinterpret_cast<const std::byte*>(buffer.data());
-        bytes.insert(bytes.end(), start, start + read);
-        if (file.eof()) {
-            break;
-        }
-    }
-    if (file.bad()) {
-        return std::nullopt;
-    }
-    return bytes;
-}
-
 std::optional<Recipe> parseRecipe(std::string_view text, std::string_view recipePath,
                                    std::vector<cli::Diagnostic>& diagnostics) {
     toml::Document document{};
@@ -267,7 +246,7 @@ namespace {
 [[nodiscard]] bool compareArtifact(std::string_view label, std::span<const std::byte> produced,
                                     const std::filesystem::path& committedPath,
                                     std::vector<cli::Diagnostic>& diagnostics) {
-    auto committed = readFile(committedPath);
+    auto committed = io::InputFile::open(committedPath);
     if (!committed.has_value()) {
         report(diagnostics, reportPath(committedPath), 0, artifactMissing,
                std::string{label} + " is missing or unreadable",
@@ -277,12 +256,12 @@ namespace {
 
     const std::size_t common = std::min(produced.size(), committed->size());
     for (std::size_t i = 0; i < common; ++i) {
-        if (produced[i] != (*committed)[i]) {
+        if (produced[i] != committed->bytes()[i]) {
             report(diagnostics, reportPath(committedPath), 0, artifactDiffers,
                    std::string{label} + " differs at byte " + std::to_string(i) + ": produced 0x" +
                        std::format("{:02x}", std::to_integer<unsigned>(produced[i])) +
                        ", committed 0x" +
-                       std::format("{:02x}", std::to_integer<unsigned>((*committed)[i])),
+                       std::format("{:02x}", std::to_integer<unsigned>(committed->bytes()[i])),
                    "Run `cmake --build <dir> --target mdux-bake-update` and review the diff.");
             return false;
         }